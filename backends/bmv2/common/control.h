@@ -437,17 +437,30 @@ class ControlConverter : public Inspector {
         auto entriesList = table->getEntries();
         if (entriesList == nullptr) return;
 
-        auto entries = mkArrayField(jsonTable, "entries");
+        // Tables can have millions of const entries, so they are not built as a JSON tree but
+        // written from the IR when the output is serialized. They are also written to a stream
+        // which discards them now, to report errors before the output is written.
+        std::ostream discard(nullptr);
+        Util::JsonWriter check(discard);
+        writeTableEntries(entriesList, table, check);
+        jsonTable->emplace("entries",
+                           new Util::JsonStream([this, entriesList, table](Util::JsonWriter &out) {
+                               writeTableEntries(entriesList, table, out);
+                           }));
+    }
+    void writeTableEntries(const IR::EntriesList *entriesList, const IR::P4Table *table,
+                           Util::JsonWriter &out) {
+        out.beginArray();
         int entryPriority = 1;  // default priority is defined by index position
         for (auto e : entriesList->entries) {
-            auto entry = new Util::JsonObject();
-            entry->emplace_non_null("source_info", e->sourceInfoJsonObj());
+            out.beginObject();
+            if (auto sourceInfo = e->sourceInfoJsonObj()) out.key("source_info").json(sourceInfo);
 
             auto keyset = e->getKeys();
-            auto matchKeys = mkArrayField(entry, "match_key");
+            out.key("match_key").beginArray();
             int keyIndex = 0;
             for (auto k : keyset->components) {
-                auto key = new Util::JsonObject();
+                out.beginObject();
                 auto tableKey = table->getKey()->keyElements.at(keyIndex);
                 auto keyWidth = tableKey->expression->type->width_bits();
                 auto k8 = ROUNDUP(keyWidth, 8);
@@ -456,31 +469,31 @@ class ControlConverter : public Inspector {
                 // represented in the BMv2 JSON file the same as a ternary
                 // field would be.
                 if (matchType == "optional") {
-                    key->emplace("match_type", "ternary");
+                    out.key("match_type").value("ternary");
                 } else {
-                    key->emplace("match_type", matchType);
+                    out.key("match_type").value(matchType);
                 }
                 if (matchType == corelib.exactMatch.name) {
                     if (k->is<IR::Constant>())
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
+                        out.key("key").value(stringRepr(k->to<IR::Constant>()->value, k8));
                     else if (k->is<IR::BoolLiteral>())
                         // booleans are converted to ints
-                        key->emplace("key",
-                                     stringRepr(k->to<IR::BoolLiteral>()->value ? 1 : 0, k8));
+                        out.key("key").value(
+                            stringRepr(k->to<IR::BoolLiteral>()->value ? 1 : 0, k8));
                     else
                         ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported exact key expression",
                                 k);
                 } else if (matchType == corelib.ternaryMatch.name) {
                     if (k->is<IR::Mask>()) {
                         auto km = k->to<IR::Mask>();
-                        key->emplace("key", stringRepr(km->left->to<IR::Constant>()->value, k8));
-                        key->emplace("mask", stringRepr(km->right->to<IR::Constant>()->value, k8));
+                        out.key("key").value(stringRepr(km->left->to<IR::Constant>()->value, k8));
+                        out.key("mask").value(stringRepr(km->right->to<IR::Constant>()->value, k8));
                     } else if (k->is<IR::Constant>()) {
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("mask", stringRepr(Util::mask(keyWidth), k8));
+                        out.key("key").value(stringRepr(k->to<IR::Constant>()->value, k8));
+                        out.key("mask").value(stringRepr(Util::mask(keyWidth), k8));
                     } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("key", stringRepr(0, k8));
-                        key->emplace("mask", stringRepr(0, k8));
+                        out.key("key").value(stringRepr(0, k8));
+                        out.key("mask").value(stringRepr(0, k8));
                     } else {
                         ::error(ErrorType::ERR_UNSUPPORTED,
                                 "%1%: unsupported ternary key expression", k);
@@ -488,7 +501,7 @@ class ControlConverter : public Inspector {
                 } else if (matchType == corelib.lpmMatch.name) {
                     if (k->is<IR::Mask>()) {
                         auto km = k->to<IR::Mask>();
-                        key->emplace("key", stringRepr(km->left->to<IR::Constant>()->value, k8));
+                        out.key("key").value(stringRepr(km->left->to<IR::Constant>()->value, k8));
                         auto trailing_zeros = [](unsigned long n, unsigned long keyWidth) {
                             return n ? __builtin_ctzl(n) : static_cast<int>(keyWidth);
                         };
@@ -501,13 +514,13 @@ class ControlConverter : public Inspector {
                         if (len + count_ones(mask) != keyWidth)  // any remaining 0s in the prefix?
                             ::error(ErrorType::ERR_INVALID, "%1%: invalid mask for LPM key", k);
                         else
-                            key->emplace("prefix_length", keyWidth - len);
+                            out.key("prefix_length").value(keyWidth - len);
                     } else if (k->is<IR::Constant>()) {
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("prefix_length", keyWidth);
+                        out.key("key").value(stringRepr(k->to<IR::Constant>()->value, k8));
+                        out.key("prefix_length").value(keyWidth);
                     } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("key", stringRepr(0, k8));
-                        key->emplace("prefix_length", 0);
+                        out.key("key").value(stringRepr(0, k8));
+                        out.key("prefix_length").value(0);
                     } else {
                         ::error(ErrorType::ERR_UNSUPPORTED, "%1%: unsupported LPM key expression",
                                 k);
@@ -515,14 +528,14 @@ class ControlConverter : public Inspector {
                 } else if (matchType == "range") {
                     if (k->is<IR::Range>()) {
                         auto kr = k->to<IR::Range>();
-                        key->emplace("start", stringRepr(kr->left->to<IR::Constant>()->value, k8));
-                        key->emplace("end", stringRepr(kr->right->to<IR::Constant>()->value, k8));
+                        out.key("start").value(stringRepr(kr->left->to<IR::Constant>()->value, k8));
+                        out.key("end").value(stringRepr(kr->right->to<IR::Constant>()->value, k8));
                     } else if (k->is<IR::Constant>()) {
-                        key->emplace("start", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("end", stringRepr(k->to<IR::Constant>()->value, k8));
+                        out.key("start").value(stringRepr(k->to<IR::Constant>()->value, k8));
+                        out.key("end").value(stringRepr(k->to<IR::Constant>()->value, k8));
                     } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("start", stringRepr(0, k8));
-                        key->emplace("end", stringRepr((1 << keyWidth) - 1, k8));  // 2^N -1
+                        out.key("start").value(stringRepr(0, k8));
+                        out.key("end").value(stringRepr((1 << keyWidth) - 1, k8));  // 2^N -1
                     } else {
                         ::error(ErrorType::ERR_UNSUPPORTED, "%1% unsupported range key expression",
                                 k);
@@ -536,11 +549,11 @@ class ControlConverter : public Inspector {
                     // allow exact values or a DefaultExpression (_ or
                     // default), no &&& expression.
                     if (k->is<IR::Constant>()) {
-                        key->emplace("key", stringRepr(k->to<IR::Constant>()->value, k8));
-                        key->emplace("mask", stringRepr(Util::mask(keyWidth), k8));
+                        out.key("key").value(stringRepr(k->to<IR::Constant>()->value, k8));
+                        out.key("mask").value(stringRepr(Util::mask(keyWidth), k8));
                     } else if (k->is<IR::DefaultExpression>()) {
-                        key->emplace("key", stringRepr(0, k8));
-                        key->emplace("mask", stringRepr(0, k8));
+                        out.key("key").value(stringRepr(0, k8));
+                        out.key("mask").value(stringRepr(0, k8));
                     } else {
                         ::error(ErrorType::ERR_UNSUPPORTED,
                                 "%1%: unsupported optional key expression", k);
@@ -549,11 +562,11 @@ class ControlConverter : public Inspector {
                     ::error(ErrorType::ERR_UNKNOWN, "unknown key match type '%2%' for key %1%", k,
                             matchType);
                 }
-                matchKeys->append(key);
+                out.endObject();
                 keyIndex++;
             }
+            out.endArray();
 
-            auto action = new Util::JsonObject();
             auto actionRef = e->getAction();
             if (!actionRef->is<IR::MethodCallExpression>())
                 ::error(ErrorType::ERR_INVALID, "Invalid action '%1%' in entries list.", actionRef);
@@ -563,12 +576,14 @@ class ControlConverter : public Inspector {
             auto actionDecl = decl->to<IR::P4Action>();
             unsigned id = get(ctxt->structure->ids, actionDecl, INVALID_ACTION_ID);
             BUG_CHECK(id != INVALID_ACTION_ID, "Could not find id for %1%", actionDecl);
-            action->emplace("action_id", id);
-            auto actionData = mkArrayField(action, "action_data");
+            out.key("action_entry").beginObject();
+            out.key("action_id").value(id);
+            out.key("action_data").beginArray(true);
             for (auto arg : *actionCall->arguments) {
-                actionData->append(stringRepr(arg->expression->to<IR::Constant>()->value, 0));
+                out.value(stringRepr(arg->expression->to<IR::Constant>()->value, 0));
             }
-            entry->emplace("action_entry", action);
+            out.endArray();
+            out.endObject();
 
             auto priorityAnnotation = e->getAnnotation("priority");
             if (priorityAnnotation != nullptr) {
@@ -579,14 +594,15 @@ class ControlConverter : public Inspector {
                 if (!priValue->is<IR::Constant>())
                     ::error(ErrorType::ERR_INVALID, "Invalid priority value %1%; must be constant.",
                             priorityAnnotation->expr);
-                entry->emplace("priority", priValue->to<IR::Constant>()->value);
+                out.key("priority").value(priValue->to<IR::Constant>()->value);
             } else {
-                entry->emplace("priority", entryPriority);
+                out.key("priority").value(entryPriority);
             }
             entryPriority += 1;
 
-            entries->append(entry);
+            out.endObject();
         }
+        out.endArray();
     }
     cstring getKeyMatchType(const IR::KeyElement *ke) {
         auto path = ke->matchType->path;
@@ -143,8 +143,12 @@ void DpdkBackend::convert(const IR::ToplevelBlock *tlb) {
         new EliminateUnusedAction(),
         new DpdkAsmOptimization,
         new CopyPropagationAndElimination(typeMap),
+        new PassIf([this] { return options.optimizeInstructions; },
+                   {new DpdkInstructionOptimization}),
         new CollectUsedMetadataField(used_fields),
         new RemoveUnusedMetadataFields(used_fields),
+        new PassIf([this] { return options.optimizeMetadataLayout; },
+                   {new OptimizeMetadataLayout}),
         new ShortenTokenLength(newNameMap),
         new EmitDpdkTableConfig(refMap, typeMap, newNameMap),
     };
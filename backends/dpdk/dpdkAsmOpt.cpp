@@ -16,7 +16,14 @@ limitations under the License.
 
 #include "dpdkAsmOpt.h"
 
+#include <algorithm>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
 #include "dpdkUtils.h"
+#include "lib/bitvec.h"
 
 namespace DPDK {
 // The assumption is compiler can only produce forward jumps.
@@ -404,6 +411,632 @@ IR::IndexedVector<IR::DpdkAsmStatement> CopyPropagationAndElimination::copyPropA
     return instrr;
 }
 
+namespace {
+
+// Locations are the fields that instructions read and write, like m.field or h.ipv4.ttl.
+// Each location gets a dense index, so sets of locations can be bit vectors.
+class InstructionLocations {
+    std::map<std::pair<int, cstring>, int> indices;
+    std::vector<unsigned> widths;
+    std::vector<cstring> metadataFields;
+    const std::map<cstring, unsigned> &metadataWidths;
+
+    int getIndex(int parent, cstring name) {
+        auto it = indices.emplace(std::make_pair(parent, name), widths.size());
+        if (it.second) {
+            unsigned width = 0;
+            cstring field = nullptr;
+            auto metadata = indices.find(std::make_pair(-1, cstring("m")));
+            if (metadata != indices.end() && parent == metadata->second) {
+                auto w = metadataWidths.find(name);
+                if (w != metadataWidths.end()) width = w->second;
+                field = name;
+            }
+            widths.push_back(width);
+            metadataFields.push_back(field);
+        }
+        return it.first->second;
+    }
+
+ public:
+    explicit InstructionLocations(const std::map<cstring, unsigned> &metadataWidths)
+        : metadataWidths(metadataWidths) {}
+
+    // Returns the index of the location expr refers to, or -1 if it is not a location.
+    int get(const IR::Expression *expr) {
+        if (auto path = expr->to<IR::PathExpression>()) return getIndex(-1, path->path->name.name);
+        if (auto member = expr->to<IR::Member>()) {
+            int parent = get(member->expr);
+            if (parent < 0) return -1;
+            return getIndex(parent, member->member.name);
+        }
+        if (auto index = expr->to<IR::ArrayIndex>()) {
+            auto cst = index->right->to<IR::Constant>();
+            int parent = get(index->left);
+            if (cst == nullptr || parent < 0) return -1;
+            return getIndex(parent, "[" + Util::toString(cst->value, 0, false) + "]");
+        }
+        return -1;
+    }
+
+    // Width of a metadata field that can hold a tracked constant, 0 for other locations.
+    unsigned getWidth(int index) const { return widths.at(index); }
+
+    // Name of the metadata field m.<name>, nullptr for other locations.
+    cstring getMetadataField(int index) const { return metadataFields.at(index); }
+
+    size_t size() const { return widths.size(); }
+};
+
+// Data flow summary of one instruction of the list.
+struct InstructionInfo {
+    std::vector<int> uses;
+    int def = -1;
+    // The instruction is not modeled, it reads and writes every location
+    bool barrier = false;
+    // Indices of the next instructions, the size of the list stands for the end of the list
+    std::vector<size_t> successors;
+};
+
+bool addUse(InstructionLocations &locations, InstructionInfo &info, const IR::Expression *expr) {
+    if (expr->is<IR::Constant>() || expr->is<IR::BoolLiteral>()) return true;
+    int index = locations.get(expr);
+    if (index < 0) return false;
+    info.uses.push_back(index);
+    return true;
+}
+
+std::vector<InstructionInfo> analyzeInstructions(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &stmts, InstructionLocations &locations) {
+    std::map<cstring, size_t> labels;
+    for (size_t i = 0; i < stmts.size(); i++) {
+        if (auto label = stmts.at(i)->to<IR::DpdkLabelStatement>()) labels[label->label] = i;
+    }
+
+    std::vector<InstructionInfo> result(stmts.size());
+    for (size_t i = 0; i < stmts.size(); i++) {
+        auto stmt = stmts.at(i);
+        auto &info = result[i];
+        bool fallsThrough = true;
+        if (auto unary = stmt->to<IR::DpdkUnaryStatement>()) {
+            info.def = locations.get(unary->dst);
+            info.barrier = info.def < 0 || !addUse(locations, info, unary->src);
+        } else if (auto cast = stmt->to<IR::DpdkCastStatement>()) {
+            info.def = locations.get(cast->dst);
+            info.barrier = info.def < 0 || !addUse(locations, info, cast->src);
+        } else if (auto binary = stmt->to<IR::DpdkBinaryStatement>()) {
+            // DPDK instructions have two operands, the destination is the first source
+            info.def = locations.get(binary->dst);
+            info.barrier = info.def < 0 || !addUse(locations, info, binary->dst) ||
+                           !addUse(locations, info, binary->src1) ||
+                           !addUse(locations, info, binary->src2);
+        } else if (auto jmp = stmt->to<IR::DpdkJmpStatement>()) {
+            if (auto cond = jmp->to<IR::DpdkJmpCondStatement>()) {
+                info.barrier = !addUse(locations, info, cond->src1) ||
+                               !addUse(locations, info, cond->src2);
+            }
+            auto label = labels.find(jmp->label);
+            info.successors.push_back(label != labels.end() ? label->second : stmts.size());
+            fallsThrough = !jmp->is<IR::DpdkJmpLabelStatement>();
+        } else if (stmt->is<IR::DpdkReturnStatement>()) {
+            fallsThrough = false;
+            info.successors.push_back(stmts.size());
+        } else if (!stmt->is<IR::DpdkLabelStatement>()) {
+            info.barrier = true;
+        }
+        if (info.barrier) info.def = -1;
+        if (fallsThrough) info.successors.push_back(i + 1);
+    }
+    return result;
+}
+
+// Constants held by metadata fields and copies between locations before an instruction.
+struct InstructionFacts {
+    bool reachable = false;
+    std::map<int, big_int> constants;
+    // copies[a] == b: a holds the value moved from b, and neither was written since
+    std::map<int, int> copies;
+
+    // Merges the facts of a predecessor, returns true if the facts changed.
+    bool meet(const InstructionFacts &other) {
+        if (!other.reachable) return false;
+        if (!reachable) {
+            *this = other;
+            return true;
+        }
+        bool changed = false;
+        for (auto it = constants.begin(); it != constants.end();) {
+            auto o = other.constants.find(it->first);
+            if (o == other.constants.end() || o->second != it->second) {
+                it = constants.erase(it);
+                changed = true;
+            } else {
+                ++it;
+            }
+        }
+        for (auto it = copies.begin(); it != copies.end();) {
+            auto o = other.copies.find(it->first);
+            if (o == other.copies.end() || o->second != it->second) {
+                it = copies.erase(it);
+                changed = true;
+            } else {
+                ++it;
+            }
+        }
+        return changed;
+    }
+
+    void kill(int location) {
+        constants.erase(location);
+        copies.erase(location);
+        for (auto it = copies.begin(); it != copies.end();) {
+            if (it->second == location)
+                it = copies.erase(it);
+            else
+                ++it;
+        }
+    }
+};
+
+// Returns the value of expr if it is a constant or a metadata field holding a known constant.
+std::optional<big_int> getValue(const IR::Expression *expr, InstructionLocations &locations,
+                                const InstructionFacts &facts) {
+    if (auto cst = expr->to<IR::Constant>()) return cst->value;
+    int index = locations.get(expr);
+    if (index < 0) return std::nullopt;
+    auto it = facts.constants.find(index);
+    if (it == facts.constants.end()) return std::nullopt;
+    return it->second;
+}
+
+InstructionFacts transfer(const IR::DpdkAsmStatement *stmt, const InstructionInfo &info,
+                          InstructionLocations &locations, const InstructionFacts &in) {
+    InstructionFacts out = in;
+    if (info.barrier) {
+        out.constants.clear();
+        out.copies.clear();
+        return out;
+    }
+    if (info.def < 0) return out;
+
+    auto mov = stmt->to<IR::DpdkMovStatement>();
+    int src = mov ? locations.get(mov->src) : -1;
+    if (mov && src == info.def) return out;
+    std::optional<big_int> value;
+    if (mov) value = getValue(mov->src, locations, in);
+    out.kill(info.def);
+    if (!mov) return out;
+    // mov truncates the value to the width of the destination
+    unsigned width = locations.getWidth(info.def);
+    if (value && width > 0 && *value >= 0) out.constants[info.def] = *value & Util::mask(width);
+    if (src >= 0) out.copies[info.def] = src;
+    return out;
+}
+
+bool isConditionTrue(const IR::DpdkJmpCondStatement *jmp, const big_int &src1,
+                     const big_int &src2) {
+    if (jmp->is<IR::DpdkJmpEqualStatement>()) return src1 == src2;
+    if (jmp->is<IR::DpdkJmpNotEqualStatement>()) return src1 != src2;
+    if (jmp->is<IR::DpdkJmpGreaterStatement>()) return src1 > src2;
+    if (jmp->is<IR::DpdkJmpGreaterEqualStatement>()) return src1 >= src2;
+    if (jmp->is<IR::DpdkJmpLessStatement>()) return src1 < src2;
+    if (jmp->is<IR::DpdkJmpLessOrEqualStatement>()) return src1 <= src2;
+    BUG("Unexpected conditional jump %1%", jmp);
+}
+
+}  // namespace
+
+const IR::Node *OptimizeInstructions::preorder(IR::DpdkAsmProgram *p) {
+    metadataWidths.clear();
+    for (auto st : p->structType) {
+        if (!isMetadataStruct(st)) continue;
+        for (auto field : st->fields) {
+            unsigned width = 0;
+            if (auto bits = field->type->to<IR::Type_Bits>())
+                width = bits->width_bits();
+            else if (field->type->is<IR::Type_Boolean>())
+                width = 8;  // DPDK implements bool as bit<8>
+            // Immediate operands of DPDK instructions have at most 64 bits
+            if (width > 0 && width <= 64) metadataWidths[field->name.name] = width;
+        }
+    }
+    return p;
+}
+
+IR::IndexedVector<IR::DpdkAsmStatement> OptimizeInstructions::propagateConstants(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) {
+    if (stmts.empty()) return stmts;
+    InstructionLocations locations(metadataWidths);
+    auto infos = analyzeInstructions(stmts, locations);
+
+    // Forward data flow, the list is visited in order until the facts do not change.
+    std::vector<InstructionFacts> facts(stmts.size() + 1);
+    facts[0].reachable = true;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < stmts.size(); i++) {
+            if (!facts[i].reachable) continue;
+            auto out = transfer(stmts.at(i), infos[i], locations, facts[i]);
+            for (auto succ : infos[i].successors) changed |= facts[succ].meet(out);
+        }
+    }
+
+    IR::IndexedVector<IR::DpdkAsmStatement> result;
+    for (size_t i = 0; i < stmts.size(); i++) {
+        auto stmt = stmts.at(i);
+        const auto &in = facts[i];
+        if (!in.reachable) {
+            if (!stmt->is<IR::DpdkLabelStatement>()) statistics.unreachableInstructions++;
+            continue;
+        }
+        if (auto jmp = stmt->to<IR::DpdkJmpCondStatement>()) {
+            auto src1 = getValue(jmp->src1, locations, in);
+            auto src2 = getValue(jmp->src2, locations, in);
+            if (src1 && src2) {
+                statistics.foldedJumps++;
+                if (isConditionTrue(jmp, *src1, *src2))
+                    result.push_back(new IR::DpdkJmpLabelStatement(jmp->label));
+                continue;
+            }
+            if (src2 && !jmp->src2->is<IR::Constant>()) {
+                statistics.propagatedConstants++;
+                auto newJmp = jmp->clone();
+                newJmp->src2 = new IR::Constant(*src2);
+                result.push_back(newJmp);
+                continue;
+            }
+        } else if (auto mov = stmt->to<IR::DpdkMovStatement>()) {
+            int dst = infos[i].def;
+            int src = locations.get(mov->src);
+            if (dst >= 0) {
+                auto value = getValue(mov->src, locations, in);
+                auto held = in.constants.find(dst);
+                auto copy = in.copies.find(dst);
+                if (src == dst || (src >= 0 && copy != in.copies.end() && copy->second == src) ||
+                    (value && held != in.constants.end() && held->second == *value)) {
+                    statistics.redundantMovs++;
+                    continue;
+                }
+                if (value && src >= 0) {
+                    statistics.propagatedConstants++;
+                    result.push_back(new IR::DpdkMovStatement(mov->dst, new IR::Constant(*value)));
+                    continue;
+                }
+            }
+        }
+        result.push_back(stmt);
+    }
+    return result;
+}
+
+IR::IndexedVector<IR::DpdkAsmStatement> OptimizeInstructions::eliminateDeadInstructions(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &stmts) {
+    if (stmts.empty()) return stmts;
+    InstructionLocations locations(metadataWidths);
+    auto infos = analyzeInstructions(stmts, locations);
+    bitvec all;
+    all.setrange(0, locations.size());
+
+    // Backward data flow, every location is live at the end of the list.
+    std::vector<bitvec> liveIn(stmts.size() + 1);
+    std::vector<bitvec> liveOut(stmts.size());
+    liveIn[stmts.size()] = all;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = stmts.size(); i-- > 0;) {
+            bitvec out;
+            for (auto succ : infos[i].successors) out |= liveIn[succ];
+            bitvec in = all;
+            if (!infos[i].barrier) {
+                in = out;
+                if (infos[i].def >= 0) in.clrbit(infos[i].def);
+                for (auto use : infos[i].uses) in.setbit(use);
+            }
+            liveOut[i] = out;
+            if (in != liveIn[i]) {
+                liveIn[i] = in;
+                changed = true;
+            }
+        }
+    }
+
+    IR::IndexedVector<IR::DpdkAsmStatement> result;
+    for (size_t i = 0; i < stmts.size(); i++) {
+        auto stmt = stmts.at(i);
+        if (infos[i].def >= 0 && !liveOut[i].getbit(infos[i].def)) {
+            statistics.deadInstructions++;
+            continue;
+        }
+        result.push_back(stmt);
+    }
+    return result;
+}
+
+namespace {
+
+// Collects the metadata fields that nodes refer to, and the instructions which constrain the
+// layout of the metadata struct.
+class CollectMetadataReferences : public Inspector {
+ public:
+    std::set<cstring> fields;
+    bool learns = false;
+    bool hashes = false;
+    bool escapes = false;
+
+    bool preorder(const IR::Member *m) override {
+        if (m->expr->toString() == "m") fields.insert(m->member.name);
+        return true;
+    }
+    bool preorder(const IR::DpdkLearnStatement *) override {
+        learns = true;
+        return true;
+    }
+    bool preorder(const IR::DpdkGetHashStatement *) override {
+        hashes = true;
+        return true;
+    }
+    bool preorder(const IR::DpdkMirrorStatement *) override {
+        escapes = true;
+        return true;
+    }
+    bool preorder(const IR::DpdkRecirculateStatement *) override {
+        escapes = true;
+        return true;
+    }
+};
+
+// A metadata field which only the instructions of one list read and write.
+struct MetadataTemporary {
+    size_t list;
+    bool inAction;
+    unsigned width;
+    bool liveAtEntry = false;
+    bool liveAcrossBarrier = false;
+    std::set<cstring> interferences;
+};
+
+bool interfere(const MetadataTemporary &temp, cstring otherField,
+               const MetadataTemporary &other) {
+    if (temp.list == other.list) return temp.interferences.count(otherField) != 0;
+    // Actions execute during the table lookups of the apply block, one at a time
+    if (temp.inAction && other.inAction) return false;
+    if (temp.inAction) return other.liveAcrossBarrier;
+    if (other.inAction) return temp.liveAcrossBarrier;
+    return true;
+}
+
+// Computes the liveness of the temporaries of one list. Temporaries are dead at the end of
+// the list, and the instructions which are not modeled do not refer to them.
+void computeInterferences(const IR::IndexedVector<IR::DpdkAsmStatement> &stmts,
+                          std::map<cstring, MetadataTemporary> &temporaries) {
+    std::map<cstring, unsigned> noWidths;
+    InstructionLocations locations(noWidths);
+    auto infos = analyzeInstructions(stmts, locations);
+    auto temporary = [&](int index) -> MetadataTemporary * {
+        if (index < 0) return nullptr;
+        auto field = locations.getMetadataField(index);
+        if (field == nullptr) return nullptr;
+        auto it = temporaries.find(field);
+        return it != temporaries.end() ? &it->second : nullptr;
+    };
+    bitvec temps;
+    for (size_t index = 0; index < locations.size(); index++)
+        if (temporary(index)) temps.setbit(index);
+
+    std::vector<bitvec> liveIn(stmts.size() + 1);
+    std::vector<bitvec> liveOut(stmts.size());
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = stmts.size(); i-- > 0;) {
+            bitvec out;
+            for (auto succ : infos[i].successors) out |= liveIn[succ];
+            bitvec in = out;
+            if (!infos[i].barrier) {
+                if (infos[i].def >= 0) in.clrbit(infos[i].def);
+                for (auto use : infos[i].uses) in.setbit(use);
+                in &= temps;
+            }
+            liveOut[i] = out;
+            if (in != liveIn[i]) {
+                liveIn[i] = in;
+                changed = true;
+            }
+        }
+    }
+
+    if (!stmts.empty())
+        for (auto index : liveIn[0]) temporary(index)->liveAtEntry = true;
+    for (size_t i = 0; i < stmts.size(); i++) {
+        if (infos[i].barrier) {
+            for (auto index : liveOut[i]) temporary(index)->liveAcrossBarrier = true;
+            continue;
+        }
+        auto def = temporary(infos[i].def);
+        if (def == nullptr) continue;
+        // After mov d s both hold the same value, so they can share a field
+        int src = -1;
+        if (auto mov = stmts.at(i)->to<IR::DpdkMovStatement>()) src = locations.get(mov->src);
+        cstring defField = locations.getMetadataField(infos[i].def);
+        for (auto index : liveOut[i]) {
+            if (int(index) == infos[i].def || int(index) == src) continue;
+            cstring field = locations.getMetadataField(index);
+            def->interferences.insert(field);
+            temporary(index)->interferences.insert(defField);
+        }
+    }
+}
+
+unsigned getFieldBytes(const IR::Type *type) {
+    if (auto bits = type->to<IR::Type_Bits>()) return (bits->width_bits() + 7) / 8;
+    // DPDK implements bool and error types as bit<8>
+    return 1;
+}
+
+}  // namespace
+
+const IR::Node *OptimizeMetadataLayout::preorder(IR::DpdkAsmProgram *p) {
+    sharedFields.clear();
+    bytesBefore = bytesAfter = 0;
+    const IR::DpdkStructType *metadata = nullptr;
+    for (auto st : p->structType)
+        if (isMetadataStruct(st)) metadata = st;
+    if (metadata == nullptr) return p;
+    for (auto field : metadata->fields) bytesBefore += getFieldBytes(field->type);
+    bytesAfter = bytesBefore;
+
+    // The instruction lists are the apply block, followed by the actions
+    std::vector<const IR::IndexedVector<IR::DpdkAsmStatement> *> lists;
+    CollectMetadataReferences pinned;
+    for (auto stmt : p->statements) {
+        if (auto list = stmt->to<IR::DpdkListStatement>())
+            lists.push_back(&list->statements);
+        else
+            stmt->apply(pinned);
+    }
+    size_t applyLists = lists.size();
+    for (auto action : p->actions) lists.push_back(&action->statements);
+    for (auto table : p->tables) table->apply(pinned);
+    for (auto selector : p->selectors) selector->apply(pinned);
+    for (auto learner : p->learners) learner->apply(pinned);
+    for (auto decl : p->externDeclarations) decl->apply(pinned);
+    for (auto global : p->globals) global->apply(pinned);
+
+    // Fields referenced by the modeled instructions of each list, and by the apply block
+    std::vector<std::set<cstring>> listFields(lists.size());
+    CollectMetadataReferences hot;
+    for (size_t i = 0; i < lists.size(); i++) {
+        std::map<cstring, unsigned> noWidths;
+        InstructionLocations locations(noWidths);
+        auto infos = analyzeInstructions(*lists[i], locations);
+        CollectMetadataReferences modeled;
+        for (size_t j = 0; j < lists[i]->size(); j++) {
+            auto stmt = lists[i]->at(j);
+            auto &references = infos[j].barrier ? pinned : modeled;
+            stmt->apply(references);
+            if (i < applyLists) stmt->apply(hot);
+        }
+        listFields[i] = modeled.fields;
+    }
+    if (pinned.learns) {
+        LOG1("Metadata layout is not optimized, learn reads consecutive metadata fields");
+        return p;
+    }
+
+    std::map<cstring, MetadataTemporary> temporaries;
+    if (!pinned.escapes) {
+        std::map<cstring, size_t> fieldLists;
+        std::set<cstring> inSeveralLists;
+        for (size_t i = 0; i < lists.size(); i++) {
+            for (auto field : listFields[i]) {
+                auto it = fieldLists.emplace(field, i);
+                if (!it.second) inSeveralLists.insert(field);
+            }
+        }
+        for (auto field : metadata->fields) {
+            auto name = field->name.name;
+            auto bits = field->type->to<IR::Type_Bits>();
+            auto list = fieldLists.find(name);
+            if (bits == nullptr || list == fieldLists.end() || inSeveralLists.count(name) ||
+                pinned.fields.count(name))
+                continue;
+            temporaries.emplace(
+                name, MetadataTemporary{list->second, list->second >= applyLists,
+                                        unsigned(bits->width_bits())});
+        }
+        for (size_t i = 0; i < lists.size(); i++) computeInterferences(*lists[i], temporaries);
+    }
+
+    // Greedy coloring in the order of the metadata struct
+    std::vector<std::vector<cstring>> slots;
+    for (auto field : metadata->fields) {
+        auto name = field->name.name;
+        auto temp = temporaries.find(name);
+        if (temp == temporaries.end() || temp->second.liveAtEntry) continue;
+        bool shared = false;
+        for (auto &slot : slots) {
+            auto &first = temporaries.at(slot.front());
+            if (first.width != temp->second.width) continue;
+            bool conflict = false;
+            for (auto other : slot)
+                conflict |= interfere(temp->second, other, temporaries.at(other));
+            if (conflict) continue;
+            slot.push_back(name);
+            sharedFields.emplace(name, slot.front());
+            bytesAfter -= getFieldBytes(field->type);
+            shared = true;
+            break;
+        }
+        if (!shared) slots.push_back({name});
+    }
+
+    IR::IndexedVector<IR::StructField> fields;
+    for (auto field : metadata->fields)
+        if (!sharedFields.count(field->name.name)) fields.push_back(field);
+    if (!pinned.hashes) {
+        // CopyMatchKeysToSingleStruct makes a table exact match when its metadata key fields
+        // are contiguous, so the fields from the first to the last key field of a table move
+        // as one group and keep their order.
+        std::map<cstring, size_t> position;
+        for (size_t i = 0; i < fields.size(); i++) position.emplace(fields.at(i)->name.name, i);
+        std::vector<size_t> groupEnd(fields.size());
+        for (size_t i = 0; i < fields.size(); i++) groupEnd[i] = i;
+        for (auto table : p->tables) {
+            if (table->match_keys == nullptr) continue;
+            std::vector<size_t> keys;
+            for (auto key : table->match_keys->keyElements) {
+                auto member = key->expression->to<IR::Member>();
+                if (member == nullptr || member->expr->toString() != "m") continue;
+                auto it = position.find(member->member.name);
+                if (it != position.end()) keys.push_back(it->second);
+            }
+            if (keys.size() < 2) continue;
+            auto [first, last] = std::minmax_element(keys.begin(), keys.end());
+            groupEnd[*first] = std::max(groupEnd[*first], *last);
+        }
+        struct FieldGroup {
+            std::vector<const IR::StructField *> fields;
+            bool hot = false;
+            unsigned bytes = 0;
+        };
+        std::vector<FieldGroup> groups;
+        for (size_t i = 0; i < fields.size();) {
+            FieldGroup group;
+            size_t end = groupEnd[i];
+            for (; i <= end; i++) {
+                auto field = fields.at(i);
+                end = std::max(end, groupEnd[i]);
+                group.fields.push_back(field);
+                group.hot |= hot.fields.count(field->name.name) != 0;
+                group.bytes = std::max(group.bytes, getFieldBytes(field->type));
+            }
+            groups.push_back(group);
+        }
+
+        // Fields of the apply block first, larger fields first
+        std::stable_sort(groups.begin(), groups.end(),
+                         [](const FieldGroup &a, const FieldGroup &b) {
+                             if (a.hot != b.hot) return a.hot;
+                             return a.bytes > b.bytes;
+                         });
+        fields.clear();
+        for (auto &group : groups)
+            for (auto field : group.fields) fields.push_back(field);
+    }
+    IR::IndexedVector<IR::DpdkStructType> structs;
+    for (auto st : p->structType) {
+        if (st == metadata)
+            structs.push_back(
+                new IR::DpdkStructType(st->srcInfo, st->name, st->annotations, fields));
+        else
+            structs.push_back(st);
+    }
+    p->structType = structs;
+    return p;
+}
+
 cstring EmitDpdkTableConfig::getKeyMatchType(const IR::KeyElement *ke, P4::ReferenceMap *refMap) {
     auto path = ke->matchType->path;
     auto mt = refMap->getDeclaration(path, true)->to<IR::Declaration_ID>();
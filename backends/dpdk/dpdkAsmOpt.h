@@ -18,6 +18,7 @@ limitations under the License.
 #define BACKENDS_DPDK_DPDKASMOPT_H_
 
 #include <fstream>
+#include <map>
 
 #include "dpdkUtils.h"
 #include "frontends/common/constantFolding.h"
@@ -32,6 +33,7 @@ limitations under the License.
 #include "ir/ir.h"
 #include "lib/big_int_util.h"
 #include "lib/json.h"
+#include "lib/log.h"
 
 #define DPDK_TABLE_MAX_KEY_SIZE 64 * 8
 
@@ -166,6 +168,48 @@ class RemoveUnusedMetadataFields : public Transform {
     bool isByteSizeField(const IR::Type *field_type);
 };
 
+// This pass reduces the size of the metadata struct, which DPDK allocates for every packet.
+// A metadata field is a temporary if it is only read and written by mov, arithmetic, logical
+// and conditional jump instructions of a single instruction list, and is not live when the
+// list starts. Temporaries of the same type that are never live at the same time share one
+// field, like registers in a register allocator. Temporaries of different actions never
+// interfere, a temporary of the apply block interferes with the temporaries of the actions if
+// it is live across a table lookup.
+// The remaining fields are ordered so that the fields read or written by the apply block come
+// first, and by decreasing size within each group, which keeps fields naturally aligned.
+// The fields from the first to the last metadata key field of a table move together and keep
+// their order, so a table whose key fields were contiguous remains an exact match table.
+// Programs which learn are not changed, because the arguments of learn are consecutive
+// metadata fields; programs which hash keep their field order for the same reason, and
+// programs which mirror or recirculate packets do not share fields, because the metadata
+// of a packet outlives the instruction lists.
+class OptimizeMetadataLayout : public Transform {
+    // Fields replaced by the field they share
+    std::map<cstring, cstring> sharedFields;
+    unsigned bytesBefore = 0;
+    unsigned bytesAfter = 0;
+
+ public:
+    const IR::Node *preorder(IR::DpdkAsmProgram *p) override;
+    const IR::Node *postorder(IR::DpdkAsmProgram *p) override {
+        LOG1("Metadata: " << bytesBefore << " bytes before, " << bytesAfter
+                          << " bytes after layout optimization, " << sharedFields.size()
+                          << " fields shared");
+        return p;
+    }
+    const IR::Node *postorder(IR::Member *m) override {
+        if (m->expr->toString() != "m") return m;
+        auto it = sharedFields.find(m->member.name);
+        if (it != sharedFields.end()) m->member = IR::ID(m->member.srcInfo, it->second);
+        return m;
+    }
+    const IR::Node *postorder(IR::DpdkMovStatement *s) override {
+        // Moves between fields which now share a field
+        if (!sharedFields.empty() && s->dst->equiv(*s->src)) return nullptr;
+        return s;
+    }
+};
+
 // This pass shorten the Identifier length
 class ShortenTokenLength : public Transform {
     ordered_map<cstring, cstring> &newNameMap;
@@ -599,6 +643,77 @@ class CopyPropagationAndElimination : public Transform {
     }
 };
 
+// This pass optimizes the instruction list of each action and of the apply block, using a
+// control flow graph of the list. Operands are mapped to dense location indices and the data
+// flow facts are computed over the graph, so jumps and fall-through edges are both followed:
+// - constants moved into metadata fields are propagated forward, and meet at jump targets;
+// - conditional jumps whose operands are known constants become jmp, or are removed;
+// - mov instructions that copy a value the destination already holds are removed, and
+//   metadata fields that hold a known constant are replaced by the constant in mov sources
+//   and in the second operand of conditional jumps;
+// - instructions that can not be reached from the first instruction are removed;
+// - assignments to a location that is not live are removed.
+// Instructions the pass does not model (table lookups, externs, header operations, ...) are
+// assumed to read and write every location, and every location is live at the end of a list.
+class OptimizeInstructions : public Transform {
+ public:
+    struct Statistics {
+        unsigned foldedJumps = 0;
+        unsigned redundantMovs = 0;
+        unsigned propagatedConstants = 0;
+        unsigned unreachableInstructions = 0;
+        unsigned deadInstructions = 0;
+    };
+
+ private:
+    Statistics &statistics;
+    // Width of the metadata fields which can hold a tracked constant
+    std::map<cstring, unsigned> metadataWidths;
+
+    IR::IndexedVector<IR::DpdkAsmStatement> propagateConstants(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &stmts);
+    IR::IndexedVector<IR::DpdkAsmStatement> eliminateDeadInstructions(
+        const IR::IndexedVector<IR::DpdkAsmStatement> &stmts);
+
+ public:
+    explicit OptimizeInstructions(Statistics &statistics) : statistics(statistics) {}
+
+    const IR::Node *preorder(IR::DpdkAsmProgram *p) override;
+
+    const IR::Node *postorder(IR::DpdkListStatement *l) override {
+        l->statements = eliminateDeadInstructions(propagateConstants(l->statements));
+        return l;
+    }
+
+    const IR::Node *postorder(IR::DpdkAction *a) override {
+        a->statements = eliminateDeadInstructions(propagateConstants(a->statements));
+        return a;
+    }
+};
+
+// This pass counts the instructions of all actions and of the apply block. Labels are not
+// instructions.
+class CountInstructions : public Inspector {
+    unsigned &count;
+
+ public:
+    explicit CountInstructions(unsigned &count) : count(count) {}
+    bool preorder(const IR::DpdkAsmProgram *) override {
+        count = 0;
+        return true;
+    }
+    bool preorder(const IR::DpdkListStatement *l) override {
+        for (auto stmt : l->statements)
+            if (!stmt->is<IR::DpdkLabelStatement>()) count++;
+        return false;
+    }
+    bool preorder(const IR::DpdkAction *a) override {
+        for (auto stmt : a->statements)
+            if (!stmt->is<IR::DpdkLabelStatement>()) count++;
+        return false;
+    }
+};
+
 // This Pass emits Table config consumed by dpdk target in a text file if
 // const entries are present in p4 program.
 // Most of the code taken from control-plane/p4RuntimeSerializer.h/.cpp
@@ -650,5 +765,31 @@ class DpdkAsmOptimization : public PassRepeated {
     }
 };
 
+// Optimizes the instructions with OptimizeInstructions until nothing changes, cleaning up
+// labels and jumps in between, and logs the instruction counts before and after.
+class DpdkInstructionOptimization : public PassManager {
+    OptimizeInstructions::Statistics statistics;
+    unsigned instructionsBefore = 0;
+    unsigned instructionsAfter = 0;
+
+ public:
+    DpdkInstructionOptimization() {
+        passes.push_back(new CountInstructions(instructionsBefore));
+        passes.push_back(
+            new PassRepeated{new OptimizeInstructions(statistics), new DpdkAsmOptimization});
+        passes.push_back(new CountInstructions(instructionsAfter));
+        passes.push_back(new VisitFunctor([this] {
+            LOG1("Instructions: " << instructionsBefore << " before, " << instructionsAfter
+                                  << " after optimization");
+            LOG1("  folded jumps: " << statistics.foldedJumps
+                                    << ", redundant movs: " << statistics.redundantMovs
+                                    << ", propagated constants: " << statistics.propagatedConstants
+                                    << ", unreachable: " << statistics.unreachableInstructions
+                                    << ", dead: " << statistics.deadInstructions);
+        }));
+        setName("DpdkInstructionOptimization");
+    }
+};
+
 }  // namespace DPDK
 #endif /* BACKENDS_DPDK_DPDKASMOPT_H_ */
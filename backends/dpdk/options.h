@@ -34,6 +34,10 @@ class DpdkOptions : public CompilerOptions {
     bool loadIRFromJson = false;
     // Enable/Disable Egress pipeline in psa
     bool enableEgress = false;
+    // Enable the data flow optimization of the instructions
+    bool optimizeInstructions = false;
+    // Enable sharing and reordering of metadata fields
+    bool optimizeMetadataLayout = false;
 
     DpdkOptions() {
         registerOption(
@@ -52,6 +56,23 @@ class DpdkOptions : public CompilerOptions {
                 return true;
             },
             "[Dpdk back-end] Enable egress pipeline's codegen\n", OptionFlags::Hide);
+        registerOption(
+            "--optimize-instructions", nullptr,
+            [this](const char *) {
+                optimizeInstructions = true;
+                return true;
+            },
+            "[Dpdk back-end] Optimize the instructions of actions and of the apply block "
+            "(constant propagation, jump folding, dead instruction elimination)\n");
+        registerOption(
+            "--optimize-metadata-layout", nullptr,
+            [this](const char *) {
+                optimizeMetadataLayout = true;
+                return true;
+            },
+            "[Dpdk back-end] Reduce the size of the metadata struct by sharing fields between "
+            "temporaries that are not live at the same time, and order its fields by use and "
+            "size\n");
 
         registerOption(
             "--bf-rt-schema", "file",
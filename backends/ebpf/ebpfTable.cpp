@@ -283,6 +283,11 @@ void EBPFTable::emitValueType(CodeBuilder *builder) {
         builder->newline();
         builder->emitIndent();
         builder->appendLine("__u8 has_next;");
+        // The highest priority of the entries in the tuple, or 0 if unknown. Tuples are chained
+        // in descending order of this value, which lets the lookup stop early. It comes last,
+        // so that control planes which do not set it keep the layout of the other fields.
+        builder->emitIndent();
+        builder->appendLine("__u32 max_priority;");
         builder->blockEnd(false);
         builder->endOfStatement(true);
     }
@@ -767,6 +772,19 @@ void EBPFTable::emitLookup(CodeBuilder *builder, cstring key, cstring value) {
     builder->emitIndent();
     builder->appendLine("break;");
     builder->blockEnd(true);
+    // Tuples are sorted by their highest priority, so if the best match so far has at least
+    // this priority, none of the remaining tuples can provide a better match. A control plane
+    // that does not maintain max_priority leaves it 0, which disables the check.
+    builder->emitIndent();
+    builder->appendFormat(
+        "if (%s != NULL && v->max_priority != 0 && v->max_priority <= %s->priority) ", value,
+        value);
+    builder->blockStart();
+    builder->target->emitTraceMessage(builder,
+                                      "Control: [Ternary] No better match in remaining tuples");
+    builder->emitIndent();
+    builder->appendLine("break;");
+    builder->blockEnd(true);
     builder->emitIndent();
     cstring new_key = "k";
     builder->appendFormat("struct %s %s = {};", keyTypeName, new_key);
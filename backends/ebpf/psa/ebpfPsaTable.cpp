@@ -716,7 +716,8 @@ void EBPFTablePSA::emitTernaryConstEntriesInitializer(CodeBuilder *builder) {
     cstring valueMask = program->refMap->newName("value_mask");
     cstring nextMask = keyMasksNames[0];
     int noTupleId = -1;
-    emitValueMask(builder, valueMask, nextMask, noTupleId);
+    emitValueMask(builder, valueMask, nextMask, noTupleId,
+                  entriesGroupedByMask.front().front().priority);
     builder->newline();
 
     builder->emitIndent();
@@ -740,7 +741,7 @@ void EBPFTablePSA::emitTernaryConstEntriesInitializer(CodeBuilder *builder) {
         } else {
             nextMask = nullptr;
         }
-        emitValueMask(builder, valueMask, nextMask, tuple_id);
+        emitValueMask(builder, valueMask, nextMask, tuple_id, sameMaskEntries.front().priority);
         builder->newline();
         emitKeysAndValues(builder, sameMaskEntries, keyNames, valueNames);
 
@@ -840,7 +841,8 @@ void EBPFTablePSA::emitKeyMasks(CodeBuilder *builder, EntriesGroupedByMask_t &en
 }
 
 void EBPFTablePSA::emitValueMask(CodeBuilder *builder, const cstring valueMask,
-                                 const cstring nextMask, int tupleId) const {
+                                 const cstring nextMask, int tupleId,
+                                 unsigned maxPriority) const {
     builder->emitIndent();
     builder->appendFormat("struct %s_mask %s = {0}", valueTypeName, valueMask);
     builder->endOfStatement(true);
@@ -859,12 +861,17 @@ void EBPFTablePSA::emitValueMask(CodeBuilder *builder, const cstring valueMask,
         builder->appendFormat("%s.has_next = 1", valueMask);
         builder->endOfStatement(true);
     }
+    builder->emitIndent();
+    builder->appendFormat("%s.max_priority = %u", valueMask, maxPriority);
+    builder->endOfStatement(true);
 }
 
 /**
  * This method groups entries with the same prefix into separate lists.
  * For example four entries which have two different masks
  * will give as a result a list of two list (each with two entries).
+ * Entries in a list are sorted by priority and lists are sorted by
+ * the priority of their first entry, both in descending order.
  * @return a vector of vectors with const entries that have the same prefix
  */
 EBPFTablePSA::EntriesGroupedByMask_t EBPFTablePSA::getConstEntriesGroupedByMask() {
@@ -873,10 +880,10 @@ EBPFTablePSA::EntriesGroupedByMask_t EBPFTablePSA::getConstEntriesGroupedByMask(
 
     if (!entries) return result;
 
-    // Group entries by the same mask, container will do deduplication for us. The order of
-    // entries will be changed but this is not a problem because of priority. Ebpf algorithm use
-    // TSS, so every mask have to be tested and there is no strict requirements on masks order.
-    // Priority of entries is equal to P4 program order (first defined has the highest priority).
+    // Group entries by the same mask, container will do deduplication for us. Priority of
+    // entries is equal to P4 program order (first defined has the highest priority). Ebpf
+    // algorithm use TSS and stops when no remaining tuple has an entry with a higher priority
+    // than the best match, so masks have to be ordered by their highest priority.
     EBPFTablePSATernaryTableMaskGenerator maskGenerator(program->refMap, program->typeMap);
     std::unordered_map<cstring, std::vector<ConstTernaryEntryDesc>> entriesGroupedByMask;
     unsigned priority = entries->entries.size() + 1;
@@ -892,6 +899,9 @@ EBPFTablePSA::EntriesGroupedByMask_t EBPFTablePSA::getConstEntriesGroupedByMask(
     for (auto &vec : entriesGroupedByMask) {
         result.emplace_back(std::move(vec.second));
     }
+    std::sort(result.begin(), result.end(), [](const EntriesGroup_t &a, const EntriesGroup_t &b) {
+        return a.front().priority > b.front().priority;
+    });
     return result;
 }
 
@@ -54,30 +54,35 @@ void CRCChecksumAlgorithm::emitUpdateMethod(CodeBuilder *builder, int crcWidth)
     // version may require other method of update. When data_size <= 64 bits,
     // applies host byte order for input data, otherwise network byte order is expected.
     if (crcWidth == 16) {
-        // This function calculates CRC16 by definition, it is bit by bit. If input data has more
-        // than 64 bit, the outer loop process bytes in network byte order - data pointer is
-        // incremented. For data shorter than or equal 64 bits, bytes are processed in little endian
-        // byte order - data pointer is decremented by outer loop in this case.
-        // There is no need for lookup table.
-        cstring code =
+        // This function calculates CRC16 byte by byte using a lookup table, one table lookup
+        // replaces eight shift/xor steps. If input data has more than 64 bit, the outer loop
+        // process bytes in network byte order - data pointer is incremented. For data shorter than
+        // or equal 64 bits, bytes are processed in little endian byte order - data pointer is
+        // decremented by outer loop in this case.
+        const auto &table = getLookupTable(16);
+        cstring code = Util::printf_format(
             "static __always_inline\n"
             "void crc16_update(u16 * reg, const u8 * data, "
             "u16 data_size, const u16 poly) {\n"
+            "    struct lookup_tbl_val* lookup_table;\n"
+            "    u32 index = 0;\n"
+            "    lookup_table = BPF_MAP_LOOKUP_ELEM(crc_lookup_tbl, &index);\n"
+            "    if (lookup_table == NULL)\n"
+            "        return;\n"
             "    if (data_size <= 8)\n"
             "        data += data_size - 1;\n"
             "    #pragma clang loop unroll(full)\n"
             "    for (u16 i = 0; i < data_size; i++) {\n"
-            "        bpf_trace_message(\"CRC16: data byte: %x\\n\", *data);\n"
-            "        *reg ^= *data;\n"
-            "        for (u8 bit = 0; bit < 8; bit++) {\n"
-            "            *reg = (*reg) & 1 ? ((*reg) >> 1) ^ poly : (*reg) >> 1;\n"
-            "        }\n"
+            "        bpf_trace_message(\"CRC16: data byte: %%x\\n\", *data);\n"
+            "        *reg = ((*reg) >> 8) ^ "
+            "lookup_table->table[(u16)(%u + (u8)((*reg) ^ *data))];\n"
             "        if (data_size <= 8)\n"
             "            data--;\n"
             "        else\n"
             "            data++;\n"
             "    }\n"
-            "}";
+            "}",
+            table.offset);
         builder->appendLine(code);
     } else if (crcWidth == 32) {
         // This function calculates CRC32 using two optimisations: slice-by-8 and Standard
@@ -90,7 +95,9 @@ void CRCChecksumAlgorithm::emitUpdateMethod(CodeBuilder *builder, int crcWidth)
         //    big endian byte order.
         // 4. Data size more than 8 bytes and not multiply of 8 bytes - calculated using slice-by-8
         //    and Standard Implementation both in big endian byte order.
-        // Lookup table is necessary for both algorithms.
+        // Lookup table is necessary for both algorithms. Its slices are indexed from the beginning
+        // of the map value.
+        BUG_CHECK(getLookupTable(32).offset == 0, "CRC32 lookup table must be the first one");
         cstring code =
             "static __always_inline\n"
             "void crc32_update(u32 * reg, const u8 * data, u16 data_size, const u32 poly) {\n"
@@ -173,6 +180,99 @@ void CRCChecksumAlgorithm::emitUpdateMethod(CodeBuilder *builder, int crcWidth)
     }
 }
 
+const std::vector<CRCChecksumAlgorithm::LookupTable> &CRCChecksumAlgorithm::getLookupTables() {
+    // CRC32 uses slice-by-8, so it needs eight tables, each next one derived from the previous.
+    static const std::vector<LookupTable> tables = {
+        {32, 0xEDB88320, 0, 8},
+        {16, 0xA001, 2048, 1},
+    };
+    return tables;
+}
+
+const CRCChecksumAlgorithm::LookupTable &CRCChecksumAlgorithm::getLookupTable(int crcWidth) {
+    for (const auto &table : getLookupTables()) {
+        if (table.crcWidth == crcWidth) return table;
+    }
+    BUG("No CRC lookup table for width %1%", crcWidth);
+}
+
+void CRCChecksumAlgorithm::emitLookupTableTypes(CodeBuilder *builder) {
+    unsigned size = 0;
+    for (const auto &table : getLookupTables()) size += table.slices * 256;
+
+    builder->append("struct lookup_tbl_val ");
+    builder->blockStart();
+    builder->emitIndent();
+    builder->appendFormat("u32 table[%u]", size);
+    builder->endOfStatement(true);
+    builder->blockEnd(false);
+    builder->endOfStatement(true);
+}
+
+void CRCChecksumAlgorithm::emitLookupTableInstance(CodeBuilder *builder) {
+    builder->target->emitTableDecl(builder, cstring("crc_lookup_tbl"), TableArray, "u32",
+                                   cstring("struct lookup_tbl_val"), 1);
+}
+
+/*
+ * This method generates a C code that fills the CRC lookup tables of all polynomials.
+ * The first slice of a table holds the CRC of every byte value, computed bit by bit.
+ * Every next slice (slice-by-8 only) holds the CRC of a byte followed by a zero byte,
+ * which is derived from the previous slice.
+ */
+void CRCChecksumAlgorithm::emitLookupTableInitializer(CodeBuilder *builder) {
+    cstring keyName = "lookup_tbl_key";
+    cstring valueName = "lookup_tbl_value";
+    cstring instanceName = "crc_lookup_tbl";
+    const char *value = valueName.c_str();
+
+    builder->emitIndent();
+    builder->appendFormat("u32 %s = 0", keyName.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("struct lookup_tbl_val* %s = BPF_MAP_LOOKUP_ELEM(%s, &%s)", value,
+                          instanceName.c_str(), keyName.c_str());
+    builder->endOfStatement(true);
+    builder->emitIndent();
+    builder->appendFormat("if (%s != NULL)", value);
+    builder->blockStart();
+    for (const auto &table : getLookupTables()) {
+        builder->emitIndent();
+        builder->appendFormat("for (u16 i = 0; i <= 255; i++)");
+        builder->blockStart();
+        builder->emitIndent();
+        builder->appendFormat("u32 crc = i");
+        builder->endOfStatement(true);
+        builder->emitIndent();
+        builder->appendFormat("for (u16 j = 0; j < 8; j++)");
+        builder->blockStart();
+        builder->emitIndent();
+        builder->appendFormat("crc = (crc >> 1) ^ ((crc & 1) * 0x%X)", table.polynomial);
+        builder->endOfStatement(true);
+        builder->blockEnd(true);
+        builder->emitIndent();
+        builder->appendFormat("%s->table[%u+i] = crc", value, table.offset);
+        builder->endOfStatement(true);
+        builder->blockEnd(true);
+
+        if (table.slices < 2) continue;
+        builder->emitIndent();
+        builder->appendFormat("for (u16 i = 0; i <= 255; i++)");
+        builder->blockStart();
+        for (unsigned slice = 1; slice < table.slices; slice++) {
+            unsigned current = table.offset + slice * 256;
+            unsigned previous = current - 256;
+            builder->emitIndent();
+            builder->appendFormat(
+                "%s->table[%u+i] = (%s->table[%u+i] >> 8) ^ %s->table[%u+(%s->table[%u+i] & 0xFF)]",
+                value, current, value, previous, value, table.offset, value, previous);
+            builder->endOfStatement(true);
+        }
+        builder->blockEnd(true);
+    }
+    builder->blockEnd(true);
+}
+
 void CRCChecksumAlgorithm::emitVariables(CodeBuilder *builder,
                                          const IR::Declaration_Instance *decl) {
     registerVar = program->refMap->newName(baseName + "_reg");
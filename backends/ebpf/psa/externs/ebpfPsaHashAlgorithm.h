@@ -17,6 +17,9 @@ limitations under the License.
 #ifndef BACKENDS_EBPF_PSA_EXTERNS_EBPFPSAHASHALGORITHM_H_
 #define BACKENDS_EBPF_PSA_EXTERNS_EBPFPSAHASHALGORITHM_H_
 
+#include <cstdint>
+#include <vector>
+
 #include "backends/ebpf/ebpfObject.h"
 
 namespace EBPF {
@@ -72,6 +75,22 @@ class EBPFHashAlgorithmPSA : public EBPFObject {
 };
 
 class CRCChecksumAlgorithm : public EBPFHashAlgorithmPSA {
+ public:
+    /**
+     * A lookup table in the crc_lookup_tbl map. There is one table per polynomial, shared
+     * by all hash and checksum instances that use it. The layout of the map value is fixed
+     * when the program is compiled, the entries are computed by the map initializer.
+     */
+    struct LookupTable {
+        int crcWidth;
+        // The polynomial in a reflected bit order.
+        uint32_t polynomial;
+        // Index of the first entry of the table in the map value.
+        unsigned offset;
+        // Number of 256-entry slices, 8 for slice-by-8 and 1 for the byte-wise algorithm.
+        unsigned slices;
+    };
+
  protected:
     cstring registerVar;
     cstring initialValue;
@@ -88,6 +107,14 @@ class CRCChecksumAlgorithm : public EBPFHashAlgorithmPSA {
 
     static void emitUpdateMethod(CodeBuilder *builder, int crcWidth);
 
+    // Lookup tables of all supported polynomials, in the order of the map value.
+    static const std::vector<LookupTable> &getLookupTables();
+    static const LookupTable &getLookupTable(int crcWidth);
+
+    static void emitLookupTableTypes(CodeBuilder *builder);
+    static void emitLookupTableInstance(CodeBuilder *builder);
+    static void emitLookupTableInitializer(CodeBuilder *builder);
+
     void emitVariables(CodeBuilder *builder, const IR::Declaration_Instance *decl) override;
 
     void emitClear(CodeBuilder *builder) override;
@@ -103,7 +130,7 @@ class CRCChecksumAlgorithm : public EBPFHashAlgorithmPSA {
 /**
  * For CRC16 calculation we use a polynomial 0x8005.
  * - updateMethod adds a data to the checksum
- * and performs a CRC16 calculation
+ * and performs a table-driven CRC16 calculation
  * - finalizeMethod returns the CRC16 result
  *
  * Above C functions are emitted via emitGlobals.
@@ -0,0 +1,165 @@
+/*
+Copyright 2022-present Open Networking Foundation
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+/*
+ * Userspace benchmark of the CRC16 update methods emitted by the PSA eBPF backend
+ * for the Hash and Checksum externs. It hashes a 5-tuple per packet, one field at a
+ * time like the generated code does, with the bit by bit algorithm and with the
+ * table-driven one, checks that both agree and reports cycles per packet.
+ *
+ * Build and run:
+ *     gcc -O2 -o crc_bench crc_bench.c && ./crc_bench [packets]
+ */
+
+#include <stdio.h>      // printf()
+#include <stdlib.h>     // strtoul()
+#include <time.h>       // clock_gettime()
+#include "ebpf_common.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // __rdtsc()
+#define CYCLES_UNIT "cycles"
+static inline u64 read_cycles(void) {
+    return __rdtsc();
+}
+#else
+#define CYCLES_UNIT "ns"
+static inline u64 read_cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#endif
+
+#define DEFAULT_PACKETS 10000000
+/* 0x8005 in a reflected bit order */
+#define CRC16_POLY 0xA001
+
+struct five_tuple {
+    u32 src_addr;
+    u32 dst_addr;
+    u16 src_port;
+    u16 dst_port;
+    u8 protocol;
+};
+
+static u32 crc16_table[256];
+
+static void crc16_init_table(void) {
+    for (u16 i = 0; i <= 255; i++) {
+        u32 crc = i;
+        for (u16 j = 0; j < 8; j++)
+            crc = (crc >> 1) ^ ((crc & 1) * CRC16_POLY);
+        crc16_table[i] = crc;
+    }
+}
+
+/* Same as the crc16_update emitted before the lookup table was introduced. */
+static inline void crc16_update_bitwise(u16 *reg, const u8 *data, u16 data_size) {
+    if (data_size <= 8)
+        data += data_size - 1;
+    for (u16 i = 0; i < data_size; i++) {
+        *reg ^= *data;
+        for (u8 bit = 0; bit < 8; bit++)
+            *reg = (*reg) & 1 ? ((*reg) >> 1) ^ CRC16_POLY : (*reg) >> 1;
+        if (data_size <= 8)
+            data--;
+        else
+            data++;
+    }
+}
+
+/* Same as the crc16_update emitted by the compiler. */
+static inline void crc16_update_table(u16 *reg, const u8 *data, u16 data_size) {
+    if (data_size <= 8)
+        data += data_size - 1;
+    for (u16 i = 0; i < data_size; i++) {
+        *reg = ((*reg) >> 8) ^ crc16_table[(u8)((*reg) ^ *data)];
+        if (data_size <= 8)
+            data--;
+        else
+            data++;
+    }
+}
+
+typedef void (*crc16_update_fn)(u16 *reg, const u8 *data, u16 data_size);
+
+static inline u16 hash_five_tuple(crc16_update_fn update, const struct five_tuple *t) {
+    u16 reg = 0;
+    update(&reg, (const u8 *) &t->src_addr, 4);
+    update(&reg, (const u8 *) &t->dst_addr, 4);
+    update(&reg, (const u8 *) &t->src_port, 2);
+    update(&reg, (const u8 *) &t->dst_port, 2);
+    update(&reg, (const u8 *) &t->protocol, 1);
+    return reg;
+}
+
+static inline void next_tuple(struct five_tuple *t, u32 i) {
+    /* A cheap generator, so that the benchmark does not hash the same tuple. */
+    t->src_addr = 0x0a000000 + i * 2654435761u;
+    t->dst_addr = 0xc0a80000 ^ (i >> 3);
+    t->src_port = (u16) (i * 40503u);
+    t->dst_port = (u16) (i & 1 ? 443 : 80);
+    t->protocol = i & 7 ? 6 : 17;
+}
+
+static double run(const char *name, crc16_update_fn update, u32 packets, u16 *digest) {
+    struct five_tuple t;
+    u16 acc = 0;
+    u64 start = read_cycles();
+    for (u32 i = 0; i < packets; i++) {
+        next_tuple(&t, i);
+        acc ^= hash_five_tuple(update, &t);
+    }
+    u64 elapsed = read_cycles() - start;
+    double per_packet = (double) elapsed / packets;
+    printf("%-12s %8.2f %s/packet (digest 0x%04x)\n", name, per_packet, CYCLES_UNIT, acc);
+    *digest = acc;
+    return per_packet;
+}
+
+int main(int argc, char **argv) {
+    u32 packets = DEFAULT_PACKETS;
+    if (argc > 1)
+        packets = (u32) strtoul(argv[1], NULL, 10);
+    if (packets == 0) {
+        fprintf(stderr, "usage: %s [packets]\n", argv[0]);
+        return 1;
+    }
+
+    crc16_init_table();
+
+    /* Both algorithms have to compute the same CRC for every tuple. */
+    struct five_tuple t;
+    for (u32 i = 0; i < 1024; i++) {
+        next_tuple(&t, i);
+        if (hash_five_tuple(crc16_update_bitwise, &t) !=
+            hash_five_tuple(crc16_update_table, &t)) {
+            fprintf(stderr, "CRC16 mismatch for tuple %u\n", i);
+            return 1;
+        }
+    }
+
+    u16 bitwise_digest, table_digest;
+    double bitwise = run("bitwise", crc16_update_bitwise, packets, &bitwise_digest);
+    double table = run("table", crc16_update_table, packets, &table_digest);
+    if (bitwise_digest != table_digest) {
+        fprintf(stderr, "CRC16 digests differ\n");
+        return 1;
+    }
+    printf("speedup      %8.2fx\n", bitwise / table);
+    return 0;
+}
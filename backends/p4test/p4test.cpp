@@ -16,6 +16,9 @@ limitations under the License.
 
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
 
 #include "backends/p4test/version.h"
 #include "control-plane/p4RuntimeSerializer.h"
@@ -24,8 +27,11 @@ limitations under the License.
 #include "frontends/p4/evaluator/evaluator.h"
 #include "frontends/p4/frontend.h"
 #include "frontends/p4/toP4/toP4.h"
+#include "ir/binary_generator.h"
+#include "ir/binary_loader.h"
 #include "ir/ir.h"
 #include "ir/json_loader.h"
+#include "lib/arena.h"
 #include "lib/crash.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
@@ -39,6 +45,7 @@ class P4TestOptions : public CompilerOptions {
     bool parseOnly = false;
     bool validateOnly = false;
     bool loadIRFromJson = false;
+    bool loadIRFromBinary = false;
     P4TestOptions() {
         registerOption(
             "--listMidendPasses", nullptr,
@@ -72,6 +79,15 @@ class P4TestOptions : public CompilerOptions {
                 return true;
             },
             "read previously dumped json instead of P4 source code");
+        registerOption(
+            "--fromBinary", "file",
+            [this](const char *arg) {
+                loadIRFromBinary = true;
+                file = arg;
+                return true;
+            },
+            "read a snapshot written by --toBinary instead of P4 source code,\n"
+            "and skip the frontend");
         registerOption(
             "--turn-off-logn", nullptr,
             [](const char *) {
@@ -100,6 +116,52 @@ static void log_dump(const IR::Node *node, const char *head) {
     }
 }
 
+/// Parses the input and runs the frontend on it, unless only parsing was requested.  Returns
+/// false if the frontend crashed.
+static bool parseAndRunFrontend(P4TestOptions &options, DebugHook hook,
+                                const IR::P4Program *&program) {
+    program = P4::parseP4File(options);
+
+    if (program != nullptr && ::errorCount() == 0) {
+        P4::P4COptionPragmaParser optionsPragmaParser;
+        program->apply(P4::ApplyOptionsPragmas(optionsPragmaParser));
+
+        if (!options.parseOnly) {
+            try {
+                P4::FrontEnd fe;
+                fe.addDebugHook(hook);
+                program = fe.run(options, program);
+            } catch (const std::exception &bug) {
+                std::cerr << bug.what() << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+#if HAVE_IR_ARENA
+/// Returns a copy of @p program allocated outside any arena.  The copy goes through an
+/// in-memory snapshot, which keeps the sharing between nodes and their source positions.
+static const IR::P4Program *copyOutOfArena(const IR::P4Program *program) {
+    std::stringstream buffer;
+    BinaryGenerator().write(buffer, program);
+    std::string data = buffer.str();
+    std::unique_ptr<BinarySnapshot> snapshot(
+        BinarySnapshot::fromBuffer("frontend output", data.data(), data.size()));
+    BUG_CHECK(snapshot != nullptr, "cannot read back the frontend output");
+    for (auto *obj : program->objects) {
+        if (auto *sources = obj->srcInfo.getSources()) {
+            snapshot->setSources(sources);
+            break;
+        }
+    }
+    auto *root = snapshot->getRoot();
+    BUG_CHECK(root && root->is<IR::P4Program>(), "cannot read back the frontend output");
+    return root->to<IR::P4Program>();
+}
+#endif
+
 int main(int argc, char *const argv[]) {
     setup_gc_logging();
     setup_signals();
@@ -110,7 +172,7 @@ int main(int argc, char *const argv[]) {
     options.compilerVersion = P4TEST_VERSION_STRING;
 
     if (options.process(argc, argv) != nullptr) {
-        if (options.loadIRFromJson == false) options.setInputFile();
+        if (!options.loadIRFromJson && !options.loadIRFromBinary) options.setInputFile();
     }
     if (::errorCount() > 0) return 1;
     const IR::P4Program *program = nullptr;
@@ -126,24 +188,28 @@ int main(int argc, char *const argv[]) {
         } else {
             error(ErrorType::ERR_IO, "Can't open %s", options.file);
         }
+    } else if (options.loadIRFromBinary) {
+        if (auto *snapshot = BinarySnapshot::open(options.file)) {
+            auto *node = snapshot->getRoot();
+            if (!node || !(program = node->to<IR::P4Program>()))
+                error(ErrorType::ERR_INVALID, "%s is not a snapshot of a P4Program", options.file);
+        }
     } else {
-        program = P4::parseP4File(options);
-
-        if (program != nullptr && ::errorCount() == 0) {
-            P4::P4COptionPragmaParser optionsPragmaParser;
-            program->apply(P4::ApplyOptionsPragmas(optionsPragmaParser));
-
-            if (!options.parseOnly) {
-                try {
-                    P4::FrontEnd fe;
-                    fe.addDebugHook(hook);
-                    program = fe.run(options, program);
-                } catch (const std::exception &bug) {
-                    std::cerr << bug.what() << std::endl;
-                    return 1;
-                }
-            }
+#if HAVE_IR_ARENA
+        // Everything the parser and the frontend create is dead once the frontend is done,
+        // except its output, so they allocate from an arena and the output is copied out.
+        Util::Arena frontendArena;
+        bool ok;
+        {
+            Util::ArenaScope frontendScope(frontendArena);
+            ok = parseAndRunFrontend(options, hook, program);
         }
+        if (ok && program != nullptr) program = copyOutOfArena(program);
+        frontendArena.release();
+#else
+        bool ok = parseAndRunFrontend(options, hook, program);
+#endif
+        if (!ok) return 1;
     }
 
     log_dump(program, "Initial program");
@@ -1,9 +1,11 @@
 #include "backends/p4tools/common/compiler/reachability.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <iostream>
 #include <list>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -157,6 +159,22 @@ bool P4ProgramDCGCreator::preorder(const IR::P4Table *table) {
     } else if (wasImplementations) {
         prevSet.insert(prev.begin(), prev.end());
     }
+    // The control plane may add entries for any action of the table.
+    if (const auto *actionList = table->getActionList()) {
+        const auto *currentControl = findOrigCtxt<IR::P4Control>();
+        for (const auto *element : actionList->actionList) {
+            prev = storedSet;
+            if (element->expression->is<IR::MethodCallExpression>()) {
+                visit(element->expression);
+            } else if (currentControl != nullptr) {
+                const auto *decl = currentControl->getDeclByName(element->getName().name);
+                if (decl != nullptr && decl->is<IR::P4Action>()) {
+                    visit(decl->to<IR::P4Action>());
+                }
+            }
+            prevSet.insert(prev.begin(), prev.end());
+        }
+    }
     prev = storedSet;
     visit(table->getDefaultAction());
     prevSet.insert(prev.begin(), prev.end());
@@ -331,6 +349,130 @@ void P4ProgramDCGCreator::addEdge(const DCGVertexType *vertex, IR::ID vertexName
     dcg->addToHash(vertex, vertexName);
 }
 
+StatementReachability::StatementReachability(const NodesCallGraph &dcg,
+                                             const P4::Coverage::CoverageSet &statements)
+    : reachable(statements.size()) {
+    for (const auto *statement : statements) {
+        statementIndices.emplace(statement, statementIndices.size());
+    }
+
+    // Number the vertices and collect their successors.
+    std::vector<const DCGVertexType *> vertices(dcg.nodes.begin(), dcg.nodes.end());
+    std::unordered_map<const DCGVertexType *, size_t> vertexIndices;
+    for (size_t v = 0; v < vertices.size(); v++) {
+        vertexIndices.emplace(vertices[v], v);
+    }
+    std::vector<std::vector<size_t>> successors(vertices.size());
+    for (const auto &edges : dcg) {
+        auto &vertexSuccessors = successors[vertexIndices.at(edges.first)];
+        for (const auto *callee : *edges.second) {
+            vertexSuccessors.push_back(vertexIndices.at(callee));
+        }
+    }
+    std::vector<std::optional<size_t>> vertexStatements(vertices.size());
+    for (size_t v = 0; v < vertices.size(); v++) {
+        if (const auto *statement = vertices[v]->to<IR::Statement>()) {
+            vertexStatements[v] = getIndex(statement);
+        }
+    }
+
+    // Find the strongly connected components with Tarjan's algorithm. It completes a component
+    // only after all components reachable from it, so the statements reachable from a component
+    // are computed from those of its successors as soon as it is complete. The depth-first search
+    // is iterative, because the DCG of a large program is deep.
+    const size_t unvisited = vertices.size();
+    std::vector<size_t> order(vertices.size(), unvisited);
+    std::vector<size_t> lowLink(vertices.size());
+    std::vector<size_t> components(vertices.size());
+    std::vector<bool> onStack(vertices.size());
+    std::vector<size_t> stack;
+    std::vector<bitvec> componentReachable;
+    // Pairs of a vertex and the position of its next successor to visit.
+    std::vector<std::pair<size_t, size_t>> work;
+    size_t counter = 0;
+    for (size_t root = 0; root < vertices.size(); root++) {
+        if (order[root] != unvisited) {
+            continue;
+        }
+        work.emplace_back(root, 0);
+        while (!work.empty()) {
+            auto [v, next] = work.back();
+            if (next == 0) {
+                order[v] = lowLink[v] = counter++;
+                stack.push_back(v);
+                onStack[v] = true;
+            }
+            if (next < successors[v].size()) {
+                work.back().second++;
+                auto w = successors[v][next];
+                if (order[w] == unvisited) {
+                    work.emplace_back(w, 0);
+                } else if (onStack[w]) {
+                    lowLink[v] = std::min(lowLink[v], order[w]);
+                }
+                continue;
+            }
+            work.pop_back();
+            if (!work.empty()) {
+                auto parent = work.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[v]);
+            }
+            if (lowLink[v] != order[v]) {
+                continue;
+            }
+            // @v is the root of a component, which consists of the vertices above it on the stack.
+            auto component = componentReachable.size();
+            auto rootPosition = std::find(stack.begin(), stack.end(), v);
+            std::vector<size_t> members(rootPosition, stack.end());
+            stack.erase(rootPosition, stack.end());
+            bitvec componentStatements;
+            for (auto member : members) {
+                onStack[member] = false;
+                components[member] = component;
+                if (vertexStatements[member]) {
+                    componentStatements.setbit(*vertexStatements[member]);
+                }
+            }
+            for (auto member : members) {
+                for (auto w : successors[member]) {
+                    if (components[w] != component) {
+                        componentStatements |= componentReachable[components[w]];
+                    }
+                }
+            }
+            componentReachable.push_back(componentStatements);
+        }
+    }
+
+    unknownStatements.setrange(0, statements.size());
+    for (size_t v = 0; v < vertices.size(); v++) {
+        if (vertexStatements[v]) {
+            reachable[*vertexStatements[v]] |= componentReachable[components[v]];
+            unknownStatements.clrbit(*vertexStatements[v]);
+        }
+    }
+}
+
+std::optional<size_t> StatementReachability::getIndex(const IR::Statement *statement) const {
+    auto index = statementIndices.find(statement);
+    if (index == statementIndices.end()) {
+        return std::nullopt;
+    }
+    return index->second;
+}
+
+const bitvec *StatementReachability::getReachable(const IR::Statement *statement) const {
+    auto index = getIndex(statement);
+    if (!index || unknownStatements.getbit(*index)) {
+        return nullptr;
+    }
+    return &reachable[*index];
+}
+
+const bitvec &StatementReachability::getUnknownStatements() const { return unknownStatements; }
+
+size_t StatementReachability::size() const { return reachable.size(); }
+
 ReachabilityEngineState *ReachabilityEngineState::getInitial() {
     auto *newState = new ReachabilityEngineState();
     newState->prevNode = nullptr;
@@ -1,7 +1,10 @@
 #ifndef COMMON_COMPILER_REACHABILITY_H_
 #define COMMON_COMPILER_REACHABILITY_H_
 
+#include <cstddef>
 #include <list>
+#include <map>
+#include <optional>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -14,8 +17,10 @@
 #include "ir/ir.h"
 #include "ir/node.h"
 #include "ir/visitor.h"
+#include "lib/bitvec.h"
 #include "lib/cstring.h"
 #include "lib/null.h"
+#include "midend/coverage.h"
 
 namespace P4Tools {
 
@@ -118,6 +123,40 @@ class P4ProgramDCGCreator : public Inspector {
     void addEdge(const DCGVertexType *vertex, IR::ID vertexName = IR::ID());
 };
 
+/// Precomputed statement reachability in a DCG. Every statement of a coverage set is numbered by
+/// its position in the set, and every statement that is a vertex of the DCG is mapped to the
+/// statements that may execute after it, as a bit vector of these numbers. Reachability queries
+/// then cost a few word operations instead of a search of the graph. Cycles, such as parser loops,
+/// are collapsed into their strongly connected components before the sets are computed.
+class StatementReachability {
+    /// The numbers of the statements. Statements are compared like in coverage sets.
+    std::map<const IR::Statement *, size_t, P4::Coverage::SourceIdCmp> statementIndices;
+
+    /// For each statement, the statements that may execute after it, including itself. Empty if
+    /// the statement is not part of the DCG.
+    std::vector<bitvec> reachable;
+
+    /// The statements that are not part of the DCG. Nothing is known about when they execute.
+    bitvec unknownStatements;
+
+ public:
+    /// Computes the reachable statements of @p statements in @p dcg.
+    StatementReachability(const NodesCallGraph &dcg, const P4::Coverage::CoverageSet &statements);
+
+    /// @returns the number of @p statement, or std::nullopt if it is not in the coverage set.
+    [[nodiscard]] std::optional<size_t> getIndex(const IR::Statement *statement) const;
+
+    /// @returns the statements that may execute after @p statement, including itself, or nullptr
+    /// if @p statement is not part of the DCG.
+    [[nodiscard]] const bitvec *getReachable(const IR::Statement *statement) const;
+
+    /// @returns the statements that are not part of the DCG.
+    [[nodiscard]] const bitvec &getUnknownStatements() const;
+
+    /// @returns the number of statements in the coverage set.
+    [[nodiscard]] size_t size() const;
+};
+
 /// The main data for reachability engine.
 class ReachabilityEngineState {
     const DCGVertexType *prevNode = nullptr;
@@ -0,0 +1,275 @@
+#include "backends/p4tools/common/core/caching_solver.h"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "ir/ir.h"
+#include "ir/visitor.h"
+#include "lib/exceptions.h"
+#include "lib/timer.h"
+
+namespace P4Tools {
+
+namespace {
+
+/// Collects the state variables of an expression, that is, the variables that a solver declares
+/// when the expression is asserted.
+class CollectVariables : public Inspector {
+    std::vector<StateVariable> &result;
+
+    bool preorder(const IR::Member *member) override {
+        result.emplace_back(member);
+        return false;
+    }
+
+    bool preorder(const IR::ConcolicVariable *var) override {
+        result.emplace_back(var->concolicMember);
+        return false;
+    }
+
+ public:
+    explicit CollectVariables(std::vector<StateVariable> &result) : result(result) {}
+};
+
+}  // namespace
+
+CachingSolver::CachingSolver(AbstractSolver &solver) : solver(solver) {}
+
+void CachingSolver::comment(cstring comment) { solver.comment(comment); }
+
+void CachingSolver::seed(unsigned seed) {
+    solver.seed(seed);
+    clearCache();
+}
+
+void CachingSolver::timeout(unsigned tm) { solver.timeout(tm); }
+
+const std::vector<StateVariable> &CachingSolver::getVariables(
+    const Constraint *assertion) const {
+    auto it = variables.find(assertion);
+    if (it != variables.end()) {
+        return it->second;
+    }
+    auto &result = variables[assertion];
+    assertion->apply(CollectVariables(result));
+    return result;
+}
+
+std::vector<std::vector<const Constraint *>> CachingSolver::partition(
+    const std::vector<const Constraint *> &asserts) {
+    // Union-find over the indices of the assertions. The root of a set is its smallest index.
+    std::vector<size_t> parent(asserts.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](size_t i) {
+        while (parent[i] != i) {
+            i = parent[i] = parent[parent[i]];
+        }
+        return i;
+    };
+    std::map<StateVariable, size_t> firstUse;
+    for (size_t i = 0; i < asserts.size(); i++) {
+        for (const auto &var : getVariables(asserts[i])) {
+            auto inserted = firstUse.emplace(var, i);
+            if (inserted.second) {
+                continue;
+            }
+            auto a = find(i);
+            auto b = find(inserted.first->second);
+            if (a != b) {
+                parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+    }
+
+    // Number the groups in the order of their first assertions.
+    std::vector<std::vector<const Constraint *>> groups;
+    std::vector<size_t> groupOf(asserts.size());
+    for (size_t i = 0; i < asserts.size(); i++) {
+        auto root = find(i);
+        if (root == i) {
+            groupOf[i] = groups.size();
+            groups.emplace_back();
+        }
+        groups[groupOf[root]].push_back(asserts[i]);
+    }
+    return groups;
+}
+
+std::optional<CachingSolver::Result> CachingSolver::lookup(const Group &group) const {
+    auto it = results.find(group);
+    if (it != results.end()) {
+        return it->second;
+    }
+
+    // A group that contains an unsatisfiable group is unsatisfiable.
+    for (const auto *assertion : group) {
+        auto unsat = unsatGroupsFrom.find(assertion);
+        if (unsat == unsatGroupsFrom.end()) {
+            continue;
+        }
+        for (const auto *entry : unsat->second) {
+            if (std::includes(group.begin(), group.end(), entry->first.begin(),
+                              entry->first.end())) {
+                return entry->second;
+            }
+        }
+    }
+
+    // A group that is contained in a satisfiable group is satisfiable. It suffices to check the
+    // groups that contain its rarest assertion.
+    const std::vector<const Entry *> *candidates = nullptr;
+    for (const auto *assertion : group) {
+        auto sat = satGroupsWith.find(assertion);
+        if (sat == satGroupsWith.end()) {
+            return std::nullopt;
+        }
+        if (candidates == nullptr || sat->second.size() < candidates->size()) {
+            candidates = &sat->second;
+        }
+    }
+    if (candidates != nullptr) {
+        for (const auto *entry : *candidates) {
+            if (std::includes(entry->first.begin(), entry->first.end(), group.begin(),
+                              group.end())) {
+                return entry->second;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+void CachingSolver::store(Group group, Result result) {
+    if (results.size() >= maxCacheSize) {
+        clearCache();
+    }
+    auto inserted = results.emplace(std::move(group), result);
+    if (!inserted.second || inserted.first->first.empty()) {
+        return;
+    }
+    const auto *entry = &*inserted.first;
+    if (result.sat) {
+        for (const auto *assertion : entry->first) {
+            satGroupsWith[assertion].push_back(entry);
+        }
+    } else {
+        unsatGroupsFrom[entry->first.front()].push_back(entry);
+    }
+}
+
+void CachingSolver::clearCache() {
+    results.clear();
+    satGroupsWith.clear();
+    unsatGroupsFrom.clear();
+    variables.clear();
+}
+
+std::optional<bool> CachingSolver::checkSat(const std::vector<const Constraint *> &asserts) {
+    model = nullptr;
+    lastSat = false;
+    solverModelOf = std::nullopt;
+    lastGroups = partition(asserts);
+    lastKeys.assign(lastGroups.size(), {});
+    lastModels.assign(lastGroups.size(), nullptr);
+    std::vector<bool> cached(lastGroups.size());
+
+    // Answer what we can from the cache first, since a single unsatisfiable group decides the
+    // query.
+    for (size_t i = 0; i < lastGroups.size(); i++) {
+        auto &key = lastKeys[i];
+        key = lastGroups[i];
+        std::sort(key.begin(), key.end());
+        key.erase(std::unique(key.begin(), key.end()), key.end());
+        Util::ScopedTimer timer("solverCacheLookup");
+        auto result = lookup(key);
+        if (!result) {
+            continue;
+        }
+        cacheHits++;
+        if (!result->sat) {
+            return false;
+        }
+        cached[i] = true;
+        lastModels[i] = result->model;
+    }
+
+    for (size_t i = 0; i < lastGroups.size(); i++) {
+        if (cached[i]) {
+            continue;
+        }
+        // The next query replaces the model the underlying solver holds, so take it now.
+        if (solverModelOf) {
+            setGroupModel(*solverModelOf, solver.getModel());
+            solverModelOf = std::nullopt;
+        }
+        solverQueries++;
+        auto sat = solver.checkSat(lastGroups[i]);
+        if (!sat) {
+            return std::nullopt;
+        }
+        store(lastKeys[i], Result{*sat, nullptr});
+        if (!*sat) {
+            return false;
+        }
+        solverModelOf = i;
+    }
+    lastSat = true;
+    return true;
+}
+
+void CachingSolver::setGroupModel(size_t index, const Model *groupModel) const {
+    lastModels[index] = groupModel;
+    auto it = results.find(lastKeys[index]);
+    if (it != results.end() && it->second.sat) {
+        it->second.model = groupModel;
+    }
+}
+
+const Model *CachingSolver::solveForModel(size_t index) const {
+    solverQueries++;
+    auto sat = solver.checkSat(lastGroups[index]);
+    BUG_CHECK(sat && *sat, "A group of assertions that was satisfiable is no longer.");
+    return solver.getModel();
+}
+
+const Model *CachingSolver::getModel() const {
+    BUG_CHECK(lastSat, "The last query was not satisfiable; there is no model.");
+    if (model != nullptr) {
+        return model;
+    }
+    if (solverModelOf) {
+        setGroupModel(*solverModelOf, solver.getModel());
+        solverModelOf = std::nullopt;
+    }
+    // Groups answered from a cache entry whose model was never fetched are solved again.
+    for (size_t i = 0; i < lastGroups.size(); i++) {
+        if (lastModels[i] == nullptr) {
+            setGroupModel(i, solveForModel(i));
+        }
+    }
+
+    // The model of a cached group may be the model of a larger group and assign variables that
+    // belong to other groups of this query. Only take the variables of each group from its model.
+    std::vector<std::pair<StateVariable, const IR::Expression *>> values;
+    for (size_t i = 0; i < lastGroups.size(); i++) {
+        const auto *groupModel = lastModels[i];
+        for (const auto *assertion : lastGroups[i]) {
+            for (const auto &var : getVariables(assertion)) {
+                auto it = groupModel->find(var);
+                if (it != groupModel->end()) {
+                    values.emplace_back(var, it->second);
+                }
+            }
+        }
+    }
+    auto *result = new Model();
+    result->insert(values.begin(), values.end());
+    model = result;
+    return model;
+}
+
+void CachingSolver::toJSON(JSONGenerator &json) const { solver.toJSON(json); }
+
+bool CachingSolver::isInIncrementalMode() const { return solver.isInIncrementalMode(); }
+
+}  // namespace P4Tools
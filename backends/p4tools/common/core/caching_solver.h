@@ -0,0 +1,135 @@
+#ifndef BACKENDS_P4TOOLS_COMMON_CORE_CACHING_SOLVER_H_
+#define BACKENDS_P4TOOLS_COMMON_CORE_CACHING_SOLVER_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "backends/p4tools/common/core/solver.h"
+#include "backends/p4tools/common/lib/formulae.h"
+#include "backends/p4tools/common/lib/model.h"
+#include "ir/json_generator.h"
+#include "lib/cstring.h"
+
+namespace P4Tools {
+
+/// A solver that answers queries from the results of earlier queries where it can, and otherwise
+/// delegates them to another solver.
+///
+/// The assertions of a query are partitioned into groups that share no state variables. Each
+/// group is satisfiable independently of the others, so the query is satisfiable exactly when
+/// all groups are, and its model is the union of the models of the groups. The results of the
+/// groups are cached:
+///   - a group that is a subset of a cached unsatisfiable group is unsatisfiable;
+///   - a group that is a subset of a cached satisfiable group is satisfiable, and the model of
+///     the larger group is a model of it.
+/// When a path grows by a branch condition, only the group of the new condition reaches the
+/// underlying solver. Results of queries that time out are not cached.
+///
+/// Most queries only check the feasibility of a branch, so models are fetched from the
+/// underlying solver when getModel() asks for them rather than after every query.
+class CachingSolver : public AbstractSolver {
+ public:
+    /// Queries that are not answered from the cache are sent to @a solver.
+    explicit CachingSolver(AbstractSolver &solver);
+
+    void comment(cstring comment) override;
+
+    /// Also clears the cache, so that later models follow the new seed.
+    void seed(unsigned seed) override;
+
+    void timeout(unsigned tm) override;
+
+    std::optional<bool> checkSat(const std::vector<const Constraint *> &asserts) override;
+
+    const Model *getModel() const override;
+
+    void toJSON(JSONGenerator & /*json*/) const override;
+
+    bool isInIncrementalMode() const override;
+
+    /// @returns the number of groups answered from the cache, and sent to the underlying solver.
+    size_t getCacheHits() const { return cacheHits; }
+    size_t getSolverQueries() const { return solverQueries; }
+
+ private:
+    /// The assertions of a group, in increasing order of their addresses.
+    using Group = std::vector<const Constraint *>;
+
+    /// The cached result of a group. The model is null if the group is unsatisfiable or its
+    /// model has not been fetched yet.
+    struct Result {
+        bool sat;
+        const Model *model;
+    };
+
+    using Entry = std::map<Group, Result>::value_type;
+
+    /// The cache is cleared when it holds this many groups.
+    static constexpr size_t maxCacheSize = 1 << 16;
+
+    /// @returns the state variables in @a assertion.
+    const std::vector<StateVariable> &getVariables(const Constraint *assertion) const;
+
+    /// Partitions @a asserts into groups that share no state variables. The assertions of each
+    /// group are kept in the order of @a asserts.
+    std::vector<std::vector<const Constraint *>> partition(
+        const std::vector<const Constraint *> &asserts);
+
+    /// @returns the cached result for @a group, or std::nullopt.
+    std::optional<Result> lookup(const Group &group) const;
+
+    /// Caches the result of @a group.
+    void store(Group group, Result result);
+
+    /// Removes all entries from the cache.
+    void clearCache();
+
+    /// Records @a groupModel as the model of group @a index of the last query, also in the cache.
+    void setGroupModel(size_t index, const Model *groupModel) const;
+
+    /// Solves group @a index of the last query again to get a model that was not fetched when
+    /// the group was solved.
+    const Model *solveForModel(size_t index) const;
+
+    /// The underlying solver.
+    AbstractSolver &solver;
+
+    /// The results of the groups solved so far.
+    mutable std::map<Group, Result> results;
+
+    /// For each assertion, the satisfiable groups in @ref results that contain it.
+    std::unordered_map<const Constraint *, std::vector<const Entry *>> satGroupsWith;
+
+    /// For each assertion, the unsatisfiable groups in @ref results whose first assertion it is.
+    std::unordered_map<const Constraint *, std::vector<const Entry *>> unsatGroupsFrom;
+
+    /// The state variables of the assertions seen so far.
+    mutable std::unordered_map<const Constraint *, std::vector<StateVariable>> variables;
+
+    /// Whether the last query was satisfiable.
+    bool lastSat = false;
+
+    /// The groups of the last query, their keys in @ref results, and their models as far as they
+    /// have been fetched.
+    std::vector<std::vector<const Constraint *>> lastGroups;
+    std::vector<Group> lastKeys;
+    mutable std::vector<const Model *> lastModels;
+
+    /// The group of the last query whose model the underlying solver holds, if any.
+    mutable std::optional<size_t> solverModelOf;
+
+    /// The model of the last query, once it has been built.
+    mutable const Model *model = nullptr;
+
+    /// Statistics.
+    size_t cacheHits = 0;
+    mutable size_t solverQueries = 0;
+};
+
+}  // namespace P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_CORE_CACHING_SOLVER_H_ */
@@ -10,7 +10,9 @@
 #include <map>
 #include <ostream>
 #include <string>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <boost/multiprecision/cpp_int.hpp>
 
@@ -301,11 +303,46 @@ std::optional<bool> Z3Solver::checkSat(const std::vector<const Constraint *> &as
     }
 }
 
+const Z3Solver::Translation &Z3Solver::translate(const Constraint *assertion) {
+    auto it = translations.find(assertion);
+    if (it != translations.end()) {
+        // The timer only counts the hits, which are reported next to the translations.
+        Util::ScopedTimer ctHit("z3TranslationCacheHit");
+        return it->second;
+    }
+    Util::ScopedTimer ctTranslate("z3Translate");
+    // Collect the variables declared by the translation in a scope of their own.
+    declaredVarsById.emplace_back();
+    Z3Translator z3translator(*this);
+    assertion->apply(z3translator);
+    Translation translation{z3translator.getResult(), {}};
+    for (const auto &var : declaredVarsById.back()) {
+        translation.declaredVars.emplace_back(var.first, var.second);
+    }
+    declaredVarsById.pop_back();
+    if (translations.size() >= maxTranslations) {
+        // Keep the translations that checkSat is about to push again.
+        decltype(translations) kept;
+        for (const auto *asserted : p4Assertions) {
+            if (auto node = translations.extract(asserted)) kept.insert(std::move(node));
+        }
+        translations = std::move(kept);
+    }
+    return translations.emplace(assertion, std::move(translation)).first->second;
+}
+
 void Z3Solver::asrt(const Constraint *assertion) {
     try {
-        Z3Translator z3translator(*this);
-        assertion->apply(z3translator);
-        auto expr = z3translator.getResult();
+        const auto &translation = translate(assertion);
+        BUG_CHECK(
+            !declaredVarsById.empty(),
+            "DeclaredVarsById should have at least one entry! Check if push() was used correctly.");
+        // Declare the variables in the current scope, as if the assertion had been translated.
+        auto *latestVars = &declaredVarsById.back();
+        for (const auto &var : translation.declaredVars) {
+            latestVars->emplace(var.first, var.second);
+        }
+        const auto &expr = translation.expr;
 
         Z3_LOG("add assertion '%s'", toString(expr));
         if (isIncremental) {
@@ -7,6 +7,8 @@
 #include <iosfwd>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "backends/p4tools/common/core/solver.h"
@@ -74,6 +76,16 @@ class Z3Solver : public AbstractSolver {
     /// Inserts an assertion into the topmost solver context.
     void asrt(const Constraint *assertion);
 
+    /// The Z3 translation of an assertion, with the variables declared while translating it.
+    struct Translation {
+        z3::expr expr;
+        std::vector<std::pair<unsigned, StateVariable>> declaredVars;
+    };
+
+    /// @returns the translation of @a assertion, from @ref translations if it has been
+    /// translated before.
+    const Translation &translate(const Constraint *assertion);
+
     /// Converts a P4 type to a Z3 sort.
     z3::sort toSort(const IR::Type *type);
 
@@ -121,6 +133,15 @@ class Z3Solver : public AbstractSolver {
     /// @ref p4Assertions at the time the checkpoint was made.
     std::vector<size_t> checkpoints;
 
+    /// Translations of the assertions made to this solver. Entries survive pop() and reset(),
+    /// so that checkSat does not translate the path conditions that it pops and pushes again.
+    /// The keys are the assertion nodes, which path conditions share between execution states;
+    /// the map keeps them alive, so a key is never reused for another node. When the map
+    /// holds @ref maxTranslations entries, only those of the current assertions are kept.
+    std::unordered_map<const Constraint *, Translation> translations;
+
+    static constexpr size_t maxTranslations = 1 << 16;
+
     /// The Z3 counterpart to @ref p4Assertions. This is only used when @a isIncremental is false.
     z3::expr_vector z3Assertions;
 
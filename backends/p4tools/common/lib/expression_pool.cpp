@@ -0,0 +1,271 @@
+#include "backends/p4tools/common/lib/expression_pool.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <typeinfo>
+#include <unordered_set>
+
+#include <boost/multiprecision/cpp_int.hpp>
+
+#include "frontends/p4/optimizeExpressions.h"
+#include "ir/irutils.h"
+#include "ir/node.h"
+#include "ir/visitor.h"
+#include "lib/big_int_util.h"
+#include "lib/cstring.h"
+
+namespace P4Tools {
+
+namespace {
+
+/// The pool is cleared when it holds this many nodes; each shard is cleared when it holds its
+/// share of them.
+constexpr size_t MAX_POOL_SIZE = 1 << 20;
+
+/// The number of separately locked parts of the pool, so that threads which simplify at the
+/// same time rarely wait for each other.
+constexpr size_t POOL_SHARDS = 64;
+
+void combine(size_t &hash, size_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+}
+
+void combine(size_t &hash, const void *pointer) {
+    combine(hash, static_cast<size_t>(reinterpret_cast<uintptr_t>(pointer)));
+}
+
+/// Hashes the fields that IR::Node::operator== compares, for the nodes that make up symbolic
+/// expressions. Other nodes only hash their type, which is correct but makes them collide.
+/// Children are hashed by address, because they are pooled before their parents.
+struct ShallowHash {
+    size_t operator()(const IR::Node *node) const {
+        size_t hash = typeid(*node).hash_code();
+        if (const auto *path = node->to<IR::Path>()) {
+            combine(hash, std::hash<cstring>()(path->name.name));
+            return hash;
+        }
+        const auto *expr = node->checkedTo<IR::Expression>();
+        combine(hash, expr->type);
+        if (const auto *member = expr->to<IR::Member>()) {
+            combine(hash, member->expr);
+            combine(hash, std::hash<cstring>()(member->member.name));
+        } else if (const auto *unary = expr->to<IR::Operation_Unary>()) {
+            combine(hash, unary->expr);
+        } else if (const auto *binary = expr->to<IR::Operation_Binary>()) {
+            combine(hash, binary->left);
+            combine(hash, binary->right);
+        } else if (const auto *ternary = expr->to<IR::Operation_Ternary>()) {
+            combine(hash, ternary->e0);
+            combine(hash, ternary->e1);
+            combine(hash, ternary->e2);
+        } else if (const auto *constant = expr->to<IR::Constant>()) {
+            big_int magnitude = boost::multiprecision::abs(constant->value);
+            combine(hash, static_cast<size_t>(static_cast<uint64_t>(magnitude & UINT64_MAX)));
+        } else if (const auto *boolLiteral = expr->to<IR::BoolLiteral>()) {
+            combine(hash, static_cast<size_t>(boolLiteral->value));
+        } else if (const auto *pathExpr = expr->to<IR::PathExpression>()) {
+            combine(hash, pathExpr->path);
+        }
+        return hash;
+    }
+};
+
+struct ShallowEqual {
+    bool operator()(const IR::Node *left, const IR::Node *right) const { return *left == *right; }
+};
+
+struct PoolShard {
+    std::mutex mutex;
+    std::unordered_set<const IR::Node *, ShallowHash, ShallowEqual> nodes;
+};
+
+/// The pool and its counters, shared by all threads. A node goes to the shard picked by its
+/// hash, so equal nodes always meet in the same shard.
+struct Pool {
+    std::array<PoolShard, POOL_SHARDS> shards;
+    std::atomic<size_t> inputNodes{0};
+    std::atomic<size_t> pooledNodes{0};
+    std::atomic<size_t> sharedNodes{0};
+    std::atomic<size_t> rewrites{0};
+
+    void add(const ExpressionPool::Statistics &statistics) {
+        inputNodes += statistics.inputNodes;
+        pooledNodes += statistics.pooledNodes;
+        sharedNodes += statistics.sharedNodes;
+        rewrites += statistics.rewrites;
+    }
+};
+
+Pool &getPool() {
+    static Pool pool;
+    return pool;
+}
+
+/// Whether an expression contains a tainted expression.
+class HasTaint : public Inspector {
+ public:
+    bool found = false;
+
+    bool preorder(const IR::Node * /*node*/) override { return !found; }
+
+    bool preorder(const IR::TaintExpression * /*expr*/) override {
+        found = true;
+        return false;
+    }
+};
+
+bool hasTaint(const IR::Expression *expr) {
+    HasTaint hasTaint;
+    expr->apply(hasTaint);
+    return hasTaint.found;
+}
+
+/// @returns whether @a expr is the negation of @a other.
+bool isNegation(const IR::Expression *expr, const IR::Expression *other) {
+    const auto *lNot = expr->to<IR::LNot>();
+    return lNot != nullptr && lNot->expr == other;
+}
+
+/// Rewrites a && b or a || b, where @a absorbing is the value that decides the connective.
+template <class Connective>
+const IR::Expression *rewriteConnective(const Connective *expr, bool absorbing) {
+    const auto *left = expr->left;
+    const auto *right = expr->right;
+    if (left == right) {
+        return left;
+    }
+    if (isNegation(left, right) || isNegation(right, left)) {
+        return IR::getBoolLiteral(absorbing);
+    }
+    if (const auto *nested = right->template to<Connective>()) {
+        if (nested->left == left || nested->right == left) {
+            return right;
+        }
+    }
+    if (const auto *nested = left->template to<Connective>()) {
+        if (nested->left == right || nested->right == right) {
+            return left;
+        }
+    }
+    return nullptr;
+}
+
+/// @returns the rewritten @a expr, whose children are pooled, or nullptr if no rewrite applies.
+const IR::Expression *rewrite(const IR::Expression *expr) {
+    if (const auto *lAnd = expr->to<IR::LAnd>()) {
+        return rewriteConnective(lAnd, false);
+    }
+    if (const auto *lOr = expr->to<IR::LOr>()) {
+        return rewriteConnective(lOr, true);
+    }
+    if (const auto *equ = expr->to<IR::Equ>()) {
+        return equ->left == equ->right ? IR::getBoolLiteral(true) : nullptr;
+    }
+    if (const auto *neq = expr->to<IR::Neq>()) {
+        return neq->left == neq->right ? IR::getBoolLiteral(false) : nullptr;
+    }
+    if (const auto *mux = expr->to<IR::Mux>()) {
+        // The branches of a mux with the same condition as its parent always take the same side.
+        if (const auto *nested = mux->e1->to<IR::Mux>()) {
+            if (nested->e0 == mux->e0) {
+                return new IR::Mux(mux->type, mux->e0, nested->e1, mux->e2);
+            }
+        }
+        if (const auto *nested = mux->e2->to<IR::Mux>()) {
+            if (nested->e0 == mux->e0) {
+                return new IR::Mux(mux->type, mux->e0, mux->e1, nested->e2);
+            }
+        }
+        return mux->e1 == mux->e2 ? mux->e1 : nullptr;
+    }
+    return nullptr;
+}
+
+/// Rewrites and pools the nodes of an expression bottom-up. Only locks a shard of the pool
+/// while a node is looked up in it.
+class PoolExpressions : public Transform {
+    Pool &pool;
+
+    const IR::Node *intern(const IR::Node *node) {
+        auto &shard = pool.shards[ShallowHash()(node) % POOL_SHARDS];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.nodes.size() >= MAX_POOL_SIZE / POOL_SHARDS) {
+            shard.nodes.clear();
+        }
+        auto [it, inserted] = shard.nodes.insert(node);
+        if (inserted) {
+            statistics.pooledNodes++;
+        } else {
+            statistics.sharedNodes++;
+        }
+        return *it;
+    }
+
+ public:
+    /// The counters of this traversal, added to those of the pool at the end.
+    ExpressionPool::Statistics statistics;
+
+    explicit PoolExpressions(Pool &pool) : pool(pool) {}
+
+    const IR::Node *preorder(IR::Type *type) override {
+        // Types are not pooled. Expressions compare them by address.
+        prune();
+        return type;
+    }
+
+    const IR::Node *preorder(IR::Expression *expr) override {
+        statistics.inputNodes++;
+        return expr;
+    }
+
+    const IR::Node *postorder(IR::Path *path) override {
+        const IR::Path *result = path;
+        if (*path == *getOriginal()) {
+            result = getOriginal<IR::Path>();
+        }
+        return intern(result);
+    }
+
+    const IR::Node *postorder(IR::Expression *expr) override {
+        const IR::Expression *result = expr;
+        if (*expr == *getOriginal()) {
+            result = getOriginal<IR::Expression>();
+        }
+        // A rewrite either returns a pooled child or builds a node from pooled children, which
+        // may in turn be rewritten.
+        while (const auto *rewritten = rewrite(result)) {
+            if (hasTaint(result)) {
+                break;
+            }
+            statistics.rewrites++;
+            result = rewritten;
+        }
+        return intern(result);
+    }
+};
+
+}  // namespace
+
+const IR::Expression *ExpressionPool::simplify(const IR::Expression *expr) {
+    expr = P4::optimizeExpression(expr);
+    auto &pool = getPool();
+    PoolExpressions pooling(pool);
+    expr = expr->apply(pooling);
+    pool.add(pooling.statistics);
+    return expr;
+}
+
+ExpressionPool::Statistics ExpressionPool::getStatistics() {
+    const auto &pool = getPool();
+    ExpressionPool::Statistics statistics;
+    statistics.inputNodes = pool.inputNodes;
+    statistics.pooledNodes = pool.pooledNodes;
+    statistics.sharedNodes = pool.sharedNodes;
+    statistics.rewrites = pool.rewrites;
+    return statistics;
+}
+
+}  // namespace P4Tools
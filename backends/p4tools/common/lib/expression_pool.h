@@ -0,0 +1,56 @@
+#ifndef BACKENDS_P4TOOLS_COMMON_LIB_EXPRESSION_POOL_H_
+#define BACKENDS_P4TOOLS_COMMON_LIB_EXPRESSION_POOL_H_
+
+#include <cstddef>
+
+#include "ir/ir.h"
+
+namespace P4Tools {
+
+/// Hash-conses symbolic expressions: structurally equal expressions are represented by a single
+/// node. The symbolic values and path conditions of all execution states then share their common
+/// subterms, such as header validity variables and slices of the same packet variable, and
+/// caches keyed by node, like the translation cache of the Z3 solver, hit for equal expressions
+/// that were built separately.
+///
+/// Expressions are pooled bottom-up. Once the children of a node are pooled, structural equality
+/// of the node is its shallow equality (IR::Node::operator==), which compares the children by
+/// address. The pool is shared by all threads. It is split into shards that are locked
+/// separately, and a shard is cleared when it grows too large, which only loses sharing.
+class ExpressionPool {
+ public:
+    /// Counters that show how much pooling reduces the size of the expressions.
+    struct Statistics {
+        /// The number of expression nodes passed to @ref simplify. A node that occurs several
+        /// times in one expression is counted once.
+        size_t inputNodes = 0;
+
+        /// The number of nodes that were added to the pool.
+        size_t pooledNodes = 0;
+
+        /// The number of nodes that were replaced by an equal node of the pool.
+        size_t sharedNodes = 0;
+
+        /// The number of local rewrites that were applied.
+        size_t rewrites = 0;
+    };
+
+    /// Constant folds and strength reduces @a expr like P4::optimizeExpression, applies local
+    /// rewrites, and @returns the representative of the result in the pool. The rewrites rely on
+    /// pooling to compare operands by address, and on symbolic expressions being free of side
+    /// effects:
+    ///   - a && a, a || a become a; a && !a becomes false, a || !a becomes true;
+    ///   - a && (a && b) becomes a && b, and likewise for ||;
+    ///   - a == a becomes true, a != a becomes false;
+    ///   - c ? (c ? x : y) : z becomes c ? x : z, c ? x : (c ? y : z) becomes c ? x : z.
+    /// Expressions that contain taint are not rewritten, because two occurrences of a tainted
+    /// value need not be equal.
+    static const IR::Expression *simplify(const IR::Expression *expr);
+
+    /// @returns the counters of all calls to @ref simplify so far.
+    static Statistics getStatistics();
+};
+
+}  // namespace P4Tools
+
+#endif /* BACKENDS_P4TOOLS_COMMON_LIB_EXPRESSION_POOL_H_ */
@@ -57,6 +57,13 @@ void Model::complete(const std::set<StateVariable> &inputSet) {
     }
 }
 
+void Model::complete(const persistent_set<StateVariable> &inputSet) {
+    auto completionVisitor = CompleteVisitor(this);
+    for (const auto &var : inputSet) {
+        var->apply(completionVisitor);
+    }
+}
+
 void Model::complete(const SymbolicMapType &inputMap) {
     for (const auto &inputTuple : inputMap) {
         const auto *expr = inputTuple.second;
@@ -64,6 +71,13 @@ void Model::complete(const SymbolicMapType &inputMap) {
     }
 }
 
+void Model::complete(const PersistentSymbolicMapType &inputMap) {
+    for (const auto &inputTuple : inputMap) {
+        const auto *expr = inputTuple.second;
+        expr->apply(CompleteVisitor(this));
+    }
+}
+
 const IR::StructExpression *Model::evaluateStructExpr(const IR::StructExpression *structExpr,
                                                       ExpressionMap *resolvedExpressions) const {
     auto *resolvedStructExpr =
@@ -140,6 +154,17 @@ Model *Model::evaluate(const SymbolicMapType &inputMap, ExpressionMap *resolvedE
     return result;
 }
 
+Model *Model::evaluate(const PersistentSymbolicMapType &inputMap,
+                       ExpressionMap *resolvedExpressions) const {
+    auto *result = new Model(*this);
+    for (const auto &inputTuple : inputMap) {
+        auto name = inputTuple.first;
+        const auto *expr = inputTuple.second;
+        (*result)[name] = evaluate(expr, resolvedExpressions);
+    }
+    return result;
+}
+
 const IR::Expression *Model::get(const StateVariable &var, bool checked) const {
     auto it = find(var);
     if (it != end()) {
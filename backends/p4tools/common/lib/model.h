@@ -9,12 +9,17 @@
 
 #include "backends/p4tools/common/lib/formulae.h"
 #include "ir/ir.h"
+#include "lib/persistent_map.h"
 
 namespace P4Tools {
 
 /// Symbolic maps map a state variable to a IR::Expression.
 using SymbolicMapType = boost::container::flat_map<StateVariable, const IR::Expression *>;
 
+/// A symbolic map whose copies share structure. Used where maps are copied much more often than
+/// they are changed, like the symbolic environment of an execution state.
+using PersistentSymbolicMapType = persistent_map<StateVariable, const IR::Expression *>;
+
 /// Represents a solution found by the solver. A model is a concretized form of a symbolic
 /// environment. All the expressions in a Model must be of type IR::Literal.
 class Model : public SymbolicMapType {
@@ -31,10 +36,12 @@ class Model : public SymbolicMapType {
     /// be completed if it is not present in the model computed by the solver that produced the
     /// model. This typically happens when a variable is not needed to solve a set of constraints.
     void complete(const SymbolicMapType &inputMap);
+    void complete(const PersistentSymbolicMapType &inputMap);
 
     /// Adds the given set of variables to the model (if they do not exist already).
     /// If the variable does not exist, it is initialized to a default value.
     void complete(const std::set<StateVariable> &inputSet);
+    void complete(const persistent_set<StateVariable> &inputSet);
 
     /// Evaluates a P4 expression in the context of this model.
     ///
@@ -79,6 +86,8 @@ class Model : public SymbolicMapType {
     /// expression.
     Model *evaluate(const SymbolicMapType &inputMap,
                     ExpressionMap *resolvedExpressions = nullptr) const;
+    Model *evaluate(const PersistentSymbolicMapType &inputMap,
+                    ExpressionMap *resolvedExpressions = nullptr) const;
 
     /// Tries to retrieve @param var from the model.
     /// If @param checked is true, this function throws a BUG if the variable can not be found.
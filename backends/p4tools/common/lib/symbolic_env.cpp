@@ -7,10 +7,10 @@
 
 #include <boost/container/vector.hpp>
 
+#include "backends/p4tools/common/lib/expression_pool.h"
 #include "backends/p4tools/common/lib/formulae.h"
 #include "backends/p4tools/common/lib/model.h"
 #include "backends/p4tools/common/lib/zombie.h"
-#include "frontends/p4/optimizeExpressions.h"
 #include "ir/indexed_vector.h"
 #include "ir/vector.h"
 #include "ir/visitor.h"
@@ -30,7 +30,7 @@ const IR::Expression *SymbolicEnv::get(const StateVariable &var) const {
 bool SymbolicEnv::exists(const StateVariable &var) const { return map.find(var) != map.end(); }
 
 void SymbolicEnv::set(const StateVariable &var, const IR::Expression *value) {
-    map[var] = P4::optimizeExpression(value);
+    map.insert_or_assign(var, ExpressionPool::simplify(value));
 }
 
 Model *SymbolicEnv::complete(const Model &model) const {
@@ -72,7 +72,7 @@ const IR::Expression *SymbolicEnv::subst(const IR::Expression *expr) const {
     return expr->apply(SubstVisitor(*this));
 }
 
-const SymbolicMapType &SymbolicEnv::getInternalMap() const { return map; }
+const PersistentSymbolicMapType &SymbolicEnv::getInternalMap() const { return map; }
 
 bool SymbolicEnv::isSymbolicValue(const IR::Node *node) {
     // Parser states are symbolic values.
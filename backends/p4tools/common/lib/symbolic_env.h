@@ -12,7 +12,9 @@ namespace P4Tools {
 /// expression on the program's initial state.
 class SymbolicEnv {
  private:
-    SymbolicMapType map;
+    /// Execution states copy their environment on every branch, so the map shares structure
+    /// with the environments it was copied from.
+    PersistentSymbolicMapType map;
 
  public:
     // Maybe coerce from Model for concrete execution?
@@ -23,8 +25,8 @@ class SymbolicEnv {
     /// Checks whether the given variable exists in the symbolic environment.
     bool exists(const StateVariable &var) const;
 
-    /// Sets the symbolic value of the given state variable to the given value. Constant folding is
-    /// done on the given value before updating the symbolic state.
+    /// Sets the symbolic value of the given state variable to the given value. The value is
+    /// simplified and pooled with ExpressionPool::simplify before updating the symbolic state.
     void set(const StateVariable &var, const IR::Expression *value);
 
     /// Completes the model with all variables referenced in the symbolic environment.
@@ -41,7 +43,7 @@ class SymbolicEnv {
     const IR::Expression *subst(const IR::Expression *expr) const;
 
     /// @returns The immutable map that is internal to this symbolic environment.
-    const SymbolicMapType &getInternalMap() const;
+    const PersistentSymbolicMapType &getInternalMap() const;
 
     /// Determines whether the given node represents a symbolic value. Symbolic values may be
     /// stored in the symbolic environment.
@@ -26,7 +26,8 @@ const IR::StringLiteral Taint::TAINTED_STRING_LITERAL = IR::StringLiteral(cstrin
 
 /// Returns a bitmask that indicates which bits of given expression are tainted given a complex
 /// expression.
-static bitvec computeTaintedBits(const SymbolicMapType &varMap, const IR::Expression *expr) {
+template <class SymbolicMap>
+static bitvec computeTaintedBits(const SymbolicMap &varMap, const IR::Expression *expr) {
     CHECK_NULL(expr);
     if (const auto *member = expr->to<IR::Member>()) {
         if (SymbolicEnv::isSymbolicValue(member)) {
@@ -95,19 +96,20 @@ static bitvec computeTaintedBits(const SymbolicMapType &varMap, const IR::Expres
     BUG("Taint pair collection is unsupported for %1% of type %2%", expr, expr->node_type_name());
 }
 
-bool Taint::hasTaint(const SymbolicMapType &varMap, const IR::Expression *expr) {
+template <class SymbolicMap>
+static bool hasTaintImpl(const SymbolicMap &varMap, const IR::Expression *expr) {
     if (expr->is<IR::TaintExpression>()) {
         return true;
     }
     if (const auto *member = expr->to<IR::Member>()) {
         if (!SymbolicEnv::isSymbolicValue(member)) {
-            return hasTaint(varMap, varMap.at(member));
+            return hasTaintImpl(varMap, varMap.at(member));
         }
         return false;
     }
     if (const auto *structExpr = expr->to<IR::StructExpression>()) {
         for (const auto *subExpr : structExpr->components) {
-            if (hasTaint(varMap, subExpr->expression)) {
+            if (hasTaintImpl(varMap, subExpr->expression)) {
                 return true;
             }
         }
@@ -115,17 +117,17 @@ bool Taint::hasTaint(const SymbolicMapType &varMap, const IR::Expression *expr)
     }
     if (const auto *listExpr = expr->to<IR::ListExpression>()) {
         for (const auto *subExpr : listExpr->components) {
-            if (hasTaint(varMap, subExpr)) {
+            if (hasTaintImpl(varMap, subExpr)) {
                 return true;
             }
         }
         return false;
     }
     if (const auto *binaryExpr = expr->to<IR::Operation_Binary>()) {
-        return hasTaint(varMap, binaryExpr->left) || hasTaint(varMap, binaryExpr->right);
+        return hasTaintImpl(varMap, binaryExpr->left) || hasTaintImpl(varMap, binaryExpr->right);
     }
     if (const auto *unaryExpr = expr->to<IR::Operation_Unary>()) {
-        return hasTaint(varMap, unaryExpr->expr);
+        return hasTaintImpl(varMap, unaryExpr->expr);
     }
     if (expr->is<IR::Literal>()) {
         return false;
@@ -145,8 +147,21 @@ bool Taint::hasTaint(const SymbolicMapType &varMap, const IR::Expression *expr)
     BUG("Taint checking is unsupported for %1% of type %2%", expr, expr->node_type_name());
 }
 
+bool Taint::hasTaint(const SymbolicMapType &varMap, const IR::Expression *expr) {
+    return hasTaintImpl(varMap, expr);
+}
+
+template <class PersistentMap>
+bool Taint::hasTaint(const PersistentMap &varMap, const IR::Expression *expr) {
+    return hasTaintImpl(varMap, expr);
+}
+
+template bool Taint::hasTaint(const PersistentSymbolicMapType &varMap,
+                              const IR::Expression *expr);
+
+template <class SymbolicMap>
 class TaintPropagator : public Transform {
-    const SymbolicMapType &varMap;
+    const SymbolicMap &varMap;
 
     const IR::Node *postorder(IR::Expression *node) override {
         P4C_UNIMPLEMENTED("Taint transformation not supported for node %1% of type %2%", node,
@@ -225,7 +240,7 @@ class TaintPropagator : public Transform {
     }
 
  public:
-    explicit TaintPropagator(const SymbolicMapType &varMap) : varMap(varMap) {
+    explicit TaintPropagator(const SymbolicMap &varMap) : varMap(varMap) {
         visitDagOnce = false;
     }
 };
@@ -257,19 +272,37 @@ class MaskBuilder : public Transform {
     MaskBuilder() { visitDagOnce = false; }
 };
 
-const IR::Literal *Taint::buildTaintMask(const SymbolicMapType &varMap, const Model *completedModel,
-                                         const IR::Expression *programPacket) {
+template <class SymbolicMap>
+static const IR::Literal *buildTaintMaskImpl(const SymbolicMap &varMap,
+                                             const Model *completedModel,
+                                             const IR::Expression *programPacket) {
     // First propagate taint and simplify the packet.
-    const auto *taintedPacket = programPacket->apply(TaintPropagator(varMap));
+    const auto *taintedPacket = programPacket->apply(TaintPropagator<SymbolicMap>(varMap));
     // Then create the mask based on the remaining expressions.
     const auto *mask = taintedPacket->apply(MaskBuilder());
     // Produce the evaluated literal. The hex expression should only have 0 or f.
     return completedModel->evaluate(mask);
 }
 
+const IR::Literal *Taint::buildTaintMask(const SymbolicMapType &varMap, const Model *completedModel,
+                                         const IR::Expression *programPacket) {
+    return buildTaintMaskImpl(varMap, completedModel, programPacket);
+}
+
+const IR::Literal *Taint::buildTaintMask(const PersistentSymbolicMapType &varMap,
+                                         const Model *completedModel,
+                                         const IR::Expression *programPacket) {
+    return buildTaintMaskImpl(varMap, completedModel, programPacket);
+}
+
 const IR::Expression *Taint::propagateTaint(const SymbolicMapType &varMap,
                                             const IR::Expression *expr) {
-    return expr->apply(TaintPropagator(varMap));
+    return expr->apply(TaintPropagator<SymbolicMapType>(varMap));
+}
+
+const IR::Expression *Taint::propagateTaint(const PersistentSymbolicMapType &varMap,
+                                            const IR::Expression *expr) {
+    return expr->apply(TaintPropagator<PersistentSymbolicMapType>(varMap));
 }
 
 const IR::Expression *buildMask(const IR::Expression *expr) { return expr->apply(MaskBuilder()); }
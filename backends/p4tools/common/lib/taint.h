@@ -16,16 +16,25 @@ class Taint {
     /// masks.
     static const IR::Expression *propagateTaint(const SymbolicMapType &varMap,
                                                 const IR::Expression *expr);
+    static const IR::Expression *propagateTaint(const PersistentSymbolicMapType &varMap,
+                                                const IR::Expression *expr);
 
     /// @returns whether the given expression is tainted. An expression is tainted if one or more
     /// bits of the expression are expected to evaluate to (possibly part of) IR::TaintExpression.
     static bool hasTaint(const SymbolicMapType &varMap, const IR::Expression *expr);
+    /// The same for a PersistentSymbolicMapType, the only type this is instantiated for. As a
+    /// template it is never picked for a braced initializer, such as hasTaint({}, expr).
+    template <class PersistentMap>
+    static bool hasTaint(const PersistentMap &varMap, const IR::Expression *expr);
 
     /// @returns the mask for the corresponding program packet, indicating bits of the expression
     /// which are not tainted.
     static const IR::Literal *buildTaintMask(const SymbolicMapType &varMap,
                                              const Model *completedModel,
                                              const IR::Expression *programPacket);
+    static const IR::Literal *buildTaintMask(const PersistentSymbolicMapType &varMap,
+                                             const Model *completedModel,
+                                             const IR::Expression *programPacket);
 };
 
 }  // namespace P4Tools
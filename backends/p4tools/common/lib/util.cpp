@@ -7,6 +7,7 @@
 #include <ctime>
 #include <iomanip>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <ratio>
 #include <tuple>
@@ -32,7 +33,7 @@ namespace P4Tools {
 
 std::optional<uint32_t> Utils::currentSeed = std::nullopt;
 
-boost::random::mt19937 Utils::rng(0);
+thread_local boost::random::mt19937 Utils::rng(0);
 
 std::string Utils::getTimeStamp() {
     // get current time
@@ -61,6 +62,12 @@ void Utils::setRandomSeed(int seed) {
 
 std::optional<uint32_t> Utils::getCurrentSeed() { return currentSeed; }
 
+void Utils::seedThread(uint32_t offset) {
+    if (currentSeed) {
+        rng.seed(*currentSeed + offset);
+    }
+}
+
 uint64_t Utils::getRandInt(uint64_t max) {
     if (!currentSeed) {
         return 0;
@@ -145,6 +152,8 @@ const IR::TaintExpression *Utils::getTaintExpression(const IR::Type *type) {
     // type.
     using key_t = std::tuple<int, bool>;
     static std::map<key_t, const IR::TaintExpression *> taints;
+    static std::mutex lock;
+    std::lock_guard<std::mutex> guard(lock);
 
     auto *&result = taints[{tb->width_bits(), tb->isSigned}];
     if (result == nullptr) {
@@ -49,8 +49,9 @@ class Utils {
      *  Seeds, timestamps, randomness.
      * ========================================================================================= */
  private:
-    /// The random generator of this project. It is initialized with the input seed.
-    static boost::random::mt19937 rng;
+    /// The random generator of this project. It is initialized with the input seed. Each thread
+    /// has its own generator, see @ref seedThread.
+    static thread_local boost::random::mt19937 rng;
 
     /// Stores the state of the PRNG.
     static std::optional<uint32_t> currentSeed;
@@ -68,6 +69,10 @@ class Utils {
     /// @returns currentSeed.
     static std::optional<uint32_t> getCurrentSeed();
 
+    /// Seeds the random generator of the calling thread with currentSeed + @param offset, so that
+    /// threads exploring in parallel draw different numbers. Does nothing if no seed is set.
+    static void seedThread(uint32_t offset);
+
     /// @returns a random integer in the range [0, @param max]. Always return 0 if no seed is set.
     static uint64_t getRandInt(uint64_t max);
 
@@ -1,6 +1,7 @@
 #include "backends/p4tools/common/lib/zombie.h"
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 
@@ -52,6 +53,8 @@ const StateVariable *Zombie::mkZombie(const IR::Type *type, bool isConst, int in
 
     using key_t = std::pair<bool, int>;
     static std::map<key_t, const IR::Member *> incarnations;
+    static std::mutex lock;
+    std::unique_lock<std::mutex> guard(lock);
     const auto *&incarnationMember = incarnations[std::make_pair(isConst, incarnation)];
     if (incarnationMember == nullptr) {
         const IR::Expression *hdr = &zombieHdr;
@@ -60,6 +63,7 @@ const StateVariable *Zombie::mkZombie(const IR::Type *type, bool isConst, int in
         }
         incarnationMember = new IR::Member(hdr, cstring(std::to_string(incarnation)));
     }
+    guard.unlock();
 
     return new StateVariable(new IR::Member(type, incarnationMember, name));
 }
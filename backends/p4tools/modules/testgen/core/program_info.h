@@ -52,8 +52,8 @@ class ProgramInfo : public ICastable {
     /// The P4 program from which this object is derived.
     const IR::P4Program *program;
 
-    /// The generated dcg.
-    const NodesCallGraph *dcg;
+    /// The generated dcg. Only built if --dcg or --pattern is set, nullptr otherwise.
+    const NodesCallGraph *dcg = nullptr;
 
     /// @returns the series of nodes that has been computed by this particular target.
     const std::vector<Continuation::Command> *getPipelineSequence() const;
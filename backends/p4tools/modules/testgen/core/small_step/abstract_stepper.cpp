@@ -8,11 +8,11 @@
 
 #include "backends/p4tools/common/compiler/convert_hs_index.h"
 #include "backends/p4tools/common/core/solver.h"
+#include "backends/p4tools/common/lib/expression_pool.h"
 #include "backends/p4tools/common/lib/formulae.h"
 #include "backends/p4tools/common/lib/model.h"
 #include "backends/p4tools/common/lib/symbolic_env.h"
 #include "backends/p4tools/common/lib/util.h"
-#include "frontends/p4/optimizeExpressions.h"
 #include "ir/dump.h"
 #include "ir/id.h"
 #include "ir/indexed_vector.h"
@@ -329,9 +329,9 @@ const Value *AbstractStepper::evaluateExpression(const IR::Expression *expr,
                                                  std::optional<const IR::Expression *> cond) const {
     BUG_CHECK(solver.isInIncrementalMode(),
               "Currently, expression valuation only supports an incremental solver.");
-    auto constraints = state.getPathConstraint();
+    auto constraints = state.getPathConstraint().to_vector();
     expr = state.getSymbolicEnv().subst(expr);
-    expr = P4::optimizeExpression(expr);
+    expr = ExpressionPool::simplify(expr);
     // Assert the path constraint to the solver and check whether it is satisfiable.
     if (cond) {
         constraints.push_back(*cond);
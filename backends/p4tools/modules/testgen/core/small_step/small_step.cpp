@@ -9,9 +9,9 @@
 
 #include "backends/p4tools/common/compiler/reachability.h"
 #include "backends/p4tools/common/core/solver.h"
+#include "backends/p4tools/common/lib/expression_pool.h"
 #include "backends/p4tools/common/lib/symbolic_env.h"
 #include "backends/p4tools/common/lib/trace_event.h"
-#include "frontends/p4/optimizeExpressions.h"
 #include "ir/ir.h"
 #include "ir/irutils.h"
 #include "ir/node.h"
@@ -40,7 +40,7 @@ SmallStepEvaluator::Branch::Branch(std::optional<const Constraint *> c,
         // Substitutes all variables to their symbolic value (expression on the program's initial
         // state).
         constraint = prevState.getSymbolicEnv().subst(*c);
-        constraint = P4::optimizeExpression(constraint);
+        constraint = ExpressionPool::simplify(constraint);
         // Append the evaluated and optimized constraint to the next execution state's list of
         // path constraints.
         nextState.pushPathConstraint(constraint);
@@ -58,7 +58,7 @@ SmallStepEvaluator::Branch::Branch(std::optional<const Constraint *> c,
         // Substitutes all variables to their symbolic value (expression on the program's initial
         // state).
         constraint = prevState.getSymbolicEnv().subst(*c);
-        constraint = P4::optimizeExpression(constraint);
+        constraint = ExpressionPool::simplify(constraint);
         // Append the evaluated and optimized constraint to the next execution state's list of
         // path constraints.
         nextState.pushPathConstraint(constraint);
@@ -201,10 +201,10 @@ class CommandVisitor {
         // If the guard condition is tainted, treat it equivalent to an invalid state.get().
         if (!state.get().hasTaint(cond)) {
             cond = state.get().getSymbolicEnv().subst(cond);
-            cond = P4::optimizeExpression(cond);
+            cond = ExpressionPool::simplify(cond);
             // Check whether the condition is satisfiable in the current execution
             // state.get().
-            auto pathConstraints = state.get().getPathConstraint();
+            auto pathConstraints = state.get().getPathConstraint().to_vector();
             pathConstraints.push_back(cond);
             solverResult = self.get().solver.checkSat(pathConstraints);
         }
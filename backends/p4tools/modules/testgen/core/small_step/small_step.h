@@ -11,6 +11,7 @@
 #include "backends/p4tools/common/core/solver.h"
 #include "backends/p4tools/common/lib/formulae.h"
 #include "ir/node.h"
+#include "lib/bitvec.h"
 #include "midend/coverage.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
@@ -33,6 +34,11 @@ class SmallStepEvaluator {
 
         P4::Coverage::CoverageSet potentialStatements;
 
+        /// The statements that may execute on this branch, numbered like the statements of the
+        /// program. Set by the symbolic executor if it has a statement reachability index and
+        /// the branch's potential statements are part of it.
+        std::optional<bitvec> reachableStatements;
+
         /// Simple branch without any constraint.
         explicit Branch(ExecutionState &nextState);
 
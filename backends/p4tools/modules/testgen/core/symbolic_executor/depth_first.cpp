@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <iterator>
+#include <utility>
 #include <vector>
 
 #include "backends/p4tools/common/core/solver.h"
@@ -39,7 +40,27 @@ bool DepthFirstSearch::pickSuccessor(StepResult successors) {
     return true;
 }
 
+std::vector<std::reference_wrapper<const ExecutionState>> DepthFirstSearch::getFrontier() const {
+    std::vector<std::reference_wrapper<const ExecutionState>> frontier;
+    for (const auto &branch : unexploredBranches) {
+        frontier.emplace_back(branch.nextState.get());
+    }
+    return frontier;
+}
+
+void DepthFirstSearch::setFrontier(std::vector<Branch> branches) {
+    unexploredBranches = std::move(branches);
+    resumed = true;
+}
+
 void DepthFirstSearch::run(const Callback &callback) {
+    if (resumed) {
+        if (unexploredBranches.empty()) {
+            return;
+        }
+        executionState = unexploredBranches.back().nextState;
+        unexploredBranches.pop_back();
+    }
     while (true) {
         try {
             if (executionState.get().isTerminal()) {
@@ -1,12 +1,14 @@
 #ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DEPTH_FIRST_H_
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_DEPTH_FIRST_H_
 
+#include <functional>
 #include <vector>
 
 #include "backends/p4tools/common/core/solver.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
 
 namespace P4Tools::P4Testgen {
 
@@ -24,7 +26,17 @@ class DepthFirstSearch : public SymbolicExecutor {
     /// Constructor for this strategy, considering inheritance
     DepthFirstSearch(AbstractSolver &solver, const ProgramInfo &programInfo);
 
+ protected:
+    [[nodiscard]] std::vector<std::reference_wrapper<const ExecutionState>> getFrontier()
+        const override;
+
+    void setFrontier(std::vector<Branch> branches) override;
+
  private:
+    /// Set when the search resumes from a checkpoint. It then starts with the unexplored
+    /// branches instead of the beginning of the program.
+    bool resumed = false;
+
     /// General unexplored branches.
     // Each element on this vector represents a set of alternative choices that could have been
     /// made along the current execution path.
@@ -25,6 +25,22 @@ GreedyStmtSelection::GreedyStmtSelection(AbstractSolver &solver, const ProgramIn
 std::optional<SymbolicExecutor::Branch> GreedyStmtSelection::popPotentialBranch(
     const P4::Coverage::CoverageSet &coveredStatements,
     std::vector<SymbolicExecutor::Branch> &candidateBranches) {
+    // Prefer the branch that can reach the most uncovered statements, if this is known.
+    std::optional<size_t> bestIdx;
+    size_t bestCount = 0;
+    for (size_t idx = 0; idx < candidateBranches.size(); ++idx) {
+        auto count = countReachableUncovered(candidateBranches[idx]);
+        if (count.has_value() && *count > bestCount) {
+            bestIdx = idx;
+            bestCount = *count;
+        }
+    }
+    if (bestIdx.has_value()) {
+        auto branch = candidateBranches.at(*bestIdx);
+        candidateBranches[*bestIdx] = candidateBranches.back();
+        candidateBranches.pop_back();
+        return branch;
+    }
     for (size_t idx = 0; idx < candidateBranches.size(); ++idx) {
         auto branch = candidateBranches.at(idx);
         // First check all the potential set of statements we can cover by looking ahead.
@@ -68,6 +84,7 @@ bool GreedyStmtSelection::pickSuccessor(StepResult successors) {
         // potential branches.
         if (branch.has_value()) {
             executionState = branch->nextState;
+            dropCoveredBranches(*successors);
             potentialBranches.insert(potentialBranches.end(), successors->begin(),
                                      successors->end());
             return true;
@@ -76,6 +93,7 @@ bool GreedyStmtSelection::pickSuccessor(StepResult successors) {
     // If we can not cover anything new, pick a branch at random.
     executionState = popRandomBranch(*successors).nextState;
     // Add the remaining tests to the unexplored branches.
+    dropCoveredBranches(*successors);
     unexploredBranches.insert(unexploredBranches.end(), successors->begin(), successors->end());
     return true;
 }
@@ -130,6 +148,11 @@ void GreedyStmtSelection::run(const Callback &callback) {
         unexploredBranches.insert(unexploredBranches.end(), potentialBranches.begin(),
                                   potentialBranches.end());
         potentialBranches.clear();
+        // Coverage may have grown since these branches were created.
+        dropCoveredBranches(unexploredBranches);
+        if (unexploredBranches.empty()) {
+            return;
+        }
         // If we did not find any new statements, fall back to random.
         executionState = popRandomBranch(unexploredBranches).nextState;
     }
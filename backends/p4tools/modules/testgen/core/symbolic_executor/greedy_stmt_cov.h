@@ -18,9 +18,11 @@ namespace P4Tools::P4Testgen {
 /// Potential statements are computed using the CollectLatentStatements visitor, which collects
 /// statements in the top-level statement of the execution state. These statements are latent
 /// because execution is not guaranteed. They may be guarded by an if condition or select
-/// expression. If the strategy does not find a new statement, it falls back to
-/// random. Similarly, if the strategy cycles without a test for a specific threshold, it will
-/// fall back to random. This is to prevent getting caught in a parser cycle.
+/// expression. If the program has a DCG, the strategy picks the branch that can reach the most
+/// uncovered statements instead, and drops branches that can not reach any. If the strategy
+/// does not find a new statement, it falls back to random. Similarly, if the strategy cycles
+/// without a test for a specific threshold, it will fall back to random. This is to prevent
+/// getting caught in a parser cycle.
 class GreedyStmtSelection : public SymbolicExecutor {
  public:
     /// Executes the P4 program along a randomly chosen path. When the program terminates, the
@@ -61,10 +63,11 @@ class GreedyStmtSelection : public SymbolicExecutor {
     std::vector<Branch> unexploredBranches;
 
     /// Iterate over all the input branches in @param candidateBranches and try to find a branch
-    /// which contains statements that are not in @param coveredStatements yet. Return the first
-    /// branch that was found and remove that branch from the container of @param candidateBranches.
+    /// which contains statements that are not in @param coveredStatements yet. Return the branch
+    /// that can reach the most uncovered statements or, if that is not known, the first branch
+    /// that was found and remove that branch from the container of @param candidateBranches.
     /// Return none, if no branch was found.
-    static std::optional<SymbolicExecutor::Branch> popPotentialBranch(
+    std::optional<SymbolicExecutor::Branch> popPotentialBranch(
         const P4::Coverage::CoverageSet &coveredStatements,
         std::vector<SymbolicExecutor::Branch> &candidateBranches);
 
@@ -95,6 +95,10 @@ void RandomMaxStmtCoverage::run(const Callback &callback) {
                         sortBranchesByCoverage(localBranches);
                     }
                     unexploredBranches.clear();
+                    // All branches may have been dropped.
+                    if (bufferUnexploredBranches.empty()) {
+                        continue;
+                    }
                     // We set the coverage counter to the saddle point,
                     // so we can combine it with random exploration.
                     uint64_t coverage = visitedStatements.size();
@@ -115,6 +119,10 @@ void RandomMaxStmtCoverage::run(const Callback &callback) {
                         sortBranchesByCoverage(localBranches);
                     }
                     unexploredBranches.clear();
+                    // All branches may have been dropped.
+                    if (bufferUnexploredBranches.empty()) {
+                        continue;
+                    }
                     auto successorsKey = getRandomUnexploredMapEntry();
                     auto successors = bufferUnexploredBranches.at(successorsKey);
                     // Remove the map entry accordingly.
@@ -166,13 +174,22 @@ void RandomMaxStmtCoverage::updateBufferRankings() {
 void RandomMaxStmtCoverage::sortBranchesByCoverage(std::vector<Branch> &branches) {
     // Transfers branches to rankedBranches and sorts them by coverage
     for (const auto &localBranch : branches) {
-        // Calculate coverage for each branch:
+        // Branches that can not cover new statements are not explored any further.
+        if (cannotCoverNewStatements(localBranch)) {
+            continue;
+        }
+        // Calculate coverage for each branch. Prefer the uncovered statements the branch can
+        // reach, if they are known.
         uint64_t lookAheadCoverage = 0;
-        for (const auto &stmt : localBranch.potentialStatements) {
-            // We need to take into account the set of visitedStatements.
-            // We also need to ensure the statement is in allStatements.
-            if (visitedStatements.count(stmt) == 0U && stmt->getSourceInfo().isValid()) {
-                lookAheadCoverage++;
+        if (auto reachableCount = countReachableUncovered(localBranch)) {
+            lookAheadCoverage = *reachableCount;
+        } else {
+            for (const auto &stmt : localBranch.potentialStatements) {
+                // We need to take into account the set of visitedStatements.
+                // We also need to ensure the statement is in allStatements.
+                if (visitedStatements.count(stmt) == 0U && stmt->getSourceInfo().isValid()) {
+                    lookAheadCoverage++;
+                }
             }
         }
         auto coverage = lookAheadCoverage + visitedStatements.size();
@@ -218,7 +235,8 @@ ExecutionState *RandomMaxStmtCoverage::chooseBranch(std::vector<Branch> &branche
 
         if (guaranteeViability) {
             // Check the consistency of the path constraints asserted so far.
-            auto solverResult = solver.checkSat(branch.nextState.get().getPathConstraint());
+            auto solverResult =
+                solver.checkSat(branch.nextState.get().getPathConstraint().to_vector());
             if (solverResult == std::nullopt) {
                 ::warning("Solver timed out");
             }
@@ -0,0 +1,226 @@
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/parallel_depth_first.h"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include "backends/p4tools/common/core/caching_solver.h"
+#include "backends/p4tools/common/core/solver.h"
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/util.h"
+#include "lib/error.h"
+#include "lib/exceptions.h"
+#include "lib/gc.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/small_step/small_step.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/exceptions.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+#include "backends/p4tools/modules/testgen/lib/final_state.h"
+#include "backends/p4tools/modules/testgen/options.h"
+
+namespace P4Tools::P4Testgen {
+
+/// A worker owns a solver and an evaluator, which are not shared with other threads, and a stack
+/// of unexplored branches, which other workers may steal from.
+struct ParallelDepthFirstSearch::Worker {
+    Z3Solver z3Solver;
+
+    CachingSolver cachingSolver;
+
+    AbstractSolver &solver;
+
+    SmallStepEvaluator evaluator;
+
+    /// Guards @ref branches.
+    std::mutex lock;
+
+    /// The unexplored branches of this worker. The worker takes branches from the back, thieves
+    /// take them from the front.
+    std::deque<Branch> branches;
+
+    explicit Worker(const ProgramInfo &programInfo)
+        : cachingSolver(z3Solver),
+          solver(TestgenOptions::get().solverCache ? static_cast<AbstractSolver &>(cachingSolver)
+                                                   : z3Solver),
+          evaluator(solver, programInfo) {}
+
+    /// Takes one step from @a state and returns the satisfiable successors.
+    StepResult step(ExecutionState &state) {
+        StepResult successors = evaluator.step(state);
+        successors->erase(std::remove_if(successors->begin(), successors->end(),
+                                         [this](const Branch &b) -> bool {
+                                             return !evaluateBranch(b, solver);
+                                         }),
+                          successors->end());
+        return successors;
+    }
+};
+
+ParallelDepthFirstSearch::ParallelDepthFirstSearch(AbstractSolver &solver,
+                                                   const ProgramInfo &programInfo,
+                                                   unsigned workers)
+    : SymbolicExecutor(solver, programInfo) {
+    BUG_CHECK(workers > 0, "Parallel exploration needs at least one worker.");
+    auto seed = Utils::getCurrentSeed();
+    for (unsigned i = 0; i < workers; i++) {
+        this->workers.emplace_back(new Worker(programInfo));
+        if (seed != std::nullopt) {
+            this->workers.back()->solver.seed(*seed + i);
+        }
+    }
+}
+
+ParallelDepthFirstSearch::~ParallelDepthFirstSearch() = default;
+
+void ParallelDepthFirstSearch::run(const Callback &callback) {
+    pushBranch(*workers.front(), Branch(executionState.get()));
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers.size(); i++) {
+        threads.emplace_back([this, i, &callback]() {
+            GCThreadScope gcThread;
+            Utils::seedThread(i);
+            work(*workers[i], callback);
+        });
+    }
+    work(*workers.front(), callback);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void ParallelDepthFirstSearch::work(Worker &self, const Callback &callback) {
+    while (!done) {
+        auto branch = popBranch(self);
+        if (!branch) {
+            std::unique_lock<std::mutex> lock(idleLock);
+            wakeUp.wait(lock, [this]() { return done || pending == 0 || queued > 0; });
+            if (pending == 0) {
+                return;
+            }
+            continue;
+        }
+        try {
+            explore(self, branch->nextState, callback);
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(idleLock);
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+            }
+            stop();
+        }
+        if (--pending == 0) {
+            std::lock_guard<std::mutex> lock(idleLock);
+            wakeUp.notify_all();
+        }
+    }
+}
+
+void ParallelDepthFirstSearch::explore(Worker &self, ExecutionState &state,
+                                       const Callback &callback) {
+    std::reference_wrapper<ExecutionState> current = state;
+    while (!done) {
+        try {
+            if (current.get().isTerminal()) {
+                // We've reached the end of the program. Call back and (if desired) end execution.
+                if (handleTerminal(self, current, callback)) {
+                    stop();
+                }
+                return;
+            }
+            // Take a step in the program and continue on a random successor. The other
+            // successors are left for this worker to backtrack to, or for other workers to
+            // steal.
+            StepResult successors = self.step(current);
+            if (successors->empty()) {
+                return;
+            }
+            current = popRandomBranch(*successors).nextState;
+            for (auto &branch : *successors) {
+                pushBranch(self, std::move(branch));
+            }
+        } catch (TestgenUnimplemented &e) {
+            // If strict is enabled, bubble the exception up.
+            if (TestgenOptions::get().strict) {
+                throw;
+            }
+            // Otherwise we abandon this path and continue with another branch.
+            ::warning("Path encountered unimplemented feature. Message: %1%\n", e.what());
+            return;
+        }
+    }
+}
+
+bool ParallelDepthFirstSearch::handleTerminal(Worker &self, const ExecutionState &state,
+                                              const Callback &callback) {
+    // Check the solver for satisfiability. If it times out or reports non-satisfiability, issue
+    // a warning and continue on a different path.
+    auto solverResult = self.solver.checkSat(state.getPathConstraint().to_vector());
+    if (!solverResult) {
+        ::warning("Solver timed out");
+        return false;
+    }
+    if (!*solverResult) {
+        ::warning("Path constraints unsatisfiable");
+        return false;
+    }
+
+    const FinalState finalState(self.solver, state);
+    std::lock_guard<std::mutex> lock(callbackLock);
+    if (done) {
+        return true;
+    }
+    return callback(finalState);
+}
+
+std::optional<SymbolicExecutor::Branch> ParallelDepthFirstSearch::popBranch(Worker &self) {
+    {
+        std::lock_guard<std::mutex> lock(self.lock);
+        if (!self.branches.empty()) {
+            auto branch = std::move(self.branches.back());
+            self.branches.pop_back();
+            queued--;
+            return branch;
+        }
+    }
+    for (auto &other : workers) {
+        if (other.get() == &self) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(other->lock);
+        if (!other->branches.empty()) {
+            auto branch = std::move(other->branches.front());
+            other->branches.pop_front();
+            queued--;
+            return branch;
+        }
+    }
+    return std::nullopt;
+}
+
+void ParallelDepthFirstSearch::pushBranch(Worker &self, Branch branch) {
+    pending++;
+    {
+        std::lock_guard<std::mutex> lock(self.lock);
+        self.branches.push_back(std::move(branch));
+    }
+    queued++;
+    std::lock_guard<std::mutex> lock(idleLock);
+    wakeUp.notify_one();
+}
+
+void ParallelDepthFirstSearch::stop() {
+    done = true;
+    std::lock_guard<std::mutex> lock(idleLock);
+    wakeUp.notify_all();
+}
+
+}  // namespace P4Tools::P4Testgen
@@ -0,0 +1,88 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "backends/p4tools/common/core/solver.h"
+
+#include "backends/p4tools/modules/testgen/core/program_info.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
+#include "backends/p4tools/modules/testgen/lib/execution_state.h"
+
+namespace P4Tools::P4Testgen {
+
+/// A depth-first traversal strategy that explores the program on several threads.
+/// Each worker follows a path like DepthFirstSearch and keeps the branches it did not take in its
+/// own stack. A worker that runs out of branches steals the oldest branch of another worker, which
+/// is the one closest to the start of the program and so likely the largest unexplored subtree.
+/// Each worker has its own solver and Z3 context. Terminal states are handed to the callback one
+/// at a time, so the test back end and the set of visited statements need no locking of their own.
+class ParallelDepthFirstSearch : public SymbolicExecutor {
+ public:
+    /// Explores the P4 program until all paths have been explored or the callback returns true.
+    /// Rethrows the first exception thrown by a worker.
+    void run(const Callback &callBack) override;
+
+    /// Explores the program with @a workers threads. The workers do not use @a solver.
+    ParallelDepthFirstSearch(AbstractSolver &solver, const ProgramInfo &programInfo,
+                             unsigned workers);
+
+    ~ParallelDepthFirstSearch() override;
+
+ private:
+    struct Worker;
+
+    /// Runs @a self until all branches have been explored or exploration was stopped.
+    void work(Worker &self, const Callback &callback);
+
+    /// Follows the path from @a state until it ends. Branches not taken are pushed onto the stack
+    /// of @a self.
+    void explore(Worker &self, ExecutionState &state, const Callback &callback);
+
+    /// Checks the terminal state @a state with the solver of @a self and passes it to
+    /// @a callback. @returns true if exploration should stop.
+    bool handleTerminal(Worker &self, const ExecutionState &state, const Callback &callback);
+
+    /// Takes the most recent branch of @a self, or else the oldest branch of another worker.
+    std::optional<Branch> popBranch(Worker &self);
+
+    /// Pushes @a branch onto the stack of @a self and wakes an idle worker.
+    void pushBranch(Worker &self, Branch branch);
+
+    /// Stops all workers.
+    void stop();
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /// The number of branches in the stacks of the workers plus the number of paths being
+    /// explored. Exploration is complete when this is zero.
+    std::atomic<size_t> pending{0};
+
+    /// The number of branches in the stacks of the workers.
+    std::atomic<size_t> queued{0};
+
+    /// Set when a callback asks to stop, or a worker failed.
+    std::atomic<bool> done{false};
+
+    /// Idle workers wait on @ref wakeUp until there are branches to steal or exploration is
+    /// complete.
+    std::mutex idleLock;
+    std::condition_variable wakeUp;
+
+    /// Serializes the callbacks.
+    std::mutex callbackLock;
+
+    /// The first exception thrown by a worker.
+    std::exception_ptr failure;
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_PARALLEL_DEPTH_FIRST_H_ */
@@ -17,14 +17,9 @@ namespace P4Tools::P4Testgen {
 
 void SelectedBranches::run(const Callback &callback) {
     while (!executionState.get().isTerminal()) {
+        // Branching steps assign branch ids to the successors, which the selected branches refer
+        // to.
         StepResult successors = step(executionState);
-        // Assign branch ids to the branches. These integer branch ids are used by track-branches
-        // and selected (input) branches features.
-        // Also populates exploredBranches from the initial set of branches.
-        for (uint64_t bIdx = 0; bIdx < successors->size(); ++bIdx) {
-            auto &succ = (*successors)[bIdx];
-            succ.nextState.get().pushBranchDecision(bIdx + 1);
-        }
         if (successors->size() == 1) {
             // Non-branching states are not recorded by selected branches.
             executionState = (*successors)[0].nextState;
@@ -3,19 +3,25 @@
 #include <algorithm>
 #include <fstream>
 #include <iterator>
+#include <map>
+#include <numeric>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "backends/p4tools/common/core/solver.h"
 #include "backends/p4tools/common/lib/util.h"
 #include "ir/ir.h"
 #include "lib/error.h"
+#include "lib/exceptions.h"
 #include "lib/timer.h"
 #include "midend/coverage.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/small_step/small_step.h"
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
+#include "backends/p4tools/modules/testgen/lib/exceptions.h"
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 #include "backends/p4tools/modules/testgen/lib/final_state.h"
 #include "backends/p4tools/modules/testgen/lib/logging.h"
@@ -30,14 +36,81 @@ SymbolicExecutor::StepResult SymbolicExecutor::step(ExecutionState &state) {
         std::remove_if(successors->begin(), successors->end(),
                        [this](const Branch &b) -> bool { return !evaluateBranch(b, solver); }),
         successors->end());
+    if (successors->size() > 1) {
+        for (uint64_t bIdx = 0; bIdx < successors->size(); ++bIdx) {
+            (*successors)[bIdx].nextState.get().pushBranchDecision(bIdx + 1);
+            if (reachability) {
+                setReachableStatements((*successors)[bIdx]);
+            }
+        }
+    }
     return successors;
 }
 
+void SymbolicExecutor::setReachableStatements(Branch &branch) const {
+    bitvec reachable;
+    for (const auto *stmt : branch.potentialStatements) {
+        // Statements without source information are not counted as coverage.
+        if (!stmt->getSourceInfo().isValid()) {
+            continue;
+        }
+        const auto *stmtReachable = reachability->getReachable(stmt);
+        if (stmtReachable == nullptr) {
+            return;
+        }
+        reachable |= *stmtReachable;
+    }
+    if (!reachable.empty()) {
+        branch.reachableStatements = reachable;
+    }
+}
+
+std::optional<size_t> SymbolicExecutor::countReachableUncovered(const Branch &branch) const {
+    if (!branch.reachableStatements) {
+        return std::nullopt;
+    }
+    return (*branch.reachableStatements & uncoveredStatements).popcount();
+}
+
+bool SymbolicExecutor::cannotCoverNewStatements(const Branch &branch) const {
+    if (!branch.reachableStatements ||
+        uncoveredStatements.intersects(reachability->getUnknownStatements()) ||
+        branch.reachableStatements->intersects(uncoveredStatements)) {
+        return false;
+    }
+    // The branch may also have executed statements before it was created that are still new.
+    for (const auto *stmt : branch.nextState.get().getVisited()) {
+        if (visitedStatements.count(stmt) == 0U) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SymbolicExecutor::dropCoveredBranches(std::vector<Branch> &branches) const {
+    if (!reachability) {
+        return;
+    }
+    branches.erase(
+        std::remove_if(branches.begin(), branches.end(),
+                       [this](const Branch &b) -> bool { return cannotCoverNewStatements(b); }),
+        branches.end());
+}
+
+void SymbolicExecutor::markCovered(const IR::Statement *statement) {
+    if (!reachability) {
+        return;
+    }
+    if (auto index = reachability->getIndex(statement)) {
+        uncoveredStatements.clrbit(*index);
+    }
+}
+
 bool SymbolicExecutor::handleTerminalState(const Callback &callback,
                                            const ExecutionState &terminalState) {
     // Check the solver for satisfiability. If it times out or reports non-satisfiability, issue
     // a warning and continue on a different path.
-    auto solverResult = solver.checkSat(terminalState.getPathConstraint());
+    auto solverResult = solver.checkSat(terminalState.getPathConstraint().to_vector());
     if (!solverResult) {
         ::warning("Solver timed out");
         return false;
@@ -64,7 +137,7 @@ bool SymbolicExecutor::evaluateBranch(const SymbolicExecutor::Branch &branch,
     }
 
     // Check the consistency of the path constraints asserted so far.
-    auto solverResult = solver.checkSat(branch.nextState.get().getPathConstraint());
+    auto solverResult = solver.checkSat(branch.nextState.get().getPathConstraint().to_vector());
     if (solverResult == std::nullopt) {
         ::warning("Solver timed out");
     }
@@ -92,16 +165,133 @@ SymbolicExecutor::SymbolicExecutor(AbstractSolver &solver, const ProgramInfo &pr
     if (seed != std::nullopt) {
         this->solver.seed(*seed);
     }
+    if (programInfo.dcg != nullptr) {
+        reachability.emplace(*programInfo.dcg, allStatements);
+        uncoveredStatements.setrange(0, allStatements.size());
+    }
 }
 
 void SymbolicExecutor::updateVisitedStatements(const P4::Coverage::CoverageSet &newStatements) {
-    visitedStatements.insert(newStatements.begin(), newStatements.end());
+    for (const auto *stmt : newStatements) {
+        if (visitedStatements.insert(stmt).second) {
+            markCovered(stmt);
+        }
+    }
 }
 
 const P4::Coverage::CoverageSet &SymbolicExecutor::getVisitedStatements() {
     return visitedStatements;
 }
 
+std::vector<std::reference_wrapper<const ExecutionState>> SymbolicExecutor::getFrontier() const {
+    BUG("This path selection strategy can not be checkpointed.");
+}
+
+void SymbolicExecutor::setFrontier(std::vector<Branch> /*branches*/) {
+    BUG("This path selection strategy can not be resumed.");
+}
+
+Checkpoint SymbolicExecutor::checkpoint() const {
+    Checkpoint checkpoint;
+    checkpoint.statementCount = allStatements.size();
+    size_t index = 0;
+    for (const auto *stmt : allStatements) {
+        if (visitedStatements.count(stmt) != 0) {
+            checkpoint.visitedStatements.push_back(index);
+        }
+        index++;
+    }
+    for (const auto &state : getFrontier()) {
+        checkpoint.frontier.push_back(state.get().getSelectedBranches());
+    }
+    return checkpoint;
+}
+
+void SymbolicExecutor::resume(const Checkpoint &checkpoint) {
+    if (checkpoint.statementCount != allStatements.size()) {
+        ::error(
+            "The checkpoint was written for a program with %1% statements, but this program has "
+            "%2%.",
+            checkpoint.statementCount, allStatements.size());
+        return;
+    }
+    std::vector<const IR::Statement *> statements(allStatements.begin(), allStatements.end());
+    for (auto index : checkpoint.visitedStatements) {
+        visitedStatements.insert(statements.at(index));
+        markCovered(statements.at(index));
+    }
+
+    // Replay the branch decisions of all unexplored branches at once. Branches that share a prefix
+    // of their decisions share the states along that prefix, so each step of the program is
+    // replayed once per checkpoint rather than once per branch.
+    struct Replay {
+        std::reference_wrapper<ExecutionState> state;
+        /// The number of branch decisions that led to @a state.
+        size_t depth;
+        /// The indices of the unexplored branches that are reached through @a state.
+        std::vector<size_t> paths;
+    };
+    const auto &frontier = checkpoint.frontier;
+    std::vector<std::optional<Branch>> replayed(frontier.size());
+    std::vector<size_t> allPaths(frontier.size());
+    std::iota(allPaths.begin(), allPaths.end(), 0);
+    std::vector<Replay> pending{{executionState, 0, std::move(allPaths)}};
+    while (!pending.empty()) {
+        auto replay = std::move(pending.back());
+        pending.pop_back();
+        std::vector<size_t> paths;
+        for (auto path : replay.paths) {
+            if (frontier[path].size() == replay.depth) {
+                replayed[path].emplace(replay.state.get());
+            } else {
+                paths.push_back(path);
+            }
+        }
+        auto state = replay.state;
+        try {
+            while (!paths.empty() && !state.get().isTerminal()) {
+                StepResult successors = step(state);
+                if (successors->size() == 1) {
+                    state = successors->at(0).nextState;
+                    continue;
+                }
+                std::map<uint64_t, std::vector<size_t>> next;
+                for (auto path : paths) {
+                    auto decision = frontier[path][replay.depth];
+                    if (decision == 0 || decision > successors->size()) {
+                        continue;
+                    }
+                    if (frontier[path].size() == replay.depth + 1) {
+                        replayed[path] = successors->at(decision - 1);
+                    } else {
+                        next[decision].push_back(path);
+                    }
+                }
+                for (auto &[decision, nextPaths] : next) {
+                    pending.push_back({successors->at(decision - 1).nextState, replay.depth + 1,
+                                       std::move(nextPaths)});
+                }
+                break;
+            }
+        } catch (TestgenUnimplemented &e) {
+            ::warning("Path encountered unimplemented feature while resuming. Message: %1%\n",
+                      e.what());
+        }
+    }
+
+    std::vector<Branch> branches;
+    for (auto &branch : replayed) {
+        if (branch) {
+            branches.push_back(std::move(*branch));
+        }
+    }
+    if (branches.size() < frontier.size()) {
+        ::warning("%1% of %2% unexplored branches of the checkpoint could not be replayed.",
+                  frontier.size() - branches.size(), frontier.size());
+    }
+    setFrontier(std::move(branches));
+}
+
 void SymbolicExecutor::printCurrentTraceAndBranches(std::ostream &out) {
     const auto &branchesList = executionState.get().getSelectedBranches();
     printTraces("Track branches:");
@@ -2,14 +2,19 @@
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_CORE_SYMBOLIC_EXECUTOR_SYMBOLIC_EXECUTOR_H_
 
 #include <functional>
+#include <cstddef>
 #include <iosfwd>
+#include <optional>
 #include <vector>
 
+#include "backends/p4tools/common/compiler/reachability.h"
 #include "backends/p4tools/common/core/solver.h"
+#include "lib/bitvec.h"
 #include "midend/coverage.h"
 
 #include "backends/p4tools/modules/testgen/core/program_info.h"
 #include "backends/p4tools/modules/testgen/core/small_step/small_step.h"
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
 #include "backends/p4tools/modules/testgen/lib/execution_state.h"
 #include "backends/p4tools/modules/testgen/lib/final_state.h"
 
@@ -56,6 +61,16 @@ class SymbolicExecutor {
     /// Update the set of visited statements.
     void updateVisitedStatements(const P4::Coverage::CoverageSet &newStatements);
 
+    /// @returns the progress of the exploration, except for the test count, which is known to the
+    /// test back end. A BUG occurs if this strategy can not be checkpointed.
+    [[nodiscard]] Checkpoint checkpoint() const;
+
+    /// Continues the exploration recorded in @a checkpoint instead of starting at the beginning
+    /// of the program. Must be called before @ref run. The unexplored branches are reconstructed
+    /// by replaying their branch decisions. Branches that can no longer be reached this way are
+    /// dropped with a warning.
+    void resume(const Checkpoint &checkpoint);
+
  protected:
     /// Target-specific information about the P4 program.
     const ProgramInfo &programInfo;
@@ -72,15 +87,47 @@ class SymbolicExecutor {
     /// Set of all statements executed in any testcase that has been outputted.
     P4::Coverage::CoverageSet visitedStatements;
 
+    /// The statements that may execute after each statement, if the program has a DCG. Statements
+    /// are numbered by their position in @ref allStatements.
+    std::optional<StatementReachability> reachability;
+
+    /// The numbers of the statements that are not in @ref visitedStatements yet. Only maintained
+    /// if there is a @ref reachability index.
+    bitvec uncoveredStatements;
+
+    /// @returns the number of statements that may execute on @a branch and are not in @ref
+    /// visitedStatements yet, or std::nullopt if the statements of the branch are not known.
+    [[nodiscard]] std::optional<size_t> countReachableUncovered(const Branch &branch) const;
+
+    /// @returns true if @a branch can not cover any statement that is not in @ref
+    /// visitedStatements yet. This is only decided if the statements of the branch are known and
+    /// every uncovered statement is part of the DCG, so exploring such a branch can not add to
+    /// the coverage.
+    [[nodiscard]] bool cannotCoverNewStatements(const Branch &branch) const;
+
+    /// Removes the branches from @a branches that can not cover new statements.
+    void dropCoveredBranches(std::vector<Branch> &branches) const;
+
     /// Handles processing at the end of a P4 program.
     ///
     /// @returns true if symbolic execution should end; false if symbolic execution should continue
     /// on a different path.
     bool handleTerminalState(const Callback &callback, const ExecutionState &terminalState);
 
-    /// Take one step in the program and return list of possible branches.
+    /// Take one step in the program and return list of possible branches. If there are several,
+    /// each records its position in the list as a branch decision. These decisions are used by the
+    /// track branches, selected (input) branches, and checkpoint features.
     StepResult step(ExecutionState &state);
 
+    /// @returns the states this strategy has yet to explore. Strategies that can be checkpointed
+    /// override this and @ref setFrontier.
+    [[nodiscard]] virtual std::vector<std::reference_wrapper<const ExecutionState>> getFrontier()
+        const;
+
+    /// Replaces the states this strategy has yet to explore with @a branches, which are ordered
+    /// like the result of @ref getFrontier.
+    virtual void setFrontier(std::vector<Branch> branches);
+
     /// Take a branch and a solver as input.
     /// Compute the branch's path conditions using the solver.
     /// Return true if the solver can find a solution and does not time out.
@@ -93,6 +140,13 @@ class SymbolicExecutor {
 
  private:
     SmallStepEvaluator evaluator;
+
+    /// Sets the reachable statements of @a branch to those that may execute after its potential
+    /// statements. They stay unknown if a potential statement is not part of the DCG.
+    void setReachableStatements(Branch &branch) const;
+
+    /// Marks @a statement as covered in @ref uncoveredStatements.
+    void markCovered(const IR::Statement *statement);
 };
 
 }  // namespace P4Tools::P4Testgen
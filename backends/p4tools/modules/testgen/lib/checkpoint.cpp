@@ -0,0 +1,144 @@
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace P4Tools::P4Testgen {
+
+namespace {
+
+/// The first line of every checkpoint. The number is incremented when the format changes.
+const char *const CHECKPOINT_HEADER = "p4testgen-checkpoint 1";
+
+/// Reads the next line of @p in and checks that it starts with @p keyword.
+std::optional<std::istringstream> readLine(std::istream &in, const char *keyword) {
+    std::string line;
+    if (!std::getline(in, line)) {
+        return std::nullopt;
+    }
+    std::istringstream fields(line);
+    std::string word;
+    if (!(fields >> word) || word != keyword) {
+        return std::nullopt;
+    }
+    return fields;
+}
+
+}  // namespace
+
+void Checkpoint::write(std::ostream &out) const {
+    out << CHECKPOINT_HEADER << '\n';
+    out << "tests " << testCount << '\n';
+    out << "statements " << statementCount << ' ' << visitedStatements.size() << '\n';
+    for (size_t i = 0; i < visitedStatements.size(); i++) {
+        out << (i == 0 ? "" : " ") << visitedStatements[i];
+    }
+    out << '\n';
+    out << "frontier " << frontier.size() << '\n';
+    const std::vector<uint64_t> *previous = nullptr;
+    for (const auto &path : frontier) {
+        size_t shared = 0;
+        if (previous != nullptr) {
+            auto mismatch = std::mismatch(path.begin(), path.end(), previous->begin(),
+                                          previous->end());
+            shared = mismatch.first - path.begin();
+        }
+        out << shared;
+        for (size_t i = shared; i < path.size(); i++) {
+            out << ' ' << path[i];
+        }
+        out << '\n';
+        previous = &path;
+    }
+}
+
+std::optional<Checkpoint> Checkpoint::read(std::istream &in) {
+    std::string header;
+    if (!std::getline(in, header) || header != CHECKPOINT_HEADER) {
+        return std::nullopt;
+    }
+    Checkpoint checkpoint;
+    auto tests = readLine(in, "tests");
+    if (!tests || !(*tests >> checkpoint.testCount) || checkpoint.testCount < 0) {
+        return std::nullopt;
+    }
+    auto statements = readLine(in, "statements");
+    size_t visitedCount = 0;
+    if (!statements || !(*statements >> checkpoint.statementCount >> visitedCount)) {
+        return std::nullopt;
+    }
+    std::string line;
+    if (!std::getline(in, line)) {
+        return std::nullopt;
+    }
+    std::istringstream visited(line);
+    for (size_t index = 0; visited >> index;) {
+        if (index >= checkpoint.statementCount) {
+            return std::nullopt;
+        }
+        checkpoint.visitedStatements.push_back(index);
+    }
+    if (checkpoint.visitedStatements.size() != visitedCount) {
+        return std::nullopt;
+    }
+    auto frontier = readLine(in, "frontier");
+    size_t frontierSize = 0;
+    if (!frontier || !(*frontier >> frontierSize)) {
+        return std::nullopt;
+    }
+    for (size_t i = 0; i < frontierSize; i++) {
+        if (!std::getline(in, line)) {
+            return std::nullopt;
+        }
+        std::istringstream fields(line);
+        size_t shared = 0;
+        if (!(fields >> shared) ||
+            (shared > 0 && (i == 0 || shared > checkpoint.frontier.back().size()))) {
+            return std::nullopt;
+        }
+        std::vector<uint64_t> path;
+        if (shared > 0) {
+            const auto &previous = checkpoint.frontier.back();
+            path.assign(previous.begin(), previous.begin() + shared);
+        }
+        for (uint64_t decision = 0; fields >> decision;) {
+            path.push_back(decision);
+        }
+        if (!fields.eof()) {
+            return std::nullopt;
+        }
+        checkpoint.frontier.push_back(std::move(path));
+    }
+    return checkpoint;
+}
+
+bool Checkpoint::save(const std::filesystem::path &path) const {
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream out(tmpPath);
+        write(out);
+        if (!out.flush()) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tmpPath, path, error);
+    return !error;
+}
+
+std::optional<Checkpoint> Checkpoint::load(const std::filesystem::path &path) {
+    std::ifstream in(path);
+    if (!in) {
+        return std::nullopt;
+    }
+    return read(in);
+}
+
+}  // namespace P4Tools::P4Testgen
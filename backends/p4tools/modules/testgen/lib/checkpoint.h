@@ -0,0 +1,59 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_CHECKPOINT_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_CHECKPOINT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <vector>
+
+namespace P4Tools::P4Testgen {
+
+/// The progress of an exploration, from which a later P4Testgen session can resume. States are
+/// not stored, only the branch decisions that lead to them, so a resumed session reconstructs them
+/// by replaying these decisions from the start of the program.
+///
+/// The format is a small text file:
+///     p4testgen-checkpoint 1
+///     tests <number of tests generated so far>
+///     statements <number of statements in the program> <number of visited statements>
+///     <indices of the visited statements>
+///     frontier <number of unexplored branches>
+///     <one line per unexplored branch>
+/// Each branch is written as the length of the prefix it shares with the branch on the line above,
+/// followed by the rest of its branch decisions. Unexplored branches of a depth-first search share
+/// most of their path, so this keeps checkpoints of deep explorations small.
+struct Checkpoint {
+    /// The number of tests generated so far. A resumed session continues numbering tests from here.
+    int64_t testCount = 0;
+
+    /// The number of statements in the program. Used to reject checkpoints of other programs.
+    size_t statementCount = 0;
+
+    /// The statements covered by the tests generated so far, as indices into the set of all
+    /// statements of the program.
+    std::vector<size_t> visitedStatements;
+
+    /// For each unexplored branch, the branch decisions leading to it from the start of the
+    /// program. Ordered like the unexplored branches of the executor that wrote the checkpoint.
+    std::vector<std::vector<uint64_t>> frontier;
+
+    /// Writes this checkpoint to @p out.
+    void write(std::ostream &out) const;
+
+    /// @returns the checkpoint read from @p in, or std::nullopt if @p in is not a checkpoint.
+    static std::optional<Checkpoint> read(std::istream &in);
+
+    /// Writes this checkpoint to @p path. The file is replaced atomically, so that an interrupted
+    /// session leaves the previous checkpoint intact. @returns false if the file can not be
+    /// written.
+    [[nodiscard]] bool save(const std::filesystem::path &path) const;
+
+    /// @returns the checkpoint stored at @p path, or std::nullopt if it can not be read.
+    static std::optional<Checkpoint> load(const std::filesystem::path &path);
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_CHECKPOINT_H_ */
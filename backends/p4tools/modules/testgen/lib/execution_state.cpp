@@ -95,11 +95,11 @@ ExecutionState::ExecutionState(Continuation::Body body)
 
 bool ExecutionState::isTerminal() const { return body.empty() && stack.empty(); }
 
-const std::vector<uint64_t> &ExecutionState::getSelectedBranches() const {
-    return selectedBranches;
+std::vector<uint64_t> ExecutionState::getSelectedBranches() const {
+    return selectedBranches.to_vector();
 }
 
-const std::vector<const IR::Expression *> &ExecutionState::getPathConstraint() const {
+const persistent_list<const IR::Expression *> &ExecutionState::getPathConstraint() const {
     return pathConstraint;
 }
 
@@ -137,11 +137,14 @@ const IR::Expression *ExecutionState::get(const StateVariable &var) const {
 void ExecutionState::markVisited(const IR::Statement *stmt) {
     // Only track statements, which have a valid source position in the P4 program.
     if (stmt->getSourceInfo().isValid()) {
-        visitedStatements.emplace(stmt);
+        visitedStatements.insert(stmt);
     }
 }
 
-const P4::Coverage::CoverageSet &ExecutionState::getVisited() const { return visitedStatements; }
+const persistent_set<const IR::Statement *, P4::Coverage::SourceIdCmp>
+    &ExecutionState::getVisited() const {
+    return visitedStatements;
+}
 
 bool ExecutionState::hasTaint(const IR::Expression *expr) const {
     return Taint::hasTaint(env.getInternalMap(), expr);
@@ -170,7 +173,8 @@ void ExecutionState::printSymbolicEnv(std::ostream &out) const {
     out << "##### Symbolic Environment End #####" << std::endl;
 }
 
-const std::vector<std::reference_wrapper<const TraceEvent>> &ExecutionState::getTrace() const {
+const persistent_list<std::reference_wrapper<const TraceEvent>> &ExecutionState::getTrace()
+    const {
     return trace;
 }
 
@@ -182,7 +186,7 @@ const std::stack<std::reference_wrapper<const ExecutionState::StackFrame>>
 }
 
 void ExecutionState::setProperty(cstring propertyName, Continuation::PropertyValue property) {
-    stateProperties[propertyName] = std::move(property);
+    stateProperties.insert_or_assign(propertyName, property);
 }
 
 bool ExecutionState::hasProperty(cstring propertyName) const {
@@ -191,7 +195,13 @@ bool ExecutionState::hasProperty(cstring propertyName) const {
 
 void ExecutionState::addTestObject(cstring category, cstring objectLabel,
                                    const TestObject *object) {
-    testObjects[category][objectLabel] = object;
+    persistent_map<cstring, const TestObject *> objects;
+    auto it = testObjects.find(category);
+    if (it != testObjects.end()) {
+        objects = it->second;
+    }
+    objects.insert_or_assign(objectLabel, object);
+    testObjects.insert_or_assign(category, objects);
 }
 
 const TestObject *ExecutionState::getTestObject(cstring category, cstring objectLabel,
@@ -212,7 +222,7 @@ std::map<cstring, const TestObject *> ExecutionState::getTestObjectCategory(
     cstring category) const {
     auto it = testObjects.find(category);
     if (it != testObjects.end()) {
-        return it->second;
+        return {it->second.begin(), it->second.end()};
     }
     return {};
 }
@@ -527,12 +537,14 @@ const IR::Member *ExecutionState::getCurrentParserErrorLabel() const {
  *  Variables and symbolic constants
  * ============================================================================================= */
 
-const std::set<StateVariable> &ExecutionState::getZombies() const { return allocatedZombies; }
+const persistent_set<StateVariable> &ExecutionState::getZombies() const {
+    return allocatedZombies;
+}
 
 const StateVariable &ExecutionState::createZombieConst(const IR::Type *type, cstring name,
                                                        uint64_t instanceId) {
     const auto &zombie = Utils::getZombieConst(type, instanceId, name);
-    const auto &result = allocatedZombies.insert(zombie);
+    auto result = allocatedZombies.insert(zombie);
     // The zombie already existed, check its type.
     if (!result.second) {
         BUG_CHECK((*result.first)->type->equiv(*type),
@@ -22,6 +22,8 @@
 #include "ir/node.h"
 #include "lib/cstring.h"
 #include "lib/exceptions.h"
+#include "lib/persistent_list.h"
+#include "lib/persistent_map.h"
 #include "midend/coverage.h"
 
 #include "backends/p4tools/modules/testgen/lib/continuation.h"
@@ -31,6 +33,11 @@
 namespace P4Tools::P4Testgen {
 
 /// Represents state of execution after having reached a program point.
+///
+/// Every branch of the symbolic executor clones a state, so the containers that grow along a path
+/// (the environment, the trace, visited statements, path constraints, branch decisions,
+/// properties, and test objects) share structure with the state they were cloned from. Cloning
+/// a state is cheap, and each clone only stores what changed since.
 class ExecutionState {
     friend class Test::SmallStepTest;
 
@@ -86,13 +93,13 @@ class ExecutionState {
 
     /// The list of zombies that have been created in this state.
     /// These zombies are later fed to the model for completion.
-    std::set<StateVariable> allocatedZombies;
+    persistent_set<StateVariable> allocatedZombies;
 
     /// The program trace for the current program point (i.e., how we got to the current state).
-    std::vector<std::reference_wrapper<const TraceEvent>> trace;
+    persistent_list<std::reference_wrapper<const TraceEvent>> trace;
 
     /// Set of visited statements. Used for code coverage.
-    P4::Coverage::CoverageSet visitedStatements;
+    persistent_set<const IR::Statement *, P4::Coverage::SourceIdCmp> visitedStatements;
 
     /// The remaining body of the current function being executed.
     ///
@@ -114,7 +121,7 @@ class ExecutionState {
     /// written while this variable is active is tainted. This property must be unset manually to
     /// resume normal operation by setting the property "false". Usually, this is done directly
     /// after the tainted sequence of commands has been executed.
-    std::map<cstring, Continuation::PropertyValue> stateProperties;
+    persistent_map<cstring, Continuation::PropertyValue> stateProperties;
 
     // Test objects are classes of variables that influence the execution of test frameworks. They
     // are collected during interpreter execution and consumed by the respective test framework. For
@@ -122,7 +129,7 @@ class ExecutionState {
     // which defines control plane match action entries. Once the interpreter has solved for the
     // variables used by these test objects and concretized the values, they can be used to generate
     // a test. Test objects are not constant because they may be manipulated by a target back end.
-    std::map<cstring, std::map<cstring, const TestObject *>> testObjects;
+    persistent_map<cstring, persistent_map<cstring, const TestObject *>> testObjects;
 
     /// The parserErrorLabel is set by the parser to indicate the variable corresponding to the
     /// parser error that is set by various built-in functions such as verify or extract.
@@ -136,10 +143,10 @@ class ExecutionState {
 
     /// List of path constraints - expressions that must all evaluate to true to reach this
     /// execution state.
-    std::vector<const IR::Expression *> pathConstraint;
+    persistent_list<const IR::Expression *> pathConstraint;
 
     /// List of branch decisions leading into this state.
-    std::vector<uint64_t> selectedBranches;
+    persistent_list<uint64_t> selectedBranches;
 
     /// State that is needed to track reachability of statements given a query.
     ReachabilityEngineState *reachabilityEngineState = nullptr;
@@ -152,10 +159,10 @@ class ExecutionState {
     [[nodiscard]] bool isTerminal() const;
 
     /// @returns list of paths constraints.
-    [[nodiscard]] const std::vector<const IR::Expression *> &getPathConstraint() const;
+    [[nodiscard]] const persistent_list<const IR::Expression *> &getPathConstraint() const;
 
     /// @returns list of branch decisions leading into this state.
-    [[nodiscard]] const std::vector<uint64_t> &getSelectedBranches() const;
+    [[nodiscard]] std::vector<uint64_t> getSelectedBranches() const;
 
     /// Adds path constraint.
     void pushPathConstraint(const IR::Expression *e);
@@ -176,7 +183,8 @@ class ExecutionState {
     void markVisited(const IR::Statement *stmt);
 
     /// @returns list of all statements visited before reaching this state.
-    [[nodiscard]] const P4::Coverage::CoverageSet &getVisited() const;
+    [[nodiscard]] const persistent_set<const IR::Statement *, P4::Coverage::SourceIdCmp>
+        &getVisited() const;
 
     /// Sets the symbolic value of the given state variable to the given value. Constant folding
     /// is done on the given value before updating the symbolic state.
@@ -195,7 +203,8 @@ class ExecutionState {
     void printSymbolicEnv(std::ostream &out = std::cout) const;
 
     /// @returns the current event trace.
-    [[nodiscard]] const std::vector<std::reference_wrapper<const TraceEvent>> &getTrace() const;
+    [[nodiscard]] const persistent_list<std::reference_wrapper<const TraceEvent>> &getTrace()
+        const;
 
     /// @returns the current body.
     [[nodiscard]] const Continuation::Body &getBody() const;
@@ -432,7 +441,7 @@ class ExecutionState {
      */
  public:
     /// @returns the zombies that were allocated in this state
-    [[nodiscard]] const std::set<StateVariable> &getZombies() const;
+    [[nodiscard]] const persistent_set<StateVariable> &getZombies() const;
 
     /// @see Utils::getZombieConst.
     /// We also place the zombies in the set of allocated zombies of this state.
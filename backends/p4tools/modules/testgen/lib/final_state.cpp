@@ -15,7 +15,7 @@ FinalState::FinalState(AbstractSolver &solver, const ExecutionState &inputState)
     : solver(solver),
       state(inputState),
       completedModel(completeModel(inputState, solver.getModel())) {
-    for (const auto &event : inputState.getTrace()) {
+    for (const auto &event : inputState.getTrace().to_vector()) {
         trace.emplace_back(*event.get().evaluate(completedModel));
     }
 }
@@ -32,7 +32,7 @@ Model FinalState::completeModel(const ExecutionState &executionState, const Mode
     // are part of the constraints that have been added to the solver.
     auto *evaluatedModel = executionState.getSymbolicEnv().evaluate(*completedModel);
 
-    for (const auto &event : executionState.getTrace()) {
+    for (const auto &event : executionState.getTrace().to_vector()) {
         event.get().complete(evaluatedModel);
     }
 
@@ -49,6 +49,9 @@ const std::vector<std::reference_wrapper<const TraceEvent>> *FinalState::getTrac
     return &trace;
 }
 
-const P4::Coverage::CoverageSet &FinalState::getVisited() const { return state.get().getVisited(); }
+P4::Coverage::CoverageSet FinalState::getVisited() const {
+    const auto &visited = state.get().getVisited();
+    return {visited.begin(), visited.end()};
+}
 
 }  // namespace P4Tools::P4Testgen
@@ -7,7 +7,7 @@
 #include <variant>
 
 #include "backends/p4tools/common/core/solver.h"
-#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/expression_pool.h"
 #include "backends/p4tools/common/lib/format_int.h"
 #include "backends/p4tools/common/lib/formulae.h"
 #include "backends/p4tools/common/lib/model.h"
@@ -15,7 +15,6 @@
 #include "backends/p4tools/common/lib/taint.h"
 #include "backends/p4tools/common/lib/trace_event.h"
 #include "backends/p4tools/common/lib/util.h"
-#include "frontends/p4/optimizeExpressions.h"
 #include "ir/irutils.h"
 #include "lib/cstring.h"
 #include "lib/error.h"
@@ -38,7 +37,8 @@
 namespace P4Tools::P4Testgen {
 
 const Model *TestBackEnd::computeConcolicVariables(const ExecutionState *executionState,
-                                                   const Model *completedModel, Z3Solver *solver,
+                                                   const Model *completedModel,
+                                                   AbstractSolver *solver,
                                                    const IR::Expression *outputPacketExpr,
                                                    const IR::Expression *outputPortExpr) const {
     // Execute concolic functions that may occur in the output packet, the output port,
@@ -48,7 +48,7 @@ const Model *TestBackEnd::computeConcolicVariables(const ExecutionState *executi
 
     outputPacketExpr->apply(concolicResolver);
     outputPortExpr->apply(concolicResolver);
-    for (const auto *assert : executionState->getPathConstraint()) {
+    for (const auto *assert : executionState->getPathConstraint().to_vector()) {
         CHECK_NULL(assert);
         assert->apply(concolicResolver);
     }
@@ -57,7 +57,7 @@ const Model *TestBackEnd::computeConcolicVariables(const ExecutionState *executi
     // If we resolved concolic variables and substitute them, check the solver again under
     // the new constraints.
     if (!resolvedConcolicVariables->empty()) {
-        std::vector<const Constraint *> asserts = executionState->getPathConstraint();
+        std::vector<const Constraint *> asserts = executionState->getPathConstraint().to_vector();
 
         for (const auto &resolvedConcolicVariable : *resolvedConcolicVariables) {
             const auto &concolicVariable = resolvedConcolicVariable.first;
@@ -73,7 +73,7 @@ const Model *TestBackEnd::computeConcolicVariables(const ExecutionState *executi
             }
             CHECK_NULL(pathConstraint);
             pathConstraint = executionState->getSymbolicEnv().subst(pathConstraint);
-            pathConstraint = P4::optimizeExpression(pathConstraint);
+            pathConstraint = ExpressionPool::simplify(pathConstraint);
             asserts.push_back(pathConstraint);
         }
         auto solverResult = solver->checkSat(asserts);
@@ -101,8 +101,7 @@ bool TestBackEnd::run(const FinalState &state) {
         const auto *outputPortExpr = executionState->get(programInfo.getTargetOutputPortVar());
         const auto &allStatements = programInfo.getAllStatements();
 
-        auto *solver = state.getSolver().to<Z3Solver>();
-        CHECK_NULL(solver);
+        auto *solver = &state.getSolver();
 
         // Don't increase the test count if --with-output-packet is enabled and we don't
         // produce a test with an output packet.
@@ -160,7 +159,10 @@ bool TestBackEnd::run(const FinalState &state) {
         printFeature("test_info", 4,
                      "============ Test %1%: Statements covered: %2% (%3%/%4%) ============",
                      testCount, coverage, visitedStatements.size(), allStatements.size());
-        P4::Coverage::logCoverage(allStatements, visitedStatements, executionState->getVisited());
+        const auto &newStatements = executionState->getVisited();
+        P4::Coverage::logCoverage(
+            allStatements, visitedStatements,
+            P4::Coverage::CoverageSet(newStatements.begin(), newStatements.end()));
 
         // Output the test.
         Util::withTimer("backend", [this, &testSpec, &selectedBranches, &coverage] {
@@ -280,6 +282,10 @@ void TestBackEnd::printPerformanceReport(bool write) const {
     testWriter->printPerformanceReport(write);
 }
 
+void TestBackEnd::flushTests() { testWriter->flushTests(); }
+
 int64_t TestBackEnd::getTestCount() const { return testCount; }
 
+void TestBackEnd::setTestCount(int64_t testCount) { this->testCount = testCount; }
+
 }  // namespace P4Tools::P4Testgen
@@ -6,7 +6,7 @@
 #include <functional>
 #include <vector>
 
-#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/core/solver.h"
 #include "backends/p4tools/common/lib/model.h"
 #include "backends/p4tools/common/lib/trace_event.h"
 #include "ir/ir.h"
@@ -98,7 +98,7 @@ class TestBackEnd {
 
     /// @returns a new modules with all concolic variables in the program resolved.
     const Model *computeConcolicVariables(const ExecutionState *executionState,
-                                          const Model *completedModel, Z3Solver *solver,
+                                          const Model *completedModel, AbstractSolver *solver,
                                           const IR::Expression *outputPacketExpr,
                                           const IR::Expression *outputPortExpr) const;
 
@@ -117,8 +117,15 @@ class TestBackEnd {
     /// enabled.
     void printPerformanceReport(bool write) const;
 
+    /// Waits until all tests generated so far are written. Tests are written in the background.
+    void flushTests();
+
     /// Accessors.
     [[nodiscard]] int64_t getTestCount() const;
+
+    /// Sets the number of tests generated so far, for example by an earlier run that is resumed.
+    /// Tests are numbered from there.
+    void setTestCount(int64_t testCount);
 };
 
 }  // namespace P4Tools::P4Testgen
@@ -0,0 +1,107 @@
+#include "backends/p4tools/modules/testgen/lib/test_writer.h"
+
+#include <ios>
+#include <stdexcept>
+#include <utility>
+
+#include "lib/gc.h"
+
+namespace P4Tools::P4Testgen {
+
+TestWriter::TestWriter(std::optional<std::filesystem::path> streamFile)
+    : streamFile(std::move(streamFile)), thread([this]() { writeLoop(); }) {}
+
+TestWriter::~TestWriter() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    queued.notify_all();
+    thread.join();
+}
+
+const inja::Template &TestWriter::parse(std::string_view source) {
+    return templates.emplace_back(env.parse(source));
+}
+
+void TestWriter::write(std::filesystem::path file, const inja::Template &tmpl, inja::json data) {
+    std::unique_lock<std::mutex> lock(mutex);
+    written.wait(lock, [this]() { return queue.size() < MAX_PENDING || failure; });
+    checkFailure();
+    queue.push_back({std::move(file), &tmpl, std::move(data)});
+    lock.unlock();
+    queued.notify_one();
+}
+
+void TestWriter::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    written.wait(lock, [this]() { return (queue.empty() && !busy) || failure; });
+    checkFailure();
+}
+
+void TestWriter::checkFailure() {
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void TestWriter::writeLoop() {
+    GCThreadScope gcThread;
+    std::vector<PendingTest> batch;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            busy = false;
+            written.notify_all();
+            queued.wait(lock, [this]() { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break;
+            }
+            batch.swap(queue);
+            busy = true;
+        }
+        // Make room in the queue before the batch is rendered.
+        written.notify_all();
+        try {
+            writeBatch(batch);
+        } catch (...) {
+            std::unique_lock<std::mutex> lock(mutex);
+            failure = std::current_exception();
+            busy = false;
+            queue.clear();
+            written.notify_all();
+            break;
+        }
+        batch.clear();
+    }
+    currentStream.close();
+}
+
+void TestWriter::writeBatch(std::vector<PendingTest> &batch) {
+    for (auto &test : batch) {
+        const auto &file = streamFile ? *streamFile : test.file;
+        if (!currentStream.is_open() || file != currentFile) {
+            currentStream.close();
+            auto mode = writtenFiles.insert(file).second ? std::ios::out : std::ios::app;
+            currentStream.open(file, mode);
+            currentFile = file;
+        }
+        if (streamFile) {
+            inja::json record;
+            record["file"] = test.file.filename().string();
+            record["test"] = env.render(*test.tmpl, test.data);
+            currentStream << record.dump() << '\n';
+        } else {
+            env.render_to(currentStream, *test.tmpl, test.data);
+        }
+        if (!currentStream) {
+            throw std::runtime_error("Unable to write test file " + file.string());
+        }
+    }
+    // Tests reach the disk once per batch, instead of once per test.
+    if (!currentStream.flush()) {
+        throw std::runtime_error("Unable to write test file " + currentFile.string());
+    }
+}
+
+}  // namespace P4Tools::P4Testgen
@@ -0,0 +1,125 @@
+#ifndef BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_WRITER_H_
+#define BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_WRITER_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <inja/inja.hpp>
+
+namespace P4Tools::P4Testgen {
+
+/// Renders tests and writes them out on a background thread, so that template rendering and the
+/// file system do not hold up the exploration. Tests are handed over as the Inja data of the test
+/// and a template that has been parsed once, when the test framework was set up.
+///
+/// By default, every file named in @ref write is written like the test frameworks did before:
+/// the first test for a file creates it and later tests for the same file are appended. In
+/// stream mode, all tests go to a single JSON Lines file instead, one record per test:
+///     {"file":"<file name>","test":"<rendered test>"}
+/// Concatenating the records of a file name in order reconstructs the file. This avoids creating
+/// a file per test, which dominates the run time of explorations with many small tests.
+class TestWriter {
+ public:
+    /// The maximum number of tests that are queued but not written yet. @ref write blocks while
+    /// the queue is full, so that a fast exploration does not buffer its whole output.
+    static constexpr size_t MAX_PENDING = 256;
+
+    /// Writes every test to its own file, or, if @p streamFile is set, all tests to that file.
+    explicit TestWriter(std::optional<std::filesystem::path> streamFile = std::nullopt);
+
+    TestWriter(const TestWriter &) = delete;
+
+    TestWriter(TestWriter &&) = delete;
+
+    TestWriter &operator=(const TestWriter &) = delete;
+
+    TestWriter &operator=(TestWriter &&) = delete;
+
+    /// Writes all queued tests and stops the background thread.
+    ~TestWriter();
+
+    /// Parses @p source into a template for @ref write. Templates are meant to be parsed when the
+    /// test framework is set up, before any test is written.
+    const inja::Template &parse(std::string_view source);
+
+    /// Queues @p data to be rendered with @p tmpl and written to @p file. @p tmpl must have been
+    /// returned by @ref parse of this writer. Rethrows the first error of the background thread.
+    void write(std::filesystem::path file, const inja::Template &tmpl, inja::json data);
+
+    /// Waits until all queued tests are written and flushed to disk. Rethrows the first error of
+    /// the background thread.
+    void flush();
+
+ private:
+    /// A test that has been queued but not written yet.
+    struct PendingTest {
+        std::filesystem::path file;
+        const inja::Template *tmpl;
+        inja::json data;
+    };
+
+    /// Takes batches of tests off the queue and writes them until the writer is destroyed.
+    void writeLoop();
+
+    /// Renders and writes one batch of tests. Runs on the background thread.
+    void writeBatch(std::vector<PendingTest> &batch);
+
+    /// Rethrows the first error of the background thread, if any. Must hold @ref mutex.
+    void checkFailure();
+
+    /// Renders the templates. Only the background thread renders, after all templates are parsed.
+    inja::Environment env;
+
+    /// The parsed templates. A deque, so that references to them stay valid.
+    std::deque<inja::Template> templates;
+
+    /// The JSON Lines file all tests are written to, if streaming.
+    std::optional<std::filesystem::path> streamFile;
+
+    /// The file that was written last, and its stream. It stays open, so that consecutive tests
+    /// for the same file, or all tests when streaming, do not reopen it.
+    std::filesystem::path currentFile;
+    std::ofstream currentStream;
+
+    /// The files that have been written so far. A test for one of these files is appended.
+    std::set<std::filesystem::path> writtenFiles;
+
+    /// Protects the members below, which are shared with the background thread.
+    std::mutex mutex;
+
+    /// Signals the background thread that tests were queued or that it should stop.
+    std::condition_variable queued;
+
+    /// Signals waiting callers that the queue has room or that a batch has been written.
+    std::condition_variable written;
+
+    /// The tests that have been queued but not taken by the background thread yet.
+    std::vector<PendingTest> queue;
+
+    /// Whether the background thread is writing a batch it took from the queue.
+    bool busy = false;
+
+    /// Set when the writer is destroyed.
+    bool stopping = false;
+
+    /// The first error of the background thread. No further tests are written after an error.
+    std::exception_ptr failure;
+
+    /// The background thread. Declared last, so that it starts once everything else is set up.
+    std::thread thread;
+};
+
+}  // namespace P4Tools::P4Testgen
+
+#endif /* BACKENDS_P4TOOLS_MODULES_TESTGEN_LIB_TEST_WRITER_H_ */
@@ -6,15 +6,29 @@
 #include <ostream>
 #include <utility>
 
+#include "backends/p4tools/common/lib/expression_pool.h"
 #include "backends/p4tools/common/lib/util.h"
 #include "inja/inja.hpp"
 #include "lib/log.h"
 #include "lib/timer.h"
 
+#include "backends/p4tools/modules/testgen/options.h"
+
 namespace P4Tools::P4Testgen {
 
 TF::TF(std::filesystem::path basePath, std::optional<unsigned int> seed = std::nullopt)
-    : basePath(std::move(basePath)), seed(seed) {}
+    : basePath(std::move(basePath)), seed(seed), writer(getStreamFile(this->basePath)) {}
+
+std::optional<std::filesystem::path> TF::getStreamFile(const std::filesystem::path &basePath) {
+    if (!TestgenOptions::get().streamTests) {
+        return std::nullopt;
+    }
+    auto streamFile = basePath;
+    streamFile.replace_extension(".jsonl");
+    return streamFile;
+}
+
+void TF::flushTests() { writer.flush(); }
 
 void TF::printPerformanceReport(bool write) const {
     // Do not emit a report if performance logging is not enabled.
@@ -27,14 +41,15 @@ void TF::printPerformanceReport(bool write) const {
     for (const auto &c : Util::getTimers()) {
         inja::json timerData;
         timerData["time"] = c.milliseconds;
+        timerData["calls"] = c.invocations;
         if (c.timerName.empty()) {
             printFeature("performance", 4, "Total: %i ms", c.milliseconds);
             timerData["pct"] = "100";
             timerData["name"] = "total";
         } else {
             timerData["pct"] = c.relativeToParent * 100;
-            printFeature("performance", 4, "%s: %i ms (%0.2f %% of parent)", c.timerName,
-                         c.milliseconds, c.relativeToParent * 100);
+            printFeature("performance", 4, "%s: %i ms (%0.2f %% of parent), %i calls",
+                         c.timerName, c.milliseconds, c.relativeToParent * 100, c.invocations);
             auto prunedName = c.timerName;
             prunedName.erase(remove_if(prunedName.begin(), prunedName.end(), isspace),
                              prunedName.end());
@@ -42,11 +57,17 @@ void TF::printPerformanceReport(bool write) const {
         }
         timerList.emplace_back(timerData);
     }
+    printFeature("performance", 4, "============ Expressions ============");
+    auto statistics = ExpressionPool::getStatistics();
+    printFeature("performance", 4,
+                 "Input nodes: %i, added to the pool: %i, shared with the pool: %i, rewrites: %i",
+                 statistics.inputNodes, statistics.pooledNodes, statistics.sharedNodes,
+                 statistics.rewrites);
     if (write) {
         dataJson["timers"] = timerList;
-        static const std::string TEST_CASE(R"""(Timer,Total Time,Percentage
+        static const std::string TEST_CASE(R"""(Timer,Total Time,Percentage,Calls
 ## for timer in timers
-{{timer.name}},{{timer.time}},{{timer.pct}}
+{{timer.name}},{{timer.time}},{{timer.pct}},{{timer.calls}}
 ## endfor
 )""");
         auto perfFilePath = basePath;
@@ -18,6 +18,7 @@
 #include "lib/cstring.h"
 
 #include "backends/p4tools/modules/testgen/lib/test_spec.h"
+#include "backends/p4tools/modules/testgen/lib/test_writer.h"
 
 namespace P4Tools::P4Testgen {
 
@@ -31,9 +32,18 @@ class TF {
     /// The seed used by the testgen.
     std::optional<unsigned int> seed;
 
+    /// Renders the tests and writes them out in the background. Test frameworks parse their
+    /// templates with it once, when they are created.
+    TestWriter writer;
+
     /// Creates a generic test framework.
     TF(std::filesystem::path basePath, std::optional<unsigned int> seed);
 
+    /// @returns the file all tests are written to if --stream-tests is set, or std::nullopt if
+    /// every test is written to its own file.
+    static std::optional<std::filesystem::path> getStreamFile(
+        const std::filesystem::path &basePath);
+
     /// Converts the traces of this test into a string representation and Inja object.
     static inja::json getTrace(const TestSpec *testSpec) {
         inja::json traceList = inja::json::array();
@@ -147,6 +157,9 @@ class TF {
     /// Also log performance numbers to a separate file in the test folder if @param write is
     /// enabled.
     void printPerformanceReport(bool write) const;
+
+    /// Waits until all tests passed to @ref outputTest are written.
+    void flushTests();
 };
 
 }  // namespace P4Tools::P4Testgen
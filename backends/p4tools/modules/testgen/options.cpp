@@ -268,7 +268,9 @@ TestgenOptions::TestgenOptions()
             return true;
         },
         R"(Build a DCG for input graph. This control flow graph directed cyclic graph can be used
-        for statement reachability analysis.)");
+        for statement reachability analysis. The GREEDY_STATEMENT_SEARCH and
+        RANDOM_STATEMENT_SEARCH strategies use it to rank branches by the uncovered statements
+        they can reach and to drop branches that can not reach any.)");
 
     registerOption(
         "--pattern", "pattern",
@@ -295,6 +297,85 @@ TestgenOptions::TestgenOptions()
         },
         "Produce only tests that violate the condition defined in assert calls. This will either "
         "produce no tests or only tests that contain counter examples.");
+
+    registerOption(
+        "--parallel", "threads",
+        [this](const char *arg) {
+            try {
+                auto threads = std::stoll(arg);
+                if (threads < 1) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+                parallel = threads;
+            } catch (std::exception &) {
+                ::error("Invalid input value %1% for --parallel. Expected positive integer.", arg);
+                return false;
+            }
+            return true;
+        },
+        "Explores the program with the given number of threads, each with its own solver. Only "
+        "applies to the DEPTH_FIRST path selection without --input-branches. Tests are produced "
+        "in a nondeterministic order [default: 1].");
+
+    registerOption(
+        "--solver-cache", nullptr,
+        [this](const char * /*arg*/) {
+            solverCache = true;
+            return true;
+        },
+        "Answer solver queries from the results of earlier queries where possible, instead of "
+        "sending every query to the SMT solver. The tests may then be built from different "
+        "models than without the cache.");
+
+    registerOption(
+        "--checkpoint", "file",
+        [this](const char *arg) {
+            checkpointFile = arg;
+            return true;
+        },
+        "Periodically write the progress of the exploration to the given file, from which a later "
+        "run can continue with --resume. Only applies to the DEPTH_FIRST path selection without "
+        "--parallel or --input-branches.");
+
+    registerOption(
+        "--checkpoint-interval", "seconds",
+        [this](const char *arg) {
+            try {
+                auto seconds = std::stoll(arg);
+                if (seconds < 0) {
+                    throw std::invalid_argument("Invalid input.");
+                }
+                checkpointInterval = seconds;
+            } catch (std::exception &) {
+                ::error(
+                    "Invalid input value %1% for --checkpoint-interval. Expected non-negative "
+                    "integer.",
+                    arg);
+                return false;
+            }
+            return true;
+        },
+        "The minimum time between two checkpoints. A checkpoint is also written when the run "
+        "ends [default: 60].");
+
+    registerOption(
+        "--resume", "file",
+        [this](const char *arg) {
+            resumeFile = arg;
+            return true;
+        },
+        "Continue the exploration recorded in the given checkpoint file instead of starting over. "
+        "The program and target must be the same as in the run that wrote the checkpoint. The "
+        "file may also be the one given to --checkpoint.");
+
+    registerOption(
+        "--stream-tests", nullptr,
+        [this](const char * /*arg*/) {
+            streamTests = true;
+            return true;
+        },
+        "Write all tests into a single JSON Lines file instead of a file per test. Each line holds "
+        "the name of the file the test would have been written to and the test itself.");
 }
 
 }  // namespace P4Tools
@@ -74,6 +74,25 @@ class TestgenOptions : public AbstractP4cToolOptions {
     /// This will either produce no tests or only tests that contain counter examples.
     bool assertionModeEnabled = false;
 
+    /// The number of threads that explore the program. Only the depth-first path selection
+    /// explores in parallel.
+    unsigned parallel = 1;
+
+    /// Answer solver queries from the results of earlier queries where possible.
+    bool solverCache = false;
+
+    /// Periodically write the progress of the exploration to this file, if set.
+    std::string checkpointFile;
+
+    /// The minimum number of seconds between two checkpoints.
+    uint64_t checkpointInterval = 60;
+
+    /// Continue the exploration recorded in this checkpoint file, if set.
+    std::string resumeFile;
+
+    /// Write all tests into a single JSON Lines file instead of a file per test.
+    bool streamTests = false;
+
     const char *getIncludePath() override;
 
  private:
@@ -23,7 +23,7 @@
 namespace P4Tools::P4Testgen::Bmv2 {
 
 Metadata::Metadata(std::filesystem::path basePath, std::optional<unsigned int> seed = std::nullopt)
-    : TF(std::move(basePath), seed) {}
+    : TF(std::move(basePath), seed), testCaseTemplate(writer.parse(getTestCaseTemplate())) {}
 
 std::vector<std::pair<size_t, size_t>> Metadata::getIgnoreMasks(const IR::Constant *mask) {
     std::vector<std::pair<size_t, size_t>> ignoreMasks;
@@ -129,7 +129,7 @@ void Metadata::computeTraceData(const TestSpec *testSpec, inja::json &dataJson)
 }
 
 void Metadata::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                            const std::string &testCase, float currentCoverage) {
+                            float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -164,17 +164,14 @@ void Metadata::emitTestcase(const TestSpec *testSpec, cstring selectedBranches,
 
     LOG5("Metadata back end: emitting testcase:" << std::setw(4) << dataJson);
 
-    inja::render_to(metadataFile, testCase, dataJson);
-    metadataFile.flush();
+    auto metadataFile = basePath;
+    metadataFile.replace_extension("_" + std::to_string(testId) + ".yml");
+    writer.write(metadataFile, testCaseTemplate, std::move(dataJson));
 }
 
 void Metadata::outputTest(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
                           float currentCoverage) {
-    auto incrementedbasePath = basePath;
-    incrementedbasePath.replace_extension("_" + std::to_string(testIdx) + ".yml");
-    metadataFile = std::ofstream(incrementedbasePath);
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testIdx, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testIdx, currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
@@ -2,7 +2,7 @@
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_BMV2_BACKEND_METADATA_METADATA_H_
 
 #include <cstddef>
-#include <fstream>
+#include <filesystem>
 #include <optional>
 #include <string>
 #include <utility>
@@ -20,8 +20,8 @@ namespace P4Tools::P4Testgen::Bmv2 {
 
 /// Extracts information from the @testSpec to emit a Metadata test case.
 class Metadata : public TF {
-    /// The output file.
-    std::ofstream metadataFile;
+    /// The parsed test case template.
+    const inja::Template &testCaseTemplate;
 
  public:
     virtual ~Metadata() = default;
@@ -51,7 +51,7 @@ class Metadata : public TF {
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
     void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testId,
-                      const std::string &testCase, float currentCoverage);
+                      float currentCoverage);
 
     /// Gets the traces from @param testSpec and populates @param dataJson.
     /// Also retrieves the label and offset for each successful extract call and stores them in a
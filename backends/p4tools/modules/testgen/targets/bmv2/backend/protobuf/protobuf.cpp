@@ -38,7 +38,7 @@ std::string formatHexExprWithSep(const IR::Expression *expr) {
 }
 
 Protobuf::Protobuf(std::filesystem::path basePath, std::optional<unsigned int> seed = std::nullopt)
-    : TF(std::move(basePath), seed) {}
+    : TF(std::move(basePath), seed), testCaseTemplate(writer.parse(getTestCaseTemplate())) {}
 
 std::optional<p4rt_id_t> Protobuf::getIdAnnotation(const IR::IAnnotated *node) {
     const auto *idAnnotation = node->getAnnotation("id");
@@ -377,7 +377,7 @@ entities : [
 }
 
 void Protobuf::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
-                            const std::string &testCase, float currentCoverage) {
+                            float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -401,15 +401,12 @@ void Protobuf::emitTestcase(const TestSpec *testSpec, cstring selectedBranches,
     LOG5("Protobuf test back end: emitting testcase:" << std::setw(4) << dataJson);
     auto protobufFile = basePath;
     protobufFile.replace_extension("_" + std::to_string(testIdx) + ".proto");
-    auto protobufFileStream = std::ofstream(protobufFile);
-    inja::render_to(protobufFileStream, testCase, dataJson);
-    protobufFileStream.flush();
+    writer.write(protobufFile, testCaseTemplate, std::move(dataJson));
 }
 
 void Protobuf::outputTest(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
                           float currentCoverage) {
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testIdx, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testIdx, currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
@@ -2,7 +2,7 @@
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_BMV2_BACKEND_PROTOBUF_PROTOBUF_H_
 
 #include <cstddef>
-#include <fstream>
+#include <filesystem>
 #include <optional>
 #include <string>
 #include <utility>
@@ -26,6 +26,9 @@ using P4::ControlPlaneAPI::Standard::SymbolType;
 
 /// Extracts information from the @testSpec to emit a Protobuf test case.
 class Protobuf : public TF {
+    /// The parsed test case template.
+    const inja::Template &testCaseTemplate;
+
  public:
     virtual ~Protobuf() = default;
 
@@ -54,7 +57,7 @@ class Protobuf : public TF {
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
     void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
-                      const std::string &testCase, float currentCoverage);
+                      float currentCoverage);
 
     /// @returns the inja test case template as a string.
     static std::string getTestCaseTemplate();
@@ -23,9 +23,6 @@
 
 namespace P4Tools::P4Testgen::Bmv2 {
 
-PTF::PTF(std::filesystem::path basePath, std::optional<unsigned int> seed = std::nullopt)
-    : TF(std::move(basePath), seed) {}
-
 inja::json::array_t PTF::getClone(const std::map<cstring, const TestObject *> &cloneInfos) {
     auto cloneJson = inja::json::array_t();
     for (auto cloneInfoTuple : cloneInfos) {
@@ -246,15 +243,14 @@ class AbstractTest(bt.P4RuntimeTest):
     return PREAMBLE;
 }
 
-void PTF::emitPreamble(const std::string &preamble) {
+void PTF::emitPreamble() {
     inja::json dataJson;
     dataJson["test_name"] = basePath.stem();
     if (seed) {
         dataJson["seed"] = *seed;
     }
 
-    inja::render_to(ptfFileStream, preamble, dataJson);
-    ptfFileStream.flush();
+    writer.write(getPtfFile(), preambleTemplate, std::move(dataJson));
 }
 
 std::string PTF::getTestCaseTemplate() {
@@ -355,8 +351,19 @@ class Test{{test_id}}(AbstractTest):
     return TEST_CASE;
 }
 
+PTF::PTF(std::filesystem::path basePath, std::optional<unsigned int> seed = std::nullopt)
+    : TF(std::move(basePath), seed),
+      preambleTemplate(writer.parse(getPreamble())),
+      testCaseTemplate(writer.parse(getTestCaseTemplate())) {}
+
+std::filesystem::path PTF::getPtfFile() const {
+    auto ptfFile = basePath;
+    ptfFile.replace_extension(".py");
+    return ptfFile;
+}
+
 void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
-                       const std::string &testCase, float currentCoverage) {
+                       float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -382,22 +389,16 @@ void PTF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
 
     LOG5("PTF backend: emitting testcase:" << std::setw(4) << dataJson);
 
-    inja::render_to(ptfFileStream, testCase, dataJson);
-    ptfFileStream.flush();
+    writer.write(getPtfFile(), testCaseTemplate, std::move(dataJson));
 }
 
 void PTF::outputTest(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
                      float currentCoverage) {
     if (!preambleEmitted) {
-        auto ptfFile = basePath;
-        ptfFile.replace_extension(".py");
-        ptfFileStream = std::ofstream(ptfFile);
-        std::string preamble = getPreamble();
-        emitPreamble(preamble);
+        emitPreamble();
         preambleEmitted = true;
     }
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testIdx, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testIdx, currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
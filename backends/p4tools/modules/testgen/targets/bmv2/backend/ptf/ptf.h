@@ -2,7 +2,7 @@
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_BMV2_BACKEND_PTF_PTF_H_
 
 #include <cstddef>
-#include <fstream>
+#include <filesystem>
 #include <map>
 #include <optional>
 #include <string>
@@ -25,8 +25,9 @@ class PTF : public TF {
     /// Has the preamble been generated already?
     bool preambleEmitted = false;
 
-    /// The output file.
-    std::ofstream ptfFileStream;
+    /// The parsed preamble and test case templates.
+    const inja::Template &preambleTemplate;
+    const inja::Template &testCaseTemplate;
 
  public:
     virtual ~PTF() = default;
@@ -48,7 +49,10 @@ class PTF : public TF {
  private:
     /// Emits the test preamble. This is only done once for all generated tests.
     /// For the PTF back end this is the test setup Python script..
-    void emitPreamble(const std::string &preamble);
+    void emitPreamble();
+
+    /// @returns the file all tests are written to.
+    [[nodiscard]] std::filesystem::path getPtfFile() const;
 
     /// Emits a test case.
     /// @param testIdx specifies the test name.
@@ -56,7 +60,7 @@ class PTF : public TF {
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
     void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
-                      const std::string &testCase, float currentCoverage);
+                      float currentCoverage);
 
     /// @returns the inja test case template as a string.
     static std::string getTestCaseTemplate();
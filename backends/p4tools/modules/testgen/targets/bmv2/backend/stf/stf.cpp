@@ -28,7 +28,7 @@
 namespace P4Tools::P4Testgen::Bmv2 {
 
 STF::STF(std::filesystem::path basePath, std::optional<unsigned int> seed = std::nullopt)
-    : TF(std::move(basePath), seed) {}
+    : TF(std::move(basePath), seed), testCaseTemplate(writer.parse(getTestCaseTemplate())) {}
 
 inja::json STF::getControlPlane(const TestSpec *testSpec) {
     inja::json controlPlaneJson = inja::json::object();
@@ -263,7 +263,7 @@ expect {{verify.eg_port}} {{verify.exp_pkt}}$
 }
 
 void STF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
-                       const std::string &testCase, float currentCoverage) {
+                       float currentCoverage) {
     inja::json dataJson;
     if (selectedBranches != nullptr) {
         dataJson["selected_branches"] = selectedBranches.c_str();
@@ -293,15 +293,12 @@ void STF::emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_
     LOG5("STF test back end: emitting testcase:" << std::setw(4) << dataJson);
     auto stfFile = basePath;
     stfFile.replace_extension("_" + std::to_string(testIdx) + ".stf");
-    auto stfFileStream = std::ofstream(stfFile);
-    inja::render_to(stfFileStream, testCase, dataJson);
-    stfFileStream.flush();
+    writer.write(stfFile, testCaseTemplate, std::move(dataJson));
 }
 
 void STF::outputTest(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
                      float currentCoverage) {
-    std::string testCase = getTestCaseTemplate();
-    emitTestcase(testSpec, selectedBranches, testIdx, testCase, currentCoverage);
+    emitTestcase(testSpec, selectedBranches, testIdx, currentCoverage);
 }
 
 }  // namespace P4Tools::P4Testgen::Bmv2
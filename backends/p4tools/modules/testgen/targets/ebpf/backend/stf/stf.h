@@ -2,7 +2,7 @@
 #define BACKENDS_P4TOOLS_MODULES_TESTGEN_TARGETS_EBPF_BACKEND_STF_STF_H_
 
 #include <cstddef>
-#include <fstream>
+#include <filesystem>
 #include <optional>
 #include <string>
 #include <vector>
@@ -18,6 +18,9 @@ namespace P4Tools::P4Testgen::EBPF {
 
 /// Extracts information from the @testSpec to emit a STF test case.
 class STF : public TF {
+    /// The parsed test case template.
+    const inja::Template &testCaseTemplate;
+
  public:
     virtual ~STF() = default;
 
@@ -42,7 +45,7 @@ class STF : public TF {
     /// @param currentCoverage contains statistics  about the current coverage of this test and its
     /// preceding tests.
     void emitTestcase(const TestSpec *testSpec, cstring selectedBranches, size_t testIdx,
-                      const std::string &testCase, float currentCoverage);
+                      float currentCoverage);
 
     /// @returns the inja test case template as a string.
     static std::string getTestCaseTemplate();
@@ -0,0 +1,47 @@
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Test {
+
+using P4Tools::P4Testgen::Checkpoint;
+
+TEST(Checkpoint, RoundTrip) {
+    Checkpoint checkpoint;
+    checkpoint.testCount = 7;
+    checkpoint.statementCount = 10;
+    checkpoint.visitedStatements = {0, 3, 9};
+    checkpoint.frontier = {{1, 2, 1}, {1, 2, 2, 1}, {1, 3}, {2}};
+
+    std::stringstream stream;
+    checkpoint.write(stream);
+    // Each branch only stores the decisions it does not share with the branch before it.
+    EXPECT_NE(stream.str().find("\n2 2 1\n1 3\n0 2\n"), std::string::npos);
+
+    auto result = Checkpoint::read(stream);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->testCount, 7);
+    EXPECT_EQ(result->statementCount, 10u);
+    EXPECT_EQ(result->visitedStatements, checkpoint.visitedStatements);
+    EXPECT_EQ(result->frontier, checkpoint.frontier);
+}
+
+TEST(Checkpoint, RejectsMalformedInput) {
+    for (const auto *text : {
+             "",
+             "p4testgen-checkpoint 2\n",
+             "p4testgen-checkpoint 1\ntests 1\nstatements 2 1\n5\nfrontier 0\n",
+             "p4testgen-checkpoint 1\ntests 1\nstatements 2 0\n\nfrontier 1\n1 1\n",
+             "p4testgen-checkpoint 1\ntests 1\nstatements 2 0\n\nfrontier 2\n0 1\n",
+         }) {
+        std::istringstream stream(text);
+        EXPECT_FALSE(Checkpoint::read(stream)) << text;
+    }
+}
+
+}  // namespace Test
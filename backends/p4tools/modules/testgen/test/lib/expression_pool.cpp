@@ -0,0 +1,80 @@
+#include "backends/p4tools/common/lib/expression_pool.h"
+
+#include <gtest/gtest.h>
+
+#include "backends/p4tools/common/lib/util.h"
+#include "ir/ir.h"
+#include "ir/irutils.h"
+
+#include "backends/p4tools/modules/testgen/test/gtest_utils.h"
+
+namespace Test {
+
+using P4Tools::ExpressionPool;
+using P4Tools::Utils;
+
+namespace {
+
+const IR::Member *field(cstring name) {
+    return new IR::Member(IR::getBitType(8), new IR::PathExpression("hdr"), name);
+}
+
+const IR::Member *flag(cstring name) {
+    return new IR::Member(IR::Type_Boolean::get(), new IR::PathExpression("hdr"), name);
+}
+
+}  // namespace
+
+class ExpressionPoolTest : public P4ToolsTest {};
+
+TEST_F(ExpressionPoolTest, SharesEqualExpressions) {
+    auto build = []() {
+        const auto *sum =
+            new IR::Add(IR::getBitType(8), field("a"), IR::getConstant(IR::getBitType(8), 1));
+        return new IR::Equ(IR::Type_Boolean::get(), sum, field("b"));
+    };
+    auto before = ExpressionPool::getStatistics();
+    const auto *first = ExpressionPool::simplify(build());
+    const auto *second = ExpressionPool::simplify(build());
+    EXPECT_EQ(first, second);
+    EXPECT_TRUE(first->equiv(*build()));
+    // Subterms are shared as well.
+    const auto *a = ExpressionPool::simplify(field("a"));
+    EXPECT_EQ(a, first->to<IR::Equ>()->left->to<IR::Add>()->left);
+    auto after = ExpressionPool::getStatistics();
+    EXPECT_GT(after.inputNodes, before.inputNodes);
+    EXPECT_GT(after.sharedNodes, before.sharedNodes);
+}
+
+TEST_F(ExpressionPoolTest, RewritesRedundantConditions) {
+    const auto *boolType = IR::Type_Boolean::get();
+    const auto *valid = flag("*valid");
+    const auto *other = flag("other");
+    // valid && (valid && other) is valid && other.
+    const auto *nested = ExpressionPool::simplify(
+        new IR::LAnd(boolType, valid, new IR::LAnd(boolType, valid, other)));
+    EXPECT_EQ(nested, ExpressionPool::simplify(new IR::LAnd(boolType, valid, other)));
+    // valid && !valid is false.
+    const auto *contradiction = ExpressionPool::simplify(
+        new IR::LAnd(boolType, valid, new IR::LNot(boolType, valid)));
+    EXPECT_TRUE(contradiction->equiv(*IR::getBoolLiteral(false)));
+    // a == a is true, even if both sides were built separately.
+    const auto *reflexive =
+        ExpressionPool::simplify(new IR::Equ(boolType, field("a"), field("a")));
+    EXPECT_TRUE(reflexive->equiv(*IR::getBoolLiteral(true)));
+    // valid ? (valid ? a : b) : c is valid ? a : c.
+    const auto *mux = ExpressionPool::simplify(new IR::Mux(
+        IR::getBitType(8), valid, new IR::Mux(IR::getBitType(8), valid, field("a"), field("b")),
+        field("c")));
+    EXPECT_EQ(mux, ExpressionPool::simplify(
+                       new IR::Mux(IR::getBitType(8), valid, field("a"), field("c"))));
+}
+
+TEST_F(ExpressionPoolTest, KeepsTaintedExpressions) {
+    const auto *taint = Utils::getTaintExpression(IR::getBitType(8));
+    const auto *result =
+        ExpressionPool::simplify(new IR::Equ(IR::Type_Boolean::get(), taint, taint));
+    EXPECT_TRUE(result->is<IR::Equ>());
+}
+
+}  // namespace Test
@@ -0,0 +1,88 @@
+#include "backends/p4tools/modules/testgen/lib/test_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <inja/inja.hpp>
+
+namespace Test {
+
+using P4Tools::P4Testgen::TestWriter;
+
+namespace {
+
+/// A fresh, empty directory for the files of one test.
+std::filesystem::path makeTestDir(const std::string &name) {
+    auto dir = std::filesystem::temp_directory_path() / ("p4testgen-test-writer-" + name);
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+std::string readFile(const std::filesystem::path &path) {
+    std::ifstream in(path);
+    std::stringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+}  // namespace
+
+TEST(TestWriter, WritesFiles) {
+    auto dir = makeTestDir("files");
+    {
+        TestWriter writer;
+        const auto &header = writer.parse("# {{name}}\n");
+        const auto &test = writer.parse("test {{id}}\n");
+        writer.write(dir / "all.py", header, {{"name", "all"}});
+        for (int id = 1; id <= 3; id++) {
+            writer.write(dir / "all.py", test, {{"id", id}});
+            writer.write(dir / ("single_" + std::to_string(id) + ".stf"), test, {{"id", id}});
+        }
+        writer.flush();
+        EXPECT_EQ(readFile(dir / "all.py"), "# all\ntest 1\ntest 2\ntest 3\n");
+        EXPECT_EQ(readFile(dir / "single_2.stf"), "test 2\n");
+        writer.write(dir / "single_4.stf", test, {{"id", 4}});
+    }
+    // Destroying the writer writes the remaining tests.
+    EXPECT_EQ(readFile(dir / "single_4.stf"), "test 4\n");
+    std::filesystem::remove_all(dir);
+}
+
+TEST(TestWriter, StreamsJsonLines) {
+    auto dir = makeTestDir("stream");
+    auto streamFile = dir / "tests.jsonl";
+    {
+        TestWriter writer(streamFile);
+        const auto &test = writer.parse("packet \"{{id}}\"\n");
+        // More tests than fit into the queue.
+        for (size_t id = 0; id < 2 * TestWriter::MAX_PENDING; id++) {
+            writer.write(dir / ("test_" + std::to_string(id) + ".stf"), test, {{"id", id}});
+        }
+    }
+    EXPECT_FALSE(std::filesystem::exists(dir / "test_0.stf"));
+    std::ifstream in(streamFile);
+    size_t id = 0;
+    for (std::string line; std::getline(in, line); id++) {
+        auto record = inja::json::parse(line);
+        EXPECT_EQ(record["file"], "test_" + std::to_string(id) + ".stf");
+        EXPECT_EQ(record["test"], "packet \"" + std::to_string(id) + "\"\n");
+    }
+    EXPECT_EQ(id, 2 * TestWriter::MAX_PENDING);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(TestWriter, ReportsWriteErrors) {
+    auto dir = makeTestDir("errors");
+    TestWriter writer;
+    const auto &test = writer.parse("test\n");
+    writer.write(dir / "missing" / "test.stf", test, {});
+    EXPECT_ANY_THROW(writer.flush());
+    std::filesystem::remove_all(dir);
+}
+
+}  // namespace Test
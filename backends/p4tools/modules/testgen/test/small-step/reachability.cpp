@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <fstream>
 #include <functional>
+#include <map>
 
 #include "backends/p4test/version.h"
 #include "backends/p4tools/common/compiler/midend.h"
@@ -21,6 +22,7 @@
 #include "lib/compile_context.h"
 #include "lib/enumerator.h"
 #include "lib/exceptions.h"
+#include "midend/coverage.h"
 #include "test/gtest/env.h"
 
 namespace Test {
@@ -275,6 +277,43 @@ TEST_F(P4CReachability, testIfStatement) {
     ASSERT_TRUE(!dcg->isReachable(myAction2, myAction1));
 }
 
+TEST_F(P4CReachability, testStatementReachability) {
+    auto result = loadExampleForReachability(
+        "backends/p4tools/modules/testgen/targets/bmv2/test/p4-programs/bmv2_if.p4");
+    const auto *program = get<0>(result);
+    ASSERT_TRUE(program);
+    const auto *dcg = std::get<1>(result);
+    ASSERT_TRUE(dcg);
+    P4::Coverage::CoverageSet statements;
+    program->apply(P4::Coverage::CollectStatements(statements));
+    P4Tools::StatementReachability reachability(*dcg, statements);
+    ASSERT_EQ(reachability.size(), statements.size());
+    // Find the assignments of the actions MyAction1 to MyAction6 by their value.
+    NodeFinder<IR::AssignmentStatement> findAssignments;
+    program->apply(findAssignments);
+    std::map<int, const IR::AssignmentStatement *> actionAssignments;
+    for (const auto *assignment : findAssignments.v) {
+        if (const auto *value = assignment->right->to<IR::Constant>()) {
+            actionAssignments.emplace(value->asInt(), assignment);
+        }
+    }
+    auto reaches = [&](int from, int to) {
+        const auto *reachable = reachability.getReachable(actionAssignments.at(from));
+        auto index = reachability.getIndex(actionAssignments.at(to));
+        return reachable != nullptr && index.has_value() && reachable->getbit(*index);
+    };
+    // A statement reaches itself.
+    ASSERT_TRUE(reaches(1, 1));
+    // The actions of both tables are reachable from MyAction1.
+    ASSERT_TRUE(reaches(1, 3));
+    ASSERT_TRUE(reaches(1, 4));
+    ASSERT_TRUE(reaches(1, 5));
+    // MyAction2 is not reachable from MyAction1.
+    ASSERT_TRUE(!reaches(1, 2));
+    // MyAction1 is not reachable from the actions of table1.
+    ASSERT_TRUE(!reaches(3, 1));
+}
+
 TEST_F(P4CReachability, testParserValueSet) {
     auto result = loadExampleForReachability("testdata/p4_16_samples/value-sets.p4");
     const auto *program = get<0>(result);
@@ -33,6 +33,9 @@ class Z3SolverAccessor {
     /// Gets checkpoints that have been made. Used by GTests only.
     std::vector<size_t> &getCheckpoints() { return solver.checkpoints; }
 
+    /// Gets the number of cached assertion translations. Used by GTests only.
+    size_t getTranslationCount() { return solver.translations.size(); }
+
  private:
     /// Pointer to a solver.
     Z3Solver &solver;
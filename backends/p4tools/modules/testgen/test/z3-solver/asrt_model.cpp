@@ -206,6 +206,31 @@ TEST_F(Z3SolverTest, Assertion2Model) {
     ASSERT_TRUE((intA1 + intAddToA) % 16 < intB1);
 }
 
+/// Assertions that are popped and asserted again reuse their translation, and still declare
+/// their variables.
+TEST_F(Z3SolverTest, ReassertAfterPop) {
+    ASSERT_TRUE(opLss);
+
+    Z3Solver solver;
+    Z3SolverAccessor solverAccessor(solver);
+    const auto *opNot = new IR::LNot(IR::Type_Boolean::get(), opLss);
+    const StateVariable varB = opLss->right->to<IR::Member>();
+
+    ASSERT_EQ(solver.checkSat({opLss}), true);
+    ASSERT_EQ(solverAccessor.getTranslationCount(), 1u);
+    ASSERT_EQ(solver.checkSat({opNot}), true);
+    ASSERT_EQ(solverAccessor.getTranslationCount(), 2u);
+    ASSERT_EQ(solver.checkSat({opLss, opNot}), false);
+    ASSERT_EQ(solverAccessor.getTranslationCount(), 2u);
+
+    ASSERT_EQ(solver.checkSat({opLss}), true);
+    EXPECT_EQ(solverAccessor.getTranslationCount(), 2u);
+    EXPECT_EQ(solverAccessor.getP4Assertions().size(), 1u);
+    Model model = *solver.getModel();
+    EXPECT_EQ(model.size(), 2u);
+    EXPECT_GT(model.count(varB), 0u);
+}
+
 }  // anonymous namespace
 
 }  // namespace Test
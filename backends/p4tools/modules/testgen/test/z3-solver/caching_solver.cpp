@@ -0,0 +1,134 @@
+#include "backends/p4tools/common/core/caching_solver.h"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+#include "backends/p4tools/common/core/z3_solver.h"
+#include "backends/p4tools/common/lib/formulae.h"
+#include "backends/p4tools/common/lib/model.h"
+#include "ir/ir.h"
+
+#include "backends/p4tools/modules/testgen/test/gtest_utils.h"
+
+namespace Test {
+
+using P4Tools::CachingSolver;
+using P4Tools::Constraint;
+using P4Tools::Model;
+using P4Tools::Z3Solver;
+
+namespace {
+
+/// A Z3 solver that counts the queries it answers and the models it builds.
+class CountingSolver : public Z3Solver {
+ public:
+    size_t queries = 0;
+    mutable size_t models = 0;
+
+    std::optional<bool> checkSat(const std::vector<const Constraint *> &asserts) override {
+        queries++;
+        return Z3Solver::checkSat(asserts);
+    }
+
+    const Model *getModel() const override {
+        models++;
+        return Z3Solver::getModel();
+    }
+};
+
+const IR::Member *field(cstring name) {
+    return new IR::Member(IR::Type_Bits::get(8), new IR::PathExpression("hdr"), name);
+}
+
+const Constraint *equals(const IR::Member *var, int value) {
+    return new IR::Equ(IR::Type_Boolean::get(), var, new IR::Constant(var->type, value));
+}
+
+}  // namespace
+
+class CachingSolverTest : public P4ToolsTest {};
+
+TEST_F(CachingSolverTest, SolvesIndependentGroupsOnce) {
+    CountingSolver z3Solver;
+    CachingSolver solver(z3Solver);
+    const auto *a = field("a");
+    const auto *b = field("b");
+    const auto *aIs1 = equals(a, 1);
+    const auto *bIs2 = equals(b, 2);
+
+    // The two assertions share no variables, so they are solved separately.
+    std::vector<const Constraint *> asserts = {aIs1, bIs2};
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    EXPECT_EQ(z3Solver.queries, 2u);
+    const auto *model = solver.getModel();
+    EXPECT_EQ(model->evaluate(a)->checkedTo<IR::Constant>()->asInt(), 1);
+    EXPECT_EQ(model->evaluate(b)->checkedTo<IR::Constant>()->asInt(), 2);
+
+    // Only the group of the new assertion reaches the solver.
+    asserts.push_back(new IR::Neq(IR::Type_Boolean::get(), b, new IR::Constant(b->type, 3)));
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    EXPECT_EQ(z3Solver.queries, 3u);
+    model = solver.getModel();
+    EXPECT_EQ(model->evaluate(a)->checkedTo<IR::Constant>()->asInt(), 1);
+    EXPECT_EQ(model->evaluate(b)->checkedTo<IR::Constant>()->asInt(), 2);
+
+    // Repeated queries and subsets of satisfiable groups are answered from the cache.
+    ASSERT_EQ(solver.checkSat(asserts), true);
+    ASSERT_EQ(solver.checkSat({bIs2}), true);
+    EXPECT_EQ(z3Solver.queries, 3u);
+    EXPECT_EQ(solver.getModel()->evaluate(b)->checkedTo<IR::Constant>()->asInt(), 2);
+    EXPECT_EQ(solver.getCacheHits(), 4u);
+    EXPECT_EQ(solver.getSolverQueries(), 3u);
+}
+
+TEST_F(CachingSolverTest, FetchesModelsOnDemand) {
+    CountingSolver z3Solver;
+    CachingSolver solver(z3Solver);
+    const auto *a = field("a");
+    const auto *b = field("b");
+    const auto *aIs1 = equals(a, 1);
+
+    // Checking feasibility does not build a model.
+    ASSERT_EQ(solver.checkSat({aIs1}), true);
+    EXPECT_EQ(z3Solver.models, 0u);
+
+    // A cache entry whose model was never fetched is solved again when its model is needed.
+    ASSERT_EQ(solver.checkSat({aIs1, equals(b, 2)}), true);
+    EXPECT_EQ(z3Solver.queries, 2u);
+    const auto *model = solver.getModel();
+    EXPECT_EQ(z3Solver.queries, 3u);
+    EXPECT_EQ(z3Solver.models, 2u);
+    EXPECT_EQ(model->evaluate(a)->checkedTo<IR::Constant>()->asInt(), 1);
+    EXPECT_EQ(model->evaluate(b)->checkedTo<IR::Constant>()->asInt(), 2);
+
+    // Fetched models are cached and the model of a query is only built once.
+    EXPECT_EQ(solver.getModel(), model);
+    ASSERT_EQ(solver.checkSat({aIs1}), true);
+    EXPECT_EQ(solver.getModel()->evaluate(a)->checkedTo<IR::Constant>()->asInt(), 1);
+    EXPECT_EQ(z3Solver.queries, 3u);
+    EXPECT_EQ(z3Solver.models, 2u);
+}
+
+TEST_F(CachingSolverTest, SupersetOfUnsatGroupIsUnsat) {
+    CountingSolver z3Solver;
+    CachingSolver solver(z3Solver);
+    const auto *a = field("a");
+    const auto *aIs1 = equals(a, 1);
+    const auto *aIs3 = equals(a, 3);
+
+    ASSERT_EQ(solver.checkSat({aIs1, aIs3}), false);
+    EXPECT_EQ(z3Solver.queries, 1u);
+
+    // The unsatisfiable group decides the query without solving the other groups.
+    ASSERT_EQ(solver.checkSat({equals(field("b"), 2), aIs3, aIs1}), false);
+    ASSERT_EQ(solver.checkSat({aIs1, new IR::Equ(IR::Type_Boolean::get(), a, a), aIs3}), false);
+    EXPECT_EQ(z3Solver.queries, 1u);
+
+    // A subset of an unsatisfiable group may be satisfiable.
+    ASSERT_EQ(solver.checkSat({aIs3}), true);
+    EXPECT_EQ(z3Solver.queries, 2u);
+}
+
+}  // namespace Test
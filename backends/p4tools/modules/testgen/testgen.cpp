@@ -1,5 +1,6 @@
 #include "backends/p4tools/modules/testgen/testgen.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
 #include <iostream>
@@ -7,6 +8,7 @@
 #include <string>
 #include <utility>
 
+#include "backends/p4tools/common/core/caching_solver.h"
 #include "backends/p4tools/common/core/solver.h"
 #include "backends/p4tools/common/core/z3_solver.h"
 #include "backends/p4tools/common/lib/util.h"
@@ -18,11 +20,13 @@
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/depth_first.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/greedy_stmt_cov.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/max_stmt_cov.h"
+#include "backends/p4tools/modules/testgen/core/symbolic_executor/parallel_depth_first.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/path_selection.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/random_backtrack.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/selected_branches.h"
 #include "backends/p4tools/modules/testgen/core/symbolic_executor/symbolic_executor.h"
 #include "backends/p4tools/modules/testgen/core/target.h"
+#include "backends/p4tools/modules/testgen/lib/checkpoint.h"
 #include "backends/p4tools/modules/testgen/lib/logging.h"
 #include "backends/p4tools/modules/testgen/lib/test_backend.h"
 #include "backends/p4tools/modules/testgen/options.h"
@@ -52,6 +56,9 @@ SymbolicExecutor *pickExecutionEngine(const TestgenOptions &testgenOptions,
         std::string selectedBranchesStr = testgenOptions.selectedBranches;
         return new SelectedBranches(solver, *programInfo, selectedBranchesStr);
     }
+    if (testgenOptions.parallel > 1) {
+        return new ParallelDepthFirstSearch(solver, *programInfo, testgenOptions.parallel);
+    }
     return new DepthFirstSearch(solver, *programInfo);
 }
 
@@ -90,22 +97,84 @@ int Testgen::mainImpl(const IR::P4Program *program) {
         std::filesystem::create_directories(testDir);
         testPath = testDir / testPath;
     }
-    // Need to declare the solver here to ensure its lifetime.
-    Z3Solver solver;
+    bool checkpointing = !testgenOptions.checkpointFile.empty();
+    if ((checkpointing || !testgenOptions.resumeFile.empty()) &&
+        (testgenOptions.pathSelectionPolicy != PathSelectionPolicy::DepthFirst ||
+         testgenOptions.parallel > 1 || !testgenOptions.selectedBranches.empty())) {
+        ::error(
+            "--checkpoint and --resume only apply to the DEPTH_FIRST path selection without "
+            "--parallel or --input-branches.");
+        return EXIT_FAILURE;
+    }
+
+    // Need to declare the solvers here to ensure their lifetime.
+    Z3Solver z3Solver;
+    CachingSolver cachingSolver(z3Solver);
+    AbstractSolver &solver =
+        testgenOptions.solverCache ? static_cast<AbstractSolver &>(cachingSolver) : z3Solver;
     auto *symExec = pickExecutionEngine(testgenOptions, programInfo, solver);
 
     // Define how to handle the final state for each test. This is target defined.
     auto *testBackend = TestgenTarget::getTestBackend(*programInfo, *symExec, testPath, seed);
+    if (!testgenOptions.resumeFile.empty()) {
+        auto checkpoint = Checkpoint::load(testgenOptions.resumeFile);
+        if (!checkpoint) {
+            ::error("Unable to read checkpoint %1%.", testgenOptions.resumeFile);
+            return EXIT_FAILURE;
+        }
+        symExec->resume(*checkpoint);
+        if (::errorCount() > 0) {
+            return EXIT_FAILURE;
+        }
+        // --max-tests counts the tests of the whole exploration, not only those of this run.
+        if (testgenOptions.maxTests > 0 && checkpoint->testCount >= testgenOptions.maxTests) {
+            printFeature("test_info", 4,
+                         "============ The checkpoint already has %1% tests ============\n",
+                         checkpoint->testCount);
+            return EXIT_SUCCESS;
+        }
+        testBackend->setTestCount(checkpoint->testCount);
+        printFeature("test_info", 4,
+                     "============ Resuming with %1% unexplored branches after %2% tests "
+                     "============\n",
+                     checkpoint->frontier.size(), checkpoint->testCount);
+    }
     // Each test back end has a different run function.
     // We delegate execution to the symbolic executor.
-    auto callBack = [testBackend](auto &&finalState) {
-        return testBackend->run(std::forward<decltype(finalState)>(finalState));
+    // Checkpoints are written between paths, when the unexplored branches of the executor are
+    // its whole frontier.
+    // A checkpoint must not count tests that are still waiting to be written.
+    auto saveCheckpoint = [symExec, testBackend, &testgenOptions]() {
+        testBackend->flushTests();
+        auto checkpoint = symExec->checkpoint();
+        checkpoint.testCount = testBackend->getTestCount();
+        if (!checkpoint.save(testgenOptions.checkpointFile)) {
+            ::warning("Unable to write checkpoint %1%.", testgenOptions.checkpointFile);
+        }
+    };
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+    auto callBack = [testBackend, checkpointing, &saveCheckpoint, &lastCheckpoint,
+                     &testgenOptions](auto &&finalState) {
+        bool terminate = testBackend->run(std::forward<decltype(finalState)>(finalState));
+        auto now = std::chrono::steady_clock::now();
+        if (checkpointing && !terminate &&
+            now - lastCheckpoint >= std::chrono::seconds(testgenOptions.checkpointInterval)) {
+            saveCheckpoint();
+            lastCheckpoint = now;
+        }
+        return terminate;
     };
 
     try {
         // Run the symbolic executor with given exploration strategy.
         symExec->run(callBack);
     } catch (...) {
+        // Keep the tests that were generated before the failure.
+        try {
+            testBackend->flushTests();
+        } catch (...) {
+            // Report the original failure instead.
+        }
         if (testgenOptions.trackBranches) {
             // Print list of the selected branches and store all information into
             // dumpFolder/selectedBranches.txt file.
@@ -115,6 +184,10 @@ int Testgen::mainImpl(const IR::P4Program *program) {
         }
         throw;
     }
+    testBackend->flushTests();
+    if (checkpointing) {
+        saveCheckpoint();
+    }
     // Emit a performance report, if desired.
     testBackend->printPerformanceReport(true);
 
@@ -56,6 +56,14 @@ CompilerOptions::CompilerOptions() : ParserOptions() {
             return true;
         },
         "Dump the compiler IR after the midend as JSON in the specified file.");
+    registerOption(
+        "--toBinary", "file",
+        [this](const char *arg) {
+            dumpBinaryFile = arg;
+            return true;
+        },
+        "Dump the compiler IR after the frontend as a binary snapshot in the specified\n"
+        "file; backends that support --fromBinary can restart from it.");
     registerOption(
         "--ndebug", nullptr,
         [this](const char *) {
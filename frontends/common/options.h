@@ -53,6 +53,8 @@ class CompilerOptions : public ParserOptions {
     std::vector<cstring> passesToExcludeBackend;
     // Dump a JSON representation of the IR in the file.
     cstring dumpJsonFile = nullptr;
+    // Dump a binary snapshot of the IR after the frontend in the file.
+    cstring dumpBinaryFile = nullptr;
     // Dump and undump the IR tree.
     bool debugJson = false;
     // if this flag is true, compile program in non-debug mode.
@@ -17,9 +17,13 @@ limitations under the License.
 #ifndef _FRONTENDS_COMMON_PARSEINPUT_H_
 #define _FRONTENDS_COMMON_PARSEINPUT_H_
 
+#include <sstream>
+#include <string>
+
 #include "frontends/common/options.h"
 #include "frontends/p4/fromv1.0/converters.h"
 #include "frontends/p4/frontend.h"
+#include "frontends/p4/frontendCache.h"
 #include "frontends/parsers/parserDriver.h"
 #include "lib/error.h"
 #include "lib/source_file.h"
@@ -77,9 +81,21 @@ const IR::P4Program *parseP4File(ParserOptions &options) {
         if (::errorCount() > 0 || in == nullptr) return nullptr;
     }
 
-    auto result = options.isv1()
-                      ? parseV1Program<FILE *, C>(in, options.file, 1, options.getDebugHook())
-                      : P4ParserDriver::parse(in, options.file);
+    const IR::P4Program *result = nullptr;
+    if (options.isv1()) {
+        result = parseV1Program<FILE *, C>(in, options.file, 1, options.getDebugHook());
+    } else if (options.frontendCacheDir) {
+        // The frontend cache is keyed on the preprocessed text, so read all of it first.
+        std::string text;
+        char buf[64 * 1024];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), in)) > 0) text.append(buf, n);
+        options.sourceHash = FrontEndCache::hashSource(text);
+        std::istringstream stream(text);
+        result = P4ParserDriver::parse(stream, options.file);
+    } else {
+        result = P4ParserDriver::parse(in, options.file);
+    }
     options.closeInput(in);
 
     if (::errorCount() > 0) {
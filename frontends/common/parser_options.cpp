@@ -27,6 +27,7 @@ limitations under the License.
 
 #include "frontends/p4/toP4/toP4.h"
 #include "ir/json_generator.h"
+#include "ir/pass_profile.h"
 #include "lib/exceptions.h"
 #include "lib/exename.h"
 #include "lib/log.h"
@@ -283,6 +284,36 @@ ParserOptions::ParserOptions() : Util::Options(defaultMessage) {
         "When the optimization is enabled, compiler tries to identify the cases,\n"
         "when it can inline the subparser's states only once for multiple\n"
         "invocations of the same subparser instance.");
+    registerOption(
+        "--pass-profile", "file",
+        [](const char *arg) {
+            PassProfile::enable(arg);
+            return true;
+        },
+        "[Compiler debugging] Record wall time, CPU time, bytes allocated, IR nodes\n"
+        "created and IR nodes visited by every pass, and write them to file as a\n"
+        "Chrome trace (viewable in chrome://tracing or ui.perfetto.dev).");
+    registerOption(
+        "--incremental-typemap", nullptr,
+        [this](const char *) {
+            incrementalTypeMap = true;
+            return true;
+        },
+        "[Compiler debugging] In the frontend only: when a pass changes only the\n"
+        "bodies of some controls, parsers, actions or functions, keep the types of\n"
+        "the unchanged objects instead of clearing the type map.  Type inference\n"
+        "still visits the whole program, and the midend type maps and all\n"
+        "reference maps are recomputed as before.");
+    registerOption(
+        "--frontend-cache", "dir",
+        [this](const char *arg) {
+            frontendCacheDir = arg;
+            return true;
+        },
+        "Cache the output of the frontend in the specified directory, keyed on the\n"
+        "preprocessed program, the compiler version and the frontend options, and\n"
+        "reuse it when the same program is compiled again, e.g., for another target.\n"
+        "P4-14 programs are not cached.");
     registerOption(
         "--doNotEmitIncludes", "condition",
         [this](const char *arg) {
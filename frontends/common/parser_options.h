@@ -73,6 +73,14 @@ class ParserOptions : public Util::Options {
     cstring dumpFolder = ".";
     // If false, optimization of callee parsers (subparsers) inlining is disabled.
     bool optimizeParserInlining = false;
+    // If true, the frontend type map is patched instead of recomputed when passes only
+    // change the bodies of some controls, parsers, actions or functions.  Midend type maps
+    // and reference maps are not affected.
+    bool incrementalTypeMap = false;
+    // Directory of the frontend result cache; null if the cache is disabled.
+    cstring frontendCacheDir = nullptr;
+    // Hash of the preprocessed input, set by parseP4File when the frontend cache is enabled.
+    cstring sourceHash = nullptr;
     // Expect that the only remaining argument is the input file.
     void setInputFile();
     // Return target specific include path.
@@ -21,6 +21,7 @@ limitations under the License.
 #include "ir/ir.h"
 #include "ir/visitor.h"
 #include "lib/cstring.h"
+#include "lib/flat_ordered_map.h"
 #include "lib/map.h"
 
 namespace P4 {
@@ -67,7 +68,7 @@ class ReferenceMap final : public ProgramMap, public NameGenerator, public Decla
     bool isv1;
 
     /// Maps paths in the program to declarations.
-    ordered_map<const IR::Path *, const IR::IDeclaration *> pathToDeclaration;
+    flat_ordered_map<const IR::Path *, const IR::IDeclaration *> pathToDeclaration;
 
     /// Set containing all declarations in the program.
     std::set<const IR::IDeclaration *> used;
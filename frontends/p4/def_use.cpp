@@ -16,6 +16,8 @@ limitations under the License.
 
 #include "def_use.h"
 
+#include <algorithm>
+
 #include <boost/functional/hash.hpp>
 
 #include "frontends/p4/methodInstance.h"
@@ -256,8 +258,15 @@ bool LocationSet::overlaps(const LocationSet *other) const {
 }
 
 const ProgramPoints *ProgramPoints::merge(const ProgramPoints *with) const {
-    auto result = new ProgramPoints(points);
-    for (auto p : with->points) result->points.emplace(p);
+    // Joins mostly merge a set with itself or with a subset, so avoid allocating then.
+    if (this == with || std::includes(ids.begin(), ids.end(), with->ids.begin(), with->ids.end()))
+        return this;
+    if (std::includes(with->ids.begin(), with->ids.end(), ids.begin(), ids.end())) return with;
+    auto result = new ProgramPoints();
+    result->table = table ? table : with->table;
+    result->ids.reserve(ids.size() + with->ids.size());
+    std::set_union(ids.begin(), ids.end(), with->ids.begin(), with->ids.end(),
+                   std::back_inserter(result->ids));
     return result;
 }
 
@@ -279,13 +288,6 @@ std::size_t ProgramPoint::hash() const {
     return result;
 }
 
-bool ProgramPoints::operator==(const ProgramPoints &other) const {
-    if (points.size() != other.points.size()) return false;
-    for (auto p : points)
-        if (other.points.find(p) == other.points.end()) return false;
-    return true;
-}
-
 Definitions *Definitions::joinDefinitions(const Definitions *other) const {
     auto result = new Definitions();
     for (auto d : other->definitions) {
@@ -339,10 +341,9 @@ const ProgramPoints *Definitions::getPoints(const LocationSet *locations) const
     return result;
 }
 
-Definitions *Definitions::writes(ProgramPoint point, const LocationSet *locations) const {
+Definitions *Definitions::writes(const ProgramPoints *points,
+                                 const LocationSet *locations) const {
     auto result = new Definitions(*this);
-    auto points = new ProgramPoints();
-    points->add(point);
     auto canon = locations->canonicalize();
     for (auto l : *canon) result->setDefinition(l->to<BaseLocation>(), points);
     return result;
@@ -353,7 +354,7 @@ bool Definitions::operator==(const Definitions &other) const {
     for (auto d : definitions) {
         auto od = ::get(other.definitions, d.first);
         if (od == nullptr) return false;
-        if (!d.second->operator==(*od)) return false;
+        if (d.second != od && !d.second->operator==(*od)) return false;
     }
     return true;
 }
@@ -370,8 +371,8 @@ void ComputeWriteSet::enterScope(const IR::ParameterList *parameters,
     if (!clear) defs = currentDefinitions;
     if (defs == nullptr) defs = new Definitions();
 
-    auto startPoints = new ProgramPoints(entryPoint);
-    auto uninit = new ProgramPoints(ProgramPoint::beforeStart);
+    auto startPoints = allDefinitions->getPoints(entryPoint);
+    auto uninit = allDefinitions->getPoints(ProgramPoint::beforeStart);
 
     if (parameters != nullptr) {
         for (auto p : parameters->parameters) {
@@ -796,7 +797,7 @@ bool ComputeWriteSet::preorder(const IR::IfStatement *statement) {
     visit(statement->condition);
     auto cond = getWrites(statement->condition);
     // defs are the definitions after evaluating the condition
-    auto defs = currentDefinitions->writes(getProgramPoint(), cond);
+    auto defs = currentDefinitions->writes(allDefinitions->getPoints(getProgramPoint()), cond);
     (void)setDefinitions(defs, statement->condition, false);
     visit(statement->ifTrue);
     auto result = currentDefinitions;
@@ -845,7 +846,7 @@ bool ComputeWriteSet::preorder(const IR::AssignmentStatement *statement) {
     auto l = getWrites(statement->left);
     auto r = getWrites(statement->right);
     locs = l->join(r);
-    auto defs = currentDefinitions->writes(getProgramPoint(), locs);
+    auto defs = currentDefinitions->writes(allDefinitions->getPoints(getProgramPoint()), locs);
     return setDefinitions(defs);
 }
 
@@ -854,7 +855,8 @@ bool ComputeWriteSet::preorder(const IR::SwitchStatement *statement) {
     if (currentDefinitions->isUnreachable()) return setDefinitions(currentDefinitions);
     visit(statement->expression);
     auto locs = getWrites(statement->expression);
-    auto defs = currentDefinitions->writes(getProgramPoint(statement->expression), locs);
+    auto defs = currentDefinitions->writes(
+        allDefinitions->getPoints(getProgramPoint(statement->expression)), locs);
     (void)setDefinitions(defs, statement->expression, false);
     auto save = currentDefinitions;
     auto result = new Definitions();
@@ -979,7 +981,7 @@ bool ComputeWriteSet::preorder(const IR::MethodCallStatement *statement) {
     lhs = false;
     visit(statement->methodCall);
     auto locs = getWrites(statement->methodCall);
-    auto defs = currentDefinitions->writes(getProgramPoint(), locs);
+    auto defs = currentDefinitions->writes(allDefinitions->getPoints(getProgramPoint()), locs);
     return setDefinitions(defs, statement, true);  // overwrite
 }
 
@@ -17,10 +17,13 @@ limitations under the License.
 #ifndef _FRONTENDS_P4_DEF_USE_H_
 #define _FRONTENDS_P4_DEF_USE_H_
 
-#include <unordered_set>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
 
 #include "frontends/p4/typeChecking/typeChecker.h"
 #include "ir/ir.h"
+#include "lib/flat_ordered_map.h"
 #include "lib/ordered_map.h"
 #include "lib/ordered_set.h"
 
@@ -230,7 +233,7 @@ class LocationSet : public IHasDbPrint {
 /// Maps a declaration to its associated storage.
 class StorageMap : public IHasDbPrint {
     /// Storage location for each declaration.
-    ordered_map<const IR::IDeclaration *, StorageLocation *> storage;
+    flat_ordered_map<const IR::IDeclaration *, StorageLocation *> storage;
     StorageFactory factory;
 
  public:
@@ -327,35 +330,92 @@ struct hash<P4::ProgramPoint> {
 }  // namespace std
 
 namespace P4 {
+/// Numbers the program points seen by one analysis, so that sets of points can be
+/// represented as sorted vectors of small integers.
+class ProgramPointTable {
+    std::unordered_map<ProgramPoint, unsigned> ids;
+    /// Points to the keys of ids, indexed by id.
+    std::vector<const ProgramPoint *> points;
+
+ public:
+    /// Id of ProgramPoint::beforeStart.
+    static constexpr unsigned beforeStartId = 0;
+
+    ProgramPointTable() { getId(ProgramPoint::beforeStart); }
+    ProgramPointTable(const ProgramPointTable &) = delete;
+    ProgramPointTable &operator=(const ProgramPointTable &) = delete;
+
+    unsigned getId(const ProgramPoint &point) {
+        auto it = ids.emplace(point, points.size());
+        if (it.second) points.push_back(&it.first->first);
+        return it.first->second;
+    }
+    const ProgramPoint &getPoint(unsigned id) const { return *points.at(id); }
+    size_t size() const { return points.size(); }
+};
+
+/// An immutable set of program points of one ProgramPointTable.
 class ProgramPoints : public IHasDbPrint {
-    typedef std::unordered_set<ProgramPoint> Points;
-    Points points;
-    explicit ProgramPoints(const Points &points) : points(points) {}
+    ProgramPointTable *table = nullptr;  // may be null for the empty set
+    /// Ids of the points in the set, in increasing order.
+    std::vector<unsigned> ids;
 
  public:
+    class const_iterator {
+        const ProgramPointTable *table;
+        std::vector<unsigned>::const_iterator it;
+
+     public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ProgramPoint;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ProgramPoint *;
+        using reference = const ProgramPoint &;
+
+        const_iterator(const ProgramPointTable *table, std::vector<unsigned>::const_iterator it)
+            : table(table), it(it) {}
+        reference operator*() const { return table->getPoint(*it); }
+        pointer operator->() const { return &table->getPoint(*it); }
+        const_iterator &operator++() {
+            ++it;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto rv = *this;
+            ++it;
+            return rv;
+        }
+        bool operator==(const const_iterator &i) const { return it == i.it; }
+        bool operator!=(const const_iterator &i) const { return it != i.it; }
+    };
+
     ProgramPoints() = default;
-    explicit ProgramPoints(ProgramPoint point) { points.emplace(point); }
-    void add(ProgramPoint point) { points.emplace(point); }
+    ProgramPoints(ProgramPointTable *table, const ProgramPoint &point)
+        : table(table), ids{table->getId(point)} {
+        CHECK_NULL(table);
+    }
+    /// @returns the union of this and @p with; one of the operands if it contains the other.
     const ProgramPoints *merge(const ProgramPoints *with) const;
-    bool operator==(const ProgramPoints &other) const;
+    bool operator==(const ProgramPoints &other) const { return ids == other.ids; }
     void dbprint(std::ostream &out) const override {
         out << "{";
-        for (auto p : points) out << p << " ";
+        for (auto &p : *this) out << p << " ";
         out << "}";
     }
-    size_t size() const { return points.size(); }
+    size_t size() const { return ids.size(); }
     bool containsBeforeStart() const {
-        return points.find(ProgramPoint::beforeStart) != points.end();
+        return !ids.empty() && ids.front() == ProgramPointTable::beforeStartId;
     }
-    Points::const_iterator begin() const { return points.cbegin(); }
-    Points::const_iterator end() const { return points.cend(); }
+    const_iterator begin() const { return const_iterator(table, ids.cbegin()); }
+    const_iterator end() const { return const_iterator(table, ids.cend()); }
 };
 
 /// List of definers for each base storage (at a specific program point).
 class Definitions : public IHasDbPrint {
     /// Set of program points that have written last to each location
-    /// (conservative approximation).
-    ordered_map<const BaseLocation *, const ProgramPoints *> definitions;
+    /// (conservative approximation).  Definitions are copied at every write,
+    /// so this uses a map whose copies do not allocate per entry.
+    flat_ordered_map<const BaseLocation *, const ProgramPoints *> definitions;
     /// If true the current program point is actually unreachable.
     bool unreachable = false;
 
@@ -364,8 +424,8 @@ class Definitions : public IHasDbPrint {
     Definitions(const Definitions &other)
         : definitions(other.definitions), unreachable(other.unreachable) {}
     Definitions *joinDefinitions(const Definitions *other) const;
-    /// Point writes the specified LocationSet.
-    Definitions *writes(ProgramPoint point, const LocationSet *locations) const;
+    /// The points in @p points write the specified LocationSet.
+    Definitions *writes(const ProgramPoints *points, const LocationSet *locations) const;
     void setDefintion(const BaseLocation *loc, const ProgramPoints *point) {
         CHECK_NULL(loc);
         CHECK_NULL(point);
@@ -406,19 +466,26 @@ class Definitions : public IHasDbPrint {
 };
 
 class AllDefinitions : public IHasDbPrint {
-    /// These are the definitions available AFTER each ProgramPoint.
+    /// Numbering of the points in atPoint and in all the Definitions.
+    ProgramPointTable points;
+    /// These are the definitions available AFTER each ProgramPoint,
+    /// indexed by the id of the point.
     /// However, for ProgramPoints representing P4Control, P4Action,
     /// P4Table, P4Function -- the definitions are BEFORE the
     /// ProgramPoint.
-    std::unordered_map<ProgramPoint, Definitions *> atPoint;
+    std::vector<Definitions *> atPoint;
 
  public:
     StorageMap *storageMap;
     AllDefinitions(ReferenceMap *refMap, TypeMap *typeMap)
         : storageMap(new StorageMap(refMap, typeMap)) {}
+    /// @returns the set holding just @p point.
+    const ProgramPoints *getPoints(const ProgramPoint &point) {
+        return new ProgramPoints(&points, point);
+    }
     Definitions *getDefinitions(ProgramPoint point, bool emptyIfNotFound = false) {
-        auto it = atPoint.find(point);
-        if (it == atPoint.end()) {
+        auto id = points.getId(point);
+        if (id >= atPoint.size() || atPoint[id] == nullptr) {
             if (emptyIfNotFound) {
                 auto defs = new Definitions();
                 setDefinitionsAt(point, defs, false);
@@ -426,21 +493,22 @@ class AllDefinitions : public IHasDbPrint {
             }
             BUG("Unknown point %1% for definitions", &point);
         }
-        return it->second;
+        return atPoint[id];
     }
     void setDefinitionsAt(ProgramPoint point, Definitions *defs, bool overwrite) {
-        if (!overwrite) {
-            auto it = atPoint.find(point);
-            if (it != atPoint.end()) {
-                LOG2("Overwriting definitions at " << point << ": " << it->second << " with "
-                                                   << defs);
-                BUG_CHECK(false, "Overwriting definitions at %1%", point);
-            }
+        auto id = points.getId(point);
+        if (id >= atPoint.size()) atPoint.resize(points.size());
+        if (!overwrite && atPoint[id] != nullptr) {
+            LOG2("Overwriting definitions at " << point << ": " << atPoint[id] << " with "
+                                               << defs);
+            BUG_CHECK(false, "Overwriting definitions at %1%", point);
         }
-        atPoint[point] = defs;
+        atPoint[id] = defs;
     }
     void dbprint(std::ostream &out) const override {
-        for (auto e : atPoint) out << e.first << " => " << e.second << Log::endl;
+        for (unsigned id = 0; id < atPoint.size(); id++)
+            if (atPoint[id])
+                out << points.getPoint(id) << " => " << atPoint[id] << Log::endl;
     }
 };
 
@@ -22,8 +22,10 @@ limitations under the License.
 #include "../common/options.h"
 #include "frontends/common/resolveReferences/resolveReferences.h"
 #include "frontends/p4/fromv1.0/v1model.h"
+#include "frontends/p4/frontendCache.h"
 #include "frontends/p4/typeChecking/bindVariables.h"
 #include "frontends/p4/typeMap.h"
+#include "ir/binary_generator.h"
 #include "ir/ir.h"
 #include "lib/nullstream.h"
 #include "lib/path.h"
@@ -154,6 +156,7 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
     bool isv1 = options.isv1();
     ReferenceMap refMap;
     TypeMap typeMap;
+    typeMap.setIncremental(options.incrementalTypeMap);
     refMap.setIsV1(isv1);
 
     auto evaluator = new P4::EvaluatorPass(&refMap, &typeMap);
@@ -262,7 +265,22 @@ const IR::P4Program *FrontEnd::run(const CompilerOptions &options, const IR::P4P
     passes.setName("FrontEnd");
     passes.setStopOnError(true);
     passes.addDebugHooks(hooks, true);
-    const IR::P4Program *result = program->apply(passes);
+    FrontEndCache cache(options, parseAnnotations.fingerprint() +
+                                     (skipSideEffectOrdering ? " skipSideEffectOrdering" : ""));
+    const IR::P4Program *result = cache.lookup(program);
+    if (result == nullptr) {
+        unsigned diagnostics = ::diagnosticCount();
+        result = program->apply(passes);
+        // Warnings would not be repeated on a hit, so only store clean results
+        if (result && ::diagnosticCount() == diagnostics) cache.store(result);
+    }
+    if (result && options.dumpBinaryFile) {
+        std::ofstream out(options.dumpBinaryFile, std::ios::binary);
+        if (out)
+            BinaryGenerator().write(out, result);
+        else
+            ::error(ErrorType::ERR_IO, "%1%: cannot open file", options.dumpBinaryFile);
+    }
     return result;
 }
 
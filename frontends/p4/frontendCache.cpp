@@ -0,0 +1,126 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "frontendCache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+
+#include "frontends/version.h"
+#include "ir/binary_generator.h"
+#include "ir/binary_loader.h"
+#include "lib/error.h"
+#include "lib/hash.h"
+#include "lib/log.h"
+#include "lib/path.h"
+
+namespace P4 {
+
+cstring FrontEndCache::hashSource(const std::string &text) {
+    // Two independent 64-bit hashes, so that collisions are not a practical concern.
+    std::stringstream result;
+    result << std::hex << std::setfill('0') << std::setw(16)
+           << Util::Hash::murmur(text.data(), text.size()) << std::setw(16)
+           << Util::Hash::fnv1a(text.data(), text.size());
+    return result.str();
+}
+
+FrontEndCache::FrontEndCache(const CompilerOptions &options, cstring configuration)
+    : dir(options.frontendCacheDir) {
+    if (dir.isNullOrEmpty() || options.sourceHash.isNullOrEmpty() || options.isv1()) return;
+    // Dumps of the frontend passes would not be produced on a hit.
+    if (!options.top4.empty() || !options.prettyPrintFile.isNullOrEmpty()) return;
+
+    std::stringstream text;
+    text << FRONTEND_VERSION_STRING << '\n'
+         << "snapshot " << BinarySnapshot::version << '\n'
+         << "source " << options.sourceHash << ' ' << options.file << '\n'
+         << "frontend " << configuration << '\n'
+         << "parserInlining " << options.optimizeParserInlining << '\n';
+    if (options.excludeFrontendPasses)
+        for (auto pass : options.passesToExcludeFrontend) text << "exclude " << pass << '\n';
+    auto &config = P4CContext::getConfig();
+    text << "widths " << config.maximumWidthSupported() << ' ' << config.maximumArraySize()
+         << '\n';
+    auto &reporter = BaseCompileContext::get().errorReporter();
+    text << "warnings " << static_cast<int>(reporter.getDefaultWarningDiagnosticAction()) << '\n';
+    std::map<cstring, DiagnosticAction> actions(reporter.getDiagnosticActions().begin(),
+                                                reporter.getDiagnosticActions().end());
+    for (auto &a : actions) text << "diagnostic " << a.first << ' ' << int(a.second) << '\n';
+    key = hashSource(text.str());
+}
+
+cstring FrontEndCache::entryFile() const {
+    return Util::PathName(dir).join(key + ".p4ir").toString();
+}
+
+const IR::P4Program *FrontEndCache::lookup(const IR::P4Program *program) const {
+    if (!enabled()) return nullptr;
+    std::unique_ptr<BinarySnapshot> snapshot(BinarySnapshot::open(entryFile(), false));
+    if (!snapshot) {
+        LOG1("Frontend cache miss: " << entryFile());
+        return nullptr;
+    }
+    // The cached program was produced from the same preprocessed text, so its source
+    // positions are positions in the input that was just parsed.
+    for (auto *obj : program->objects) {
+        if (auto *sources = obj->srcInfo.getSources()) {
+            snapshot->setSources(sources);
+            break;
+        }
+    }
+    // A corrupt entry (e.g., left by a full disk) is just a miss; the frontend output will
+    // replace it.
+    auto *root = snapshot->getRoot();
+    if (!root || !root->is<IR::P4Program>()) {
+        LOG1("Frontend cache miss: " << entryFile() << " is corrupt or does not hold a program");
+        return nullptr;
+    }
+    LOG1("Frontend cache hit: " << entryFile() << ", " << snapshot->nodesLoaded() << " nodes");
+    return root->to<IR::P4Program>();
+}
+
+void FrontEndCache::store(const IR::P4Program *result) const {
+    if (!enabled() || result == nullptr) return;
+    if (mkdir(dir.c_str(), 0777) != 0 && errno != EEXIST) {
+        LOG1("Cannot create frontend cache directory " << dir << ": " << strerror(errno));
+        return;
+    }
+    cstring file = entryFile();
+    // Write to a file of our own and rename it, so that readers never see a partial entry.
+    cstring temp = file + ".tmp" + std::to_string(getpid());
+    bool ok;
+    {
+        std::ofstream out(temp, std::ios::binary);
+        if (out) BinaryGenerator().write(out, result);
+        ok = out.good();
+    }
+    if (!ok || rename(temp.c_str(), file.c_str()) != 0) {
+        LOG1("Cannot write frontend cache entry " << file);
+        std::remove(temp.c_str());
+        return;
+    }
+    LOG1("Frontend cache store: " << file);
+}
+
+}  // namespace P4
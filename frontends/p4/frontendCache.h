@@ -0,0 +1,60 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _FRONTENDS_P4_FRONTENDCACHE_H_
+#define _FRONTENDS_P4_FRONTENDCACHE_H_
+
+#include <string>
+
+#include "frontends/common/options.h"
+#include "ir/ir.h"
+
+namespace P4 {
+
+/**
+ * On-disk cache of frontend results, enabled with --frontend-cache.  An entry is a binary IR
+ * snapshot (see ir/binary_generator.h) of the program produced by the frontend, keyed on
+ * - the hash of the preprocessed program, computed by parseP4File;
+ * - the compiler version and the snapshot format version;
+ * - the options that change what the frontend produces, including the diagnostic settings,
+ *   and a description of the frontend configuration given by the caller.
+ *
+ * The program is still parsed on a hit: the cached IR refers to source positions in the
+ * parsed input, which is needed for the error messages of later passes.  Only results of
+ * P4-16 programs that compiled without diagnostics are stored, so a hit never hides a warning.
+ * Entries are written to a temporary file and renamed, so concurrent compilations can share
+ * a cache directory.
+ */
+class FrontEndCache {
+    cstring dir;
+    cstring key;  // null if the cache is disabled for this compilation
+
+    cstring entryFile() const;
+
+ public:
+    /// @p configuration describes the frontend passes, beyond what is in @p options.
+    FrontEndCache(const CompilerOptions &options, cstring configuration);
+
+    /// The hash of a preprocessed program, as stored in ParserOptions::sourceHash.
+    static cstring hashSource(const std::string &text);
+
+    bool enabled() const { return !key.isNullOrEmpty(); }
+    /// @return the cached frontend output for @p program, or nullptr.
+    const IR::P4Program *lookup(const IR::P4Program *program) const;
+    void store(const IR::P4Program *result) const;
+};
+
+}  // namespace P4
+
+#endif /* _FRONTENDS_P4_FRONTENDCACHE_H_ */
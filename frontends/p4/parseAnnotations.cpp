@@ -16,6 +16,9 @@ limitations under the License.
 
 #include "parseAnnotations.h"
 
+#include <set>
+#include <sstream>
+
 namespace P4 {
 
 ParseAnnotations::HandlerMap ParseAnnotations::standardHandlers() {
@@ -144,4 +147,13 @@ void ParseAnnotations::postorder(IR::Annotation *annotation) {
     annotation->needsParsing = !handlers[name](annotation);
 }
 
+cstring ParseAnnotations::fingerprint() const {
+    std::set<cstring> names;
+    for (auto &h : handlers) names.insert(h.first);
+    std::stringstream result;
+    result << "annotations" << (warnUnknown ? " warn" : "");
+    for (auto n : names) result << " " << n;
+    return result.str();
+}
+
 }  // namespace P4
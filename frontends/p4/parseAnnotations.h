@@ -155,6 +155,11 @@ class ParseAnnotations : public Modifier {
 
     void addHandler(cstring name, Handler h) { handlers.insert({name, h}); }
 
+    /// Describes which annotations this pass parses, for keying the frontend cache.
+    /// Handlers are identified by the annotation names only, so targets that parse the same
+    /// annotations share cache entries.
+    cstring fingerprint() const;
+
  private:
     /// Whether to warn about unknown annotations.
     const bool warnUnknown;
@@ -48,7 +48,10 @@ class ClearTypeMap : public Inspector {
         // because the program is saved only *after* typechecking,
         // so if the program changes during type-checking, the
         // typeMap may not be complete.
-        if (force || !typeMap->checkMap(program)) typeMap->clear();
+        // An incremental typeMap only drops the types of the parts of the program that
+        // changed.
+        if (force || (!typeMap->checkMap(program) && !typeMap->retainUnchanged(program)))
+            typeMap->clear();
         return false;  // prune()
     }
 };
@@ -67,6 +67,17 @@ class TypeSubstitution : public IHasDbPrint {
     }
 
     void clear() { binding.clear(); }
+
+    /// Removes the bindings of the variables for which @p keep returns false.
+    template <class Pred>
+    void retain(Pred keep) {
+        for (auto it = binding.begin(); it != binding.end();) {
+            if (keep(it->first))
+                ++it;
+            else
+                it = binding.erase(it);
+        }
+    }
 };
 
 class TypeVariableSubstitution final : public TypeSubstitution<const IR::ITypeVar *> {
@@ -16,6 +16,11 @@ limitations under the License.
 
 #include "typeMap.h"
 
+#include <map>
+#include <unordered_set>
+#include <vector>
+
+#include "ir/visitor.h"
 #include "lib/map.h"
 
 namespace P4 {
@@ -92,6 +97,113 @@ void TypeMap::clear() {
     ProgramMap::clear();
 }
 
+namespace {
+
+// The parts of a top-level object that other objects depend on when they are type-checked.
+// Returns false for objects that can't be re-typed on their own.
+bool getSignature(const IR::Node *object, const IR::Node **sig1, const IR::Node **sig2) {
+    if (auto *action = object->to<IR::P4Action>()) {
+        *sig1 = action->parameters;
+        *sig2 = nullptr;
+    } else if (auto *control = object->to<IR::P4Control>()) {
+        *sig1 = control->type;
+        *sig2 = control->constructorParams;
+    } else if (auto *parser = object->to<IR::P4Parser>()) {
+        *sig1 = parser->type;
+        *sig2 = parser->constructorParams;
+    } else if (auto *function = object->to<IR::Function>()) {
+        *sig1 = function->type;
+        *sig2 = nullptr;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+class CollectNodes : public Inspector {
+    std::unordered_set<const IR::Node *> &nodes;
+
+ public:
+    explicit CollectNodes(std::unordered_set<const IR::Node *> &nodes) : nodes(nodes) {}
+    bool preorder(const IR::Node *node) override { return nodes.insert(node).second; }
+};
+
+}  // namespace
+
+bool TypeMap::retainUnchanged(const IR::P4Program *newProgram) {
+    if (!incremental || program == nullptr || program == fake || newProgram == nullptr)
+        return false;
+
+    std::unordered_set<const IR::Node *> oldObjects(program->objects.begin(),
+                                                    program->objects.end());
+    std::map<cstring, std::vector<const IR::Node *>> oldByName;
+    for (auto *obj : program->objects) {
+        if (auto *decl = obj->to<IR::IDeclaration>())
+            oldByName[decl->getName().name].push_back(obj);
+    }
+
+    std::vector<const IR::Node *> unchanged;
+    for (auto *obj : newProgram->objects) {
+        if (oldObjects.count(obj)) {
+            unchanged.push_back(obj);
+            continue;
+        }
+        const IR::Node *sig1, *sig2;
+        if (!getSignature(obj, &sig1, &sig2)) {
+            LOG2("TypeMap: " << dbp(obj) << " changed; cannot patch map");
+            return false;
+        }
+        // The object must either be new, or replace an object with the same signature;
+        // otherwise the types of the objects that use it may change too.
+        auto old = oldByName.find(obj->to<IR::IDeclaration>()->getName().name);
+        if (old == oldByName.end()) continue;
+        bool sameSignature = false;
+        for (auto *oldObj : old->second) {
+            const IR::Node *oldSig1, *oldSig2;
+            if (getSignature(oldObj, &oldSig1, &oldSig2) && oldSig1 == sig1 && oldSig2 == sig2)
+                sameSignature = true;
+        }
+        if (!sameSignature) {
+            LOG2("TypeMap: signature of " << dbp(obj) << " changed; cannot patch map");
+            return false;
+        }
+    }
+
+    std::unordered_set<const IR::Node *> keep;
+    CollectNodes collect(keep);
+    for (auto *obj : unchanged) obj->apply(collect);
+
+    size_t before = typeMap.size();
+    for (auto it = typeMap.begin(); it != typeMap.end();) {
+        if (keep.count(it->first))
+            ++it;
+        else
+            it = typeMap.erase(it);
+    }
+    for (auto it = leftValues.begin(); it != leftValues.end();) {
+        if (keep.count(*it))
+            ++it;
+        else
+            it = leftValues.erase(it);
+    }
+    for (auto it = constants.begin(); it != constants.end();) {
+        if (keep.count(*it))
+            ++it;
+        else
+            it = constants.erase(it);
+    }
+    // Type variables are bound while the bodies of objects are type-checked, so only the
+    // bindings of variables that occur in the unchanged objects, or in the types kept for
+    // them, are still valid.
+    for (auto &entry : typeMap) entry.second->apply(collect);
+    allTypeVariables.retain(
+        [&keep](const IR::ITypeVar *var) { return keep.count(var->getNode()) != 0; });
+    LOG2("TypeMap: kept " << typeMap.size() << " of " << before << " entries for "
+                          << unchanged.size() << " of " << newProgram->objects.size()
+                          << " unchanged objects");
+    return true;
+}
+
 void TypeMap::checkPrecondition(const IR::Node *element, const IR::Type *type) const {
     CHECK_NULL(element);
     CHECK_NULL(type);
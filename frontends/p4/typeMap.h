@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "frontends/common/programMap.h"
 #include "frontends/p4/typeChecking/typeSubstitution.h"
+#include "lib/flat_ordered_map.h"
 #include "lib/ordered_set.h"
 
 namespace P4 {
@@ -47,7 +48,7 @@ class TypeMap final : public ProgramMap {
     std::vector<const IR::Type *> canonicalLists;
 
     // Map each node to its canonical type
-    ordered_map<const IR::Node *, const IR::Type *> typeMap;
+    flat_ordered_map<const IR::Node *, const IR::Type *> typeMap;
     // All left-values in the program.
     ordered_set<const IR::Expression *> leftValues;
     // All compile-time constants.  A compile-time constant
@@ -60,6 +61,8 @@ class TypeMap final : public ProgramMap {
 
     // checks some preconditions before setting the type
     void checkPrecondition(const IR::Node *element, const IR::Type *type) const;
+    // If true, retainUnchanged may patch the map instead of clearing it.
+    bool incremental = false;
 
  public:
     TypeMap() : ProgramMap("TypeMap"), strictStruct(false) {}
@@ -75,6 +78,14 @@ class TypeMap final : public ProgramMap {
     const IR::Type *getTypeType(const IR::Node *element, bool notNull) const;
     void dbprint(std::ostream &out) const;
     void clear();
+    void setIncremental(bool value) { incremental = value; }
+    /// Called when the program has changed since the map was computed.  If the map is
+    /// incremental and all top-level objects that changed are controls, parsers, actions
+    /// or functions with the same signature as before, drops the entries of all nodes that
+    /// are not part of an unchanged top-level object and returns true; TypeInference will
+    /// then only re-type the changed objects.  Otherwise returns false and leaves the
+    /// map alone -- the caller is expected to clear it.
+    bool retainUnchanged(const IR::P4Program *newProgram);
     bool isLeftValue(const IR::Expression *expression) const {
         return leftValues.count(expression) > 0;
     }
@@ -0,0 +1,26 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _FRONTENDS_VERSION_H
+#define _FRONTENDS_VERSION_H
+
+/**
+  The version of the compiler the frontend was built as part of.  Unlike the
+  backend version strings it is the same for all backends, so that the
+  frontend cache can share entries between them.
+  */
+
+#define FRONTEND_VERSION_STRING "@P4C_VERSION@"
+
+#endif  // _FRONTENDS_VERSION_H
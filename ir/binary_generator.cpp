@@ -0,0 +1,156 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/binary_generator.h"
+
+#include <ostream>
+
+#include "frontends/common/constantParsing.h"
+#include "ir/binary_loader.h"
+#include "ir/ir.h"
+
+uint32_t BinaryGenerator::internString(cstring s) {
+    if (s.isNull()) return 0;
+    auto [it, inserted] = stringIndex.emplace(s, strings.size());
+    if (inserted) strings.push_back(s);
+    return it->second + 1;
+}
+
+void BinaryGenerator::writeString(cstring s) { writeVarint(internString(s)); }
+
+void BinaryGenerator::writeNode(const IR::Node *n) {
+    if (!n) {
+        writeVarint(0);
+        return;
+    }
+    auto [it, inserted] = nodeIndex.emplace(n, pending.size());
+    if (inserted) pending.push_back(n);
+    writeVarint(it->second + 1);
+}
+
+// A source position is written as 0 (none), 1 followed by its text form, or 2 followed by
+// its start and end in the preprocessed input and then its text form.
+void BinaryGenerator::writeSourceInfo(const Util::SourceInfo &si) {
+    if (sourceInfo && si.isValid()) {
+        unsigned line, column;
+        cstring file = si.toSourcePositionData(&line, &column);
+        writeVarint(2);
+        writeVarint(si.getStart().getLineNumber());
+        writeVarint(si.getStart().getColumnNumber());
+        writeVarint(si.getEnd().getLineNumber());
+        writeVarint(si.getEnd().getColumnNumber());
+        writeString(file);
+        writeVarint(line);
+        writeVarint(column);
+        writeString(si.toBriefSourceFragment());
+    } else if (sourceInfo && si.line != -1) {
+        // read from a snapshot or a JSON dump; the input sources are gone
+        writeVarint(1);
+        writeString(si.filename);
+        writeVarint(si.line);
+        writeVarint(si.column);
+        writeString(si.srcBrief);
+    } else {
+        writeVarint(0);
+    }
+}
+
+void BinaryGenerator::generate(const UnparsedConstant *v) {
+    generate(v != nullptr);
+    if (!v) return;
+    writeString(v->text);
+    writeVarint(v->skip);
+    writeVarint(v->base);
+    generate(v->hasWidth);
+}
+
+static void writeRaw(std::ostream &out, const void *data, size_t size) {
+    out.write(static_cast<const char *>(data), size);
+}
+
+static void pad(std::ostream &out, uint64_t &offset) {
+    static const char zeros[8] = {};
+    size_t n = -offset & 7;
+    writeRaw(out, zeros, n);
+    offset += n;
+}
+
+void BinaryGenerator::write(std::ostream &out, const IR::Node *root) {
+    records.clear();
+    recordOffsets.clear();
+    nodeIndex.clear();
+    pending.clear();
+    stringIndex.clear();
+    strings.clear();
+
+    writeNode(root);  // the root, if any, is node 0
+    records.clear();
+    // Writing a record only appends newly referenced nodes to pending, so this visits the
+    // nodes breadth first without recursion.
+    for (size_t i = 0; i < pending.size(); ++i) {
+        auto *node = pending[i];
+        recordOffsets.push_back(records.size());
+        writeString(node->node_type_name());
+        node->toBinary(*this);
+    }
+    // The top-level objects of a program are listed separately, so that readers can load
+    // just the declarations they need.
+    std::vector<uint32_t> objects;
+    if (auto *program = root ? root->to<IR::P4Program>() : nullptr) {
+        for (auto *obj : program->objects) {
+            auto *decl = obj->to<IR::IDeclaration>();
+            objects.push_back(nodeIndex.at(obj));
+            objects.push_back(decl ? internString(decl->getName().name) : 0);
+        }
+    }
+
+    // Layout: header, node records, strings, string offsets, record offsets.
+    BinarySnapshot::Header header = {};
+    memcpy(header.magic, BinarySnapshot::magic, sizeof(header.magic));
+    header.byteOrder = BinarySnapshot::byteOrder;
+    header.version = BinarySnapshot::version;
+    header.nodeCount = recordOffsets.size();
+    header.stringCount = strings.size();
+    header.hasRoot = root != nullptr;
+    header.objectCount = objects.size() / 2;
+
+    uint64_t offset = sizeof(header);
+    header.records = offset;
+    offset += records.size();
+    std::string stringData;
+    std::vector<uint64_t> stringOffsets;
+    for (auto s : strings) {
+        stringOffsets.push_back(offset + stringData.size());
+        uint64_t len = s.size();
+        while (len >= 0x80) {
+            stringData.push_back(static_cast<char>(len | 0x80));
+            len >>= 7;
+        }
+        stringData.push_back(static_cast<char>(len));
+        stringData.append(s.c_str(), s.size());
+    }
+    offset += stringData.size();
+    header.stringTable = (offset + 7) & ~uint64_t(7);
+    header.nodeTable = header.stringTable + stringOffsets.size() * sizeof(uint64_t);
+    header.objectTable = header.nodeTable + recordOffsets.size() * sizeof(uint64_t);
+    for (auto &off : recordOffsets) off += header.records;
+
+    writeRaw(out, &header, sizeof(header));
+    writeRaw(out, records.data(), records.size());
+    writeRaw(out, stringData.data(), stringData.size());
+    pad(out, offset);
+    writeRaw(out, stringOffsets.data(), stringOffsets.size() * sizeof(uint64_t));
+    writeRaw(out, recordOffsets.data(), recordOffsets.size() * sizeof(uint64_t));
+    writeRaw(out, objects.data(), objects.size() * sizeof(uint32_t));
+}
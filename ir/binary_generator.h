@@ -0,0 +1,215 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _IR_BINARY_GENERATOR_H_
+#define _IR_BINARY_GENERATOR_H_
+
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "ir/id.h"
+#include "ir/node.h"
+#include "lib/big_int_util.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/ltbitmatrix.h"
+#include "lib/match.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+#include "lib/safe_vector.h"
+
+struct UnparsedConstant;
+
+/// Writes the IR reachable from a node as a binary snapshot, to be read back with
+/// BinarySnapshot (see ir/binary_loader.h for the file layout).  This is the binary
+/// counterpart of JSONGenerator: every IR class gets a generated toBinary method that
+/// writes its fields in declaration order, but
+/// - every distinct string is stored once, in a string table;
+/// - every node is stored once, in a node table, and referenced by index, so that nodes
+///   shared in the DAG stay shared when loaded;
+/// - numbers are varint-encoded.
+class BinaryGenerator {
+    std::string records;
+    std::vector<uint64_t> recordOffsets;
+    std::unordered_map<const IR::Node *, uint32_t> nodeIndex;
+    std::vector<const IR::Node *> pending;  // referenced, but record not written yet
+    std::unordered_map<cstring, uint32_t> stringIndex;
+    std::vector<cstring> strings;
+    bool sourceInfo;
+
+    template <typename T>
+    class has_toBinary {
+        typedef char small;
+        typedef struct {
+            char c[2];
+        } big;
+
+        template <typename C>
+        static small test(decltype(&C::toBinary));
+        template <typename C>
+        static big test(...);
+
+     public:
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
+    };
+
+    template <typename C>
+    void generateRange(size_t size, const C &c) {
+        writeVarint(size);
+        for (auto &el : c) generate(el);
+    }
+
+ public:
+    /// With @p sourceInfo false, source positions are not written, which makes the snapshot
+    /// smaller but error messages less useful.
+    explicit BinaryGenerator(bool sourceInfo = true) : sourceInfo(sourceInfo) {}
+
+    /// Writes a snapshot of @p root and everything reachable from it.
+    void write(std::ostream &out, const IR::Node *root);
+
+    void writeVarint(uint64_t v) {
+        while (v >= 0x80) {
+            records.push_back(static_cast<char>(v | 0x80));
+            v >>= 7;
+        }
+        records.push_back(static_cast<char>(v));
+    }
+    void writeSigned(int64_t v) {
+        writeVarint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+    }
+    /// Adds @p s to the string table; returns its index + 1, or 0 for a null string.
+    uint32_t internString(cstring s);
+    void writeString(cstring s);
+    void writeNode(const IR::Node *n);
+    void writeSourceInfo(const Util::SourceInfo &si);
+
+    template <typename T>
+    typename std::enable_if<std::is_same<T, bool>::value>::type generate(T v) {
+        records.push_back(v ? 1 : 0);
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type
+    generate(T v) {
+        if (std::is_signed<T>::value)
+            writeSigned(v);
+        else
+            writeVarint(v);
+    }
+    void generate(double v) {
+        char buf[sizeof(v)];
+        memcpy(buf, &v, sizeof(v));
+        records.append(buf, sizeof(v));
+    }
+    template <typename T>
+    typename std::enable_if<std::is_same<T, big_int>::value>::type generate(const T &v) {
+        writeString(v.str());
+    }
+    void generate(cstring v) { writeString(v); }
+    void generate(const std::string &v) { writeString(v); }
+    void generate(const IR::ID &v) {
+        writeString(v.name);
+        writeString(v.originalName);
+        writeSourceInfo(v.srcInfo);
+    }
+    // Types that are written in text form, as in the JSON dumps
+    template <typename T>
+    typename std::enable_if<std::is_same<T, LTBitMatrix>::value || std::is_enum<T>::value ||
+                            std::is_same<T, bitvec>::value || std::is_same<T, match_t>::value>::type
+    generate(const T &v) {
+        std::stringstream tmp;
+        tmp << v;
+        writeString(tmp.str());
+    }
+    void generate(const UnparsedConstant *v);
+
+    // IR nodes, including inline ones, are written as references into the node table
+    void generate(const IR::Node &v) { writeNode(&v); }
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type generate(const T *v) {
+        writeNode(v ? v->getNode() : nullptr);
+    }
+    // Nested classes are written in place
+    template <typename T>
+    typename std::enable_if<has_toBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    generate(const T &v) {
+        v.toBinary(*this);
+    }
+    template <typename T>
+    typename std::enable_if<has_toBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    generate(const T *v) {
+        generate(v != nullptr);
+        if (v) v->toBinary(*this);
+    }
+
+    template <typename T>
+    void generate(const safe_vector<T> &v) {
+        generateRange(v.size(), v);
+    }
+    template <typename T>
+    void generate(const std::vector<T> &v) {
+        generateRange(v.size(), v);
+    }
+    template <typename T>
+    void generate(const std::set<T> &v) {
+        generateRange(v.size(), v);
+    }
+    template <typename T>
+    void generate(const ordered_set<T> &v) {
+        generateRange(v.size(), v);
+    }
+    template <typename K, typename V>
+    void generate(const std::map<K, V> &v) {
+        generateRange(v.size(), v);
+    }
+    template <typename K, typename V>
+    void generate(const std::multimap<K, V> &v) {
+        generateRange(v.size(), v);
+    }
+    template <typename K, typename V>
+    void generate(const ordered_map<K, V> &v) {
+        generateRange(v.size(), v);
+    }
+    template <typename T, typename U>
+    void generate(const std::pair<T, U> &v) {
+        generate(v.first);
+        generate(v.second);
+    }
+    template <typename T>
+    void generate(const std::optional<T> &v) {
+        generate(v.has_value());
+        if (v) generate(*v);
+    }
+    template <typename T, size_t N>
+    void generate(const T (&v)[N]) {
+        for (auto &el : v) generate(el);
+    }
+
+    template <typename T>
+    BinaryGenerator &operator<<(const T &v) {
+        generate(v);
+        return *this;
+    }
+};
+
+#endif /* _IR_BINARY_GENERATOR_H_ */
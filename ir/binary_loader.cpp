@@ -0,0 +1,220 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/binary_loader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "frontends/common/constantParsing.h"
+#include "lib/error.h"
+#include "lib/map.h"
+
+BinarySnapshot::BinarySnapshot(cstring name, const char *data, size_t size, bool reportErrors)
+    : name(name), data(data), size(size), reportErrors(reportErrors) {}
+
+BinarySnapshot::~BinarySnapshot() {
+    if (mapping) munmap(mapping, size);
+}
+
+BinarySnapshot *BinarySnapshot::open(cstring file, bool reportErrors) {
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        if (reportErrors) ::error(ErrorType::ERR_IO, "%1%: cannot open IR snapshot", file);
+        return nullptr;
+    }
+    struct stat st;
+    void *mapping = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        if (reportErrors) ::error(ErrorType::ERR_IO, "%1%: cannot map IR snapshot", file);
+        return nullptr;
+    }
+    auto *rv =
+        new BinarySnapshot(file, static_cast<const char *>(mapping), st.st_size, reportErrors);
+    rv->mapping = mapping;
+    if (!rv->validate()) {
+        delete rv;
+        return nullptr;
+    }
+    return rv;
+}
+
+BinarySnapshot *BinarySnapshot::fromBuffer(cstring name, const char *data, size_t size,
+                                           bool reportErrors) {
+    auto *rv = new BinarySnapshot(name, data, size, reportErrors);
+    if (!rv->validate()) {
+        delete rv;
+        return nullptr;
+    }
+    return rv;
+}
+
+bool BinarySnapshot::validate() {
+    if (size < sizeof(header) || memcmp(data, magic, sizeof(magic)) != 0) {
+        if (reportErrors) ::error(ErrorType::ERR_INVALID, "%1%: not an IR snapshot", name);
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (header.byteOrder != byteOrder || header.version != version) {
+        if (reportErrors)
+            ::error(ErrorType::ERR_INVALID,
+                    "%1%: IR snapshot was written by an incompatible compiler; regenerate it",
+                    name);
+        return false;
+    }
+    if (header.stringTable > size || header.nodeTable > size ||
+        (size - header.stringTable) / sizeof(uint64_t) < header.stringCount ||
+        (size - header.nodeTable) / sizeof(uint64_t) < header.nodeCount ||
+        header.objectTable > size ||
+        (size - header.objectTable) / (2 * sizeof(uint32_t)) < header.objectCount ||
+        (header.hasRoot && header.nodeCount == 0) || (header.objectCount && !header.hasRoot)) {
+        if (reportErrors) ::error(ErrorType::ERR_INVALID, "%1%: corrupt IR snapshot", name);
+        return false;
+    }
+    strings.resize(header.stringCount);
+    nodes.resize(header.nodeCount);
+    loading.resize(header.nodeCount);
+    return true;
+}
+
+uint64_t BinarySnapshot::tableEntry(uint64_t table, uint32_t index) const {
+    uint64_t rv;
+    memcpy(&rv, data + table + index * sizeof(uint64_t), sizeof(rv));
+    if (rv >= size) throw Corrupt();
+    return rv;
+}
+
+uint32_t BinarySnapshot::objectEntry(size_t index, unsigned field) const {
+    uint32_t rv;
+    memcpy(&rv, data + header.objectTable + (2 * index + field) * sizeof(uint32_t), sizeof(rv));
+    return rv;
+}
+
+cstring BinarySnapshot::getString(uint32_t index) {
+    if (index >= strings.size()) throw Corrupt();
+    if (strings[index].isNull()) {
+        BinaryLoader in(*this, tableEntry(header.stringTable, index));
+        auto len = in.readVarint();
+        if (len > uint64_t(in.end - in.pos)) throw Corrupt();
+        strings[index] = cstring(std::string(reinterpret_cast<const char *>(in.pos), len));
+    }
+    return strings[index];
+}
+
+const IR::Node *BinarySnapshot::getNode(uint32_t index, BinaryFactoryFn factory) {
+    if (index >= nodes.size()) throw Corrupt();
+    if (!nodes[index]) {
+        // a node cannot (indirectly) contain itself
+        if (loading[index]) throw Corrupt();
+        loading[index] = true;
+        BinaryLoader in(*this, tableEntry(header.nodeTable, index));
+        cstring type = in.readString();
+        if (!factory) factory = get(IR::binary_unpacker_table, type);
+        if (!factory) throw Corrupt();
+        nodes[index] = factory(in);
+        if (!nodes[index]) throw Corrupt();
+        loading[index] = false;
+        ++loaded;
+    }
+    return nodes[index];
+}
+
+const IR::Node *BinarySnapshot::load(uint32_t index) {
+    if (corrupt) return nullptr;
+    try {
+        return getNode(index);
+    } catch (const Corrupt &) {
+        corrupt = true;
+        if (reportErrors) ::error(ErrorType::ERR_INVALID, "%1%: corrupt IR snapshot", name);
+        return nullptr;
+    }
+}
+
+cstring BinarySnapshot::getObjectName(size_t index) {
+    if (corrupt || index >= header.objectCount) return cstring();
+    auto str = objectEntry(index, 1);
+    if (str == 0) return cstring();
+    try {
+        return getString(str - 1);
+    } catch (const Corrupt &) {
+        corrupt = true;
+        if (reportErrors) ::error(ErrorType::ERR_INVALID, "%1%: corrupt IR snapshot", name);
+        return cstring();
+    }
+}
+
+const IR::Node *BinarySnapshot::getObject(size_t index) {
+    if (index >= header.objectCount) return nullptr;
+    return load(objectEntry(index, 0));
+}
+
+const IR::Node *BinarySnapshot::findObject(cstring name) {
+    for (size_t i = 0; i < header.objectCount; ++i)
+        if (getObjectName(i) == name) return getObject(i);
+    return nullptr;
+}
+
+BinaryLoader::BinaryLoader(BinarySnapshot &snapshot, uint64_t offset)
+    : snapshot(snapshot),
+      pos(reinterpret_cast<const uint8_t *>(snapshot.data) + offset),
+      end(reinterpret_cast<const uint8_t *>(snapshot.data) + snapshot.size) {}
+
+Util::SourceInfo BinaryLoader::readSourceInfo() {
+    auto kind = readVarint();
+    if (kind == 0) return Util::SourceInfo();
+    if (kind > 2) corrupt();
+    if (kind == 2) {
+        unsigned startLine = readVarint();
+        unsigned startColumn = readVarint();
+        unsigned endLine = readVarint();
+        unsigned endColumn = readVarint();
+        if (startLine == 0 || startLine > endLine ||
+            (startLine == endLine && startColumn > endColumn))
+            corrupt();
+        if (snapshot.sources) {
+            // skip the text form
+            readString();
+            readVarint();
+            readVarint();
+            readString();
+            return Util::SourceInfo(snapshot.sources, Util::SourcePosition(startLine, startColumn),
+                                    Util::SourcePosition(endLine, endColumn));
+        }
+    }
+    cstring file = readString();
+    int line = readVarint();
+    int column = readVarint();
+    cstring fragment = readString();
+    return Util::SourceInfo(file, line, column, fragment);
+}
+
+void BinaryLoader::unpack(UnparsedConstant *&v) {
+    bool present;
+    unpack(present);
+    if (!present) {
+        v = nullptr;
+        return;
+    }
+    cstring text = readString();
+    unsigned skip = readVarint();
+    unsigned base = readVarint();
+    bool hasWidth;
+    unpack(hasWidth);
+    v = new UnparsedConstant({text, skip, base, hasWidth});
+}
@@ -0,0 +1,452 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _IR_BINARY_LOADER_H_
+#define _IR_BINARY_LOADER_H_
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "ir.h"
+#include "lib/bitvec.h"
+#include "lib/cstring.h"
+#include "lib/exceptions.h"
+#include "lib/ltbitmatrix.h"
+#include "lib/match.h"
+#include "lib/ordered_map.h"
+#include "lib/ordered_set.h"
+#include "lib/safe_vector.h"
+
+class BinaryLoader;
+
+/// An IR snapshot written by BinaryGenerator.  The file is memory-mapped and nodes are
+/// materialized lazily, the first time they are reached: getRoot() materializes the whole
+/// program, while getObject() and findObject() only decode one top-level object and the
+/// nodes it refers to.  Nodes that are never reached are never decoded.
+///
+/// Layout (all offsets from the start of the file, integers in native byte order):
+///   Header
+///   node records    per node: type name, then the fields written by its toBinary method;
+///                   strings and node references are varint indexes into the tables below
+///                   (0 means null), other integers are varints; source positions also keep
+///                   their line and column in the preprocessed input, see setSources()
+///   strings         per string: varint length, then the bytes
+///   string table    stringCount uint64 offsets of the strings
+///   node table      nodeCount uint64 offsets of the node records; node 0 is the root
+///   object table    objectCount pairs of uint32: node index and name (string index + 1, or 0)
+///                   of each top-level object, if the root is a P4Program
+///
+/// Corrupt input is reported as an error rather than a compiler bug: the request that
+/// found it returns nullptr, and so does every later one, so that callers can fall back to
+/// producing the IR some other way.
+class BinarySnapshot {
+ public:
+    struct Header {
+        char magic[8];
+        uint32_t byteOrder;
+        uint32_t version;
+        uint32_t nodeCount;
+        uint32_t stringCount;
+        uint32_t hasRoot;
+        uint32_t objectCount;
+        uint64_t records;
+        uint64_t stringTable;
+        uint64_t nodeTable;
+        uint64_t objectTable;
+    };
+    static constexpr char magic[8] = "P4IRBIN";
+    static constexpr uint32_t byteOrder = 0x01020304;
+    static constexpr uint32_t version = 3;
+
+    /// Maps @p file into memory.  Returns nullptr, and reports an error if @p reportErrors is
+    /// set, if the file cannot be read or is not a snapshot written by this version of the
+    /// compiler.
+    static BinarySnapshot *open(cstring file, bool reportErrors = true);
+    /// Reads a snapshot from memory; @p data must outlive the snapshot.
+    static BinarySnapshot *fromBuffer(cstring name, const char *data, size_t size,
+                                      bool reportErrors = true);
+    BinarySnapshot(const BinarySnapshot &) = delete;
+    ~BinarySnapshot();
+
+    cstring getName() const { return name; }
+    size_t nodeCount() const { return nodes.size(); }
+    /// The number of nodes materialized so far.
+    size_t nodesLoaded() const { return loaded; }
+    /// The root node.  IR nodes refer to their children by plain pointers, so this
+    /// materializes everything reachable from the root.
+    const IR::Node *getRoot() { return header.hasRoot ? load(0) : nullptr; }
+    /// The top-level objects of a P4Program root, which can be loaded one at a time.
+    size_t objectCount() const { return header.objectCount; }
+    /// The name of top-level object @p index; null if it is not a declaration.
+    cstring getObjectName(size_t index);
+    /// Materializes top-level object @p index and the nodes it refers to.
+    const IR::Node *getObject(size_t index);
+    /// Materializes the first top-level declaration called @p name, if any.
+    const IR::Node *findObject(cstring name);
+    /// True if corrupt data was found; nothing more is loaded after that.
+    bool failed() const { return corrupt; }
+    /// Source positions are normally loaded as text (file, line and column of the original
+    /// source), which is enough for error messages but not for passes that look at the
+    /// source text.  If the program is parsed again from the same preprocessed input, its
+    /// InputSources can be given here, and positions are then loaded as full SourceInfos.
+    /// Must be called before any node is materialized.
+    void setSources(const Util::InputSources *s) { sources = s; }
+
+ private:
+    friend class BinaryLoader;
+    cstring name;
+    const char *data;
+    size_t size;
+    void *mapping = nullptr;
+    Header header;
+    std::vector<cstring> strings;
+    std::vector<const IR::Node *> nodes;
+    std::vector<bool> loading;  // nodes being materialized, to detect cycles
+    size_t loaded = 0;
+    const Util::InputSources *sources = nullptr;
+    bool reportErrors;
+    bool corrupt = false;
+
+    /// Thrown while decoding corrupt data, and caught by the public entry points.
+    struct Corrupt {};
+
+    BinarySnapshot(cstring name, const char *data, size_t size, bool reportErrors);
+    bool validate();
+    uint64_t tableEntry(uint64_t table, uint32_t index) const;
+    uint32_t objectEntry(size_t index, unsigned field) const;
+    /// Materializes node @p index, using @p factory if given, and otherwise the factory
+    /// registered for the type recorded in the snapshot.  Throws Corrupt.
+    const IR::Node *getNode(uint32_t index, BinaryFactoryFn factory = nullptr);
+    /// Throws Corrupt.
+    cstring getString(uint32_t index);
+    /// getNode(), with corrupt data reported as an error.
+    const IR::Node *load(uint32_t index);
+};
+
+/// Reads the fields of one node record; the binary counterpart of JSONLoader, used by the
+/// generated IR constructors.
+class BinaryLoader {
+    friend class BinarySnapshot;
+    BinarySnapshot &snapshot;
+    const uint8_t *pos, *end;
+
+    template <typename T>
+    class has_fromBinary {
+        typedef char small;
+        typedef struct {
+            char c[2];
+        } big;
+
+        template <typename C>
+        static small test(decltype(&C::fromBinary));
+        template <typename C>
+        static big test(...);
+
+     public:
+        static const bool value = sizeof(test<T>(0)) == sizeof(char);
+    };
+
+    [[noreturn]] void corrupt() const { throw BinarySnapshot::Corrupt(); }
+
+    template <class T>
+    static IR::Node *factory(BinaryLoader &bin) {
+        return T::fromBinary(bin);
+    }
+    /// Node references of a statically known class (vectors and name maps, which have no
+    /// entry in the factory table) are materialized with that class's factory.
+    template <class T>
+    const T *readNodeAs() {
+        auto index = readVarint();
+        if (index == 0) return nullptr;
+        auto *node = snapshot.getNode(index - 1, &factory<T>)->template to<T>();
+        if (!node) corrupt();
+        return node;
+    }
+    template <class T>
+    const T &readNodeRef() {
+        auto *node = readNodeAs<T>();
+        if (!node) corrupt();
+        return *node;
+    }
+    uint64_t readSize() {
+        auto size = readVarint();
+        if (size > uint64_t(end - pos)) corrupt();  // every element takes at least one byte
+        return size;
+    }
+
+ public:
+    BinaryLoader(BinarySnapshot &snapshot, uint64_t offset);
+
+    uint64_t readVarint() {
+        uint64_t rv = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            if (pos == end || shift > 63) corrupt();
+            uint8_t byte = *pos++;
+            rv |= uint64_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return rv;
+        }
+    }
+    int64_t readSigned() {
+        auto v = readVarint();
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+    cstring readString() {
+        auto index = readVarint();
+        return index ? snapshot.getString(index - 1) : cstring();
+    }
+    const IR::Node *readNode() {
+        auto index = readVarint();
+        return index ? snapshot.getNode(index - 1) : nullptr;
+    }
+    Util::SourceInfo readSourceInfo();
+
+    template <typename T>
+    typename std::enable_if<std::is_same<T, bool>::value>::type unpack(T &v) {
+        if (pos == end) corrupt();
+        v = *pos++ != 0;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type
+    unpack(T &v) {
+        if (std::is_signed<T>::value)
+            v = static_cast<T>(readSigned());
+        else
+            v = static_cast<T>(readVarint());
+    }
+    void unpack(double &v) {
+        if (size_t(end - pos) < sizeof(v)) corrupt();
+        memcpy(&v, pos, sizeof(v));
+        pos += sizeof(v);
+    }
+    void unpack(big_int &v) { v = big_int(readString().c_str()); }
+    void unpack(cstring &v) { v = readString(); }
+    void unpack(std::string &v) {
+        auto s = readString();
+        v = s ? s.c_str() : "";
+    }
+    void unpack(IR::ID &v) {
+        v.name = readString();
+        v.originalName = readString();
+        v.srcInfo = readSourceInfo();
+    }
+    void unpack(LTBitMatrix &m) {
+        if (auto s = readString()) s.c_str() >> m;
+    }
+    void unpack(bitvec &v) {
+        if (auto s = readString()) s.c_str() >> v;
+    }
+    void unpack(match_t &v) {
+        if (auto s = readString()) s.c_str() >> v;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_enum<T>::value>::type unpack(T &v) {
+        if (auto s = readString()) s >> v;
+    }
+    void unpack(UnparsedConstant *&v);
+
+    template <typename T>
+    void unpack(IR::Vector<T> &v) {
+        v = readNodeRef<IR::Vector<T>>();
+    }
+    template <typename T>
+    void unpack(const IR::Vector<T> *&v) {
+        v = readNodeAs<IR::Vector<T>>();
+    }
+    template <typename T>
+    void unpack(IR::IndexedVector<T> &v) {
+        v = readNodeRef<IR::IndexedVector<T>>();
+    }
+    template <typename T>
+    void unpack(const IR::IndexedVector<T> *&v) {
+        v = readNodeAs<IR::IndexedVector<T>>();
+    }
+    template <class T, template <class K, class V, class COMP, class ALLOC> class MAP, class COMP,
+              class ALLOC>
+    void unpack(IR::NameMap<T, MAP, COMP, ALLOC> &m) {
+        m = readNodeRef<IR::NameMap<T, MAP, COMP, ALLOC>>();
+    }
+    template <class T, template <class K, class V, class COMP, class ALLOC> class MAP, class COMP,
+              class ALLOC>
+    void unpack(const IR::NameMap<T, MAP, COMP, ALLOC> *&m) {
+        m = readNodeAs<IR::NameMap<T, MAP, COMP, ALLOC>>();
+    }
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type unpack(T &v) {
+        auto *node = readNode();
+        if (!node || !node->is<T>()) corrupt();
+        v = *node->to<T>();
+    }
+    template <typename T>
+    typename std::enable_if<std::is_base_of<IR::INode, T>::value>::type unpack(const T *&v) {
+        auto *node = readNode();
+        if (node && !node->is<T>()) corrupt();
+        v = node ? node->to<T>() : nullptr;
+    }
+
+    // Nested classes
+    template <typename T>
+    typename std::enable_if<has_fromBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    unpack(T &v) {
+        v = *T::fromBinary(*this);
+    }
+    template <typename T>
+    typename std::enable_if<has_fromBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    unpack(T *&v) {
+        bool present;
+        unpack(present);
+        v = present ? T::fromBinary(*this) : nullptr;
+    }
+    template <typename T>
+    typename std::enable_if<has_fromBinary<T>::value && !std::is_base_of<IR::INode, T>::value>::type
+    unpack(const T *&v) {
+        T *tmp;
+        unpack(tmp);
+        v = tmp;
+    }
+
+    template <typename T>
+    void unpack(safe_vector<T> &v) {
+        v.clear();
+        for (auto n = readSize(); n > 0; --n) {
+            T temp;
+            unpack(temp);
+            v.push_back(std::move(temp));
+        }
+    }
+    template <typename T>
+    void unpack(std::vector<T> &v) {
+        v.clear();
+        for (auto n = readSize(); n > 0; --n) {
+            T temp;
+            unpack(temp);
+            v.push_back(std::move(temp));
+        }
+    }
+    template <typename T>
+    void unpack(std::set<T> &v) {
+        v.clear();
+        for (auto n = readSize(); n > 0; --n) {
+            T temp;
+            unpack(temp);
+            v.insert(std::move(temp));
+        }
+    }
+    template <typename T>
+    void unpack(ordered_set<T> &v) {
+        v.clear();
+        for (auto n = readSize(); n > 0; --n) {
+            T temp;
+            unpack(temp);
+            v.insert(std::move(temp));
+        }
+    }
+    template <typename K, typename V>
+    void unpack(std::map<K, V> &v) {
+        v.clear();
+        for (auto n = readSize(); n > 0; --n) {
+            std::pair<K, V> temp;
+            unpack(temp);
+            v.insert(std::move(temp));
+        }
+    }
+    template <typename K, typename V>
+    void unpack(std::multimap<K, V> &v) {
+        v.clear();
+        for (auto n = readSize(); n > 0; --n) {
+            std::pair<K, V> temp;
+            unpack(temp);
+            v.insert(std::move(temp));
+        }
+    }
+    template <typename K, typename V>
+    void unpack(ordered_map<K, V> &v) {
+        v.clear();
+        for (auto n = readSize(); n > 0; --n) {
+            std::pair<K, V> temp;
+            unpack(temp);
+            v.insert(std::move(temp));
+        }
+    }
+    template <typename T, typename U>
+    void unpack(std::pair<T, U> &v) {
+        unpack(v.first);
+        unpack(v.second);
+    }
+    template <typename T>
+    void unpack(std::optional<T> &v) {
+        bool present;
+        unpack(present);
+        if (!present) {
+            v = std::nullopt;
+            return;
+        }
+        T value;
+        unpack(value);
+        v = std::move(value);
+    }
+    template <typename T, size_t N>
+    void unpack(T (&v)[N]) {
+        for (auto &el : v) unpack(el);
+    }
+
+    template <typename T>
+    BinaryLoader &operator>>(T &v) {
+        unpack(v);
+        return *this;
+    }
+};
+
+template <class T>
+IR::Vector<T>::Vector(BinaryLoader &bin) : VectorBase(bin) {
+    bin >> vec;
+}
+template <class T>
+IR::Vector<T> *IR::Vector<T>::fromBinary(BinaryLoader &bin) {
+    return new Vector<T>(bin);
+}
+template <class T>
+IR::IndexedVector<T>::IndexedVector(BinaryLoader &bin) : Vector<T>(bin) {
+    for (auto *el : *this) insertInMap(el);
+}
+template <class T>
+IR::IndexedVector<T> *IR::IndexedVector<T>::fromBinary(BinaryLoader &bin) {
+    return new IndexedVector<T>(bin);
+}
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+IR::NameMap<T, MAP, COMP, ALLOC>::NameMap(BinaryLoader &bin) : Node(bin) {
+    for (auto n = bin.readVarint(); n > 0; --n) {
+        cstring name;
+        const T *obj;
+        bin >> name >> obj;
+        symbols.emplace(name, obj);
+    }
+}
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+IR::NameMap<T, MAP, COMP, ALLOC> *IR::NameMap<T, MAP, COMP, ALLOC>::fromBinary(
+    BinaryLoader &bin) {
+    return new IR::NameMap<T, MAP, COMP, ALLOC>(bin);
+}
+
+#endif /* _IR_BINARY_LOADER_H_ */
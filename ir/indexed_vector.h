@@ -23,10 +23,12 @@ limitations under the License.
 #include "ir/vector.h"
 #include "lib/enumerator.h"
 #include "lib/error.h"
+#include "lib/flat_ordered_map.h"
 #include "lib/null.h"
 #include "lib/ordered_map.h"
 #include "lib/safe_vector.h"
 
+class BinaryLoader;
 class JSONLoader;
 
 namespace IR {
@@ -37,7 +39,7 @@ namespace IR {
  */
 template <class T>
 class IndexedVector : public Vector<T> {
-    ordered_map<cstring, const IDeclaration *> declarations;
+    flat_ordered_map<cstring, const IDeclaration *> declarations;
     bool invalid = false;  // set when an error occurs; then we don't
                            // expect the validity check to succeed.
 
@@ -82,6 +84,7 @@ class IndexedVector : public Vector<T> {
     }
     explicit IndexedVector(const Vector<T> &a) { insert(Vector<T>::end(), a.begin(), a.end()); }
     explicit IndexedVector(JSONLoader &json);
+    explicit IndexedVector(BinaryLoader &bin);
 
     void clear() {
         IR::Vector<T>::clear();
@@ -202,6 +205,8 @@ class IndexedVector : public Vector<T> {
 
     void toJSON(JSONGenerator &json) const override;
     static IndexedVector<T> *fromJSON(JSONLoader &json);
+    // The declarations are not written to binary snapshots, but recomputed when loading.
+    static IndexedVector<T> *fromBinary(BinaryLoader &bin);
     void validate() const override {
         if (invalid) return;  // don't crash the compiler because an error happened
         for (auto el : *this) {
@@ -17,6 +17,7 @@ limitations under the License.
 #ifndef _IR_IR_INLINE_H_
 #define _IR_IR_INLINE_H_
 
+#include "ir/binary_generator.h"
 #include "ir/id.h"
 #include "ir/indexed_vector.h"
 #include "ir/json_generator.h"
@@ -147,6 +148,11 @@ void IR::Vector<T>::toJSON(JSONGenerator &json) const {
     }
     json << "]";
 }
+template <class T>
+void IR::Vector<T>::toBinary(BinaryGenerator &bin) const {
+    Node::toBinary(bin);
+    bin << vec;
+}
 
 std::ostream &operator<<(std::ostream &out, const IR::Vector<IR::Expression> &v);
 
@@ -287,6 +293,14 @@ void IR::NameMap<T, MAP, COMP, ALLOC>::toJSON(JSONGenerator &json) const {
     }
     json << "}";
 }
+template <class T, template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
+          class COMP /*= std::less<cstring>*/,
+          class ALLOC /*= std::allocator<std::pair<cstring, const T*>>*/>
+void IR::NameMap<T, MAP, COMP, ALLOC>::toBinary(BinaryGenerator &bin) const {
+    Node::toBinary(bin);
+    bin.writeVarint(symbols.size());
+    for (auto &k : symbols) bin << k.first << k.second;
+}
 
 template <class KEY, class VALUE,
           template <class K, class V, class COMP, class ALLOC> class MAP /*= std::map */,
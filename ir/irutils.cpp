@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cmath>
 #include <map>
+#include <mutex>
 #include <tuple>
 #include <typeindex>
 #include <vector>
@@ -49,6 +50,8 @@ const Constant *getConstant(const Type *type, big_int v) {
     // Constants are interned. Keys in the intern map are pairs of types and values.
     using key_t = std::tuple<int, std::type_index, bool, big_int>;
     static std::map<key_t, const Constant *> constants;
+    static std::mutex lock;
+    std::lock_guard<std::mutex> guard(lock);
 
     auto *&result = constants[{tb->width_bits(), typeid(*type), tb->isSigned, v}];
     if (result == nullptr) {
@@ -61,6 +64,8 @@ const Constant *getConstant(const Type *type, big_int v) {
 const BoolLiteral *getBoolLiteral(bool value) {
     // Boolean literals are interned.
     static std::map<bool, const BoolLiteral *> literals;
+    static std::mutex lock;
+    std::lock_guard<std::mutex> guard(lock);
 
     auto *&result = literals[value];
     if (result == nullptr) {
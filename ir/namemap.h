@@ -25,6 +25,7 @@ limitations under the License.
 #include "lib/error.h"
 #include "lib/exceptions.h"
 
+class BinaryLoader;
 class JSONLoader;
 
 namespace IR {
@@ -52,6 +53,7 @@ class NameMap : public Node {
     NameMap(const NameMap &) = default;
     NameMap(NameMap &&) = default;
     explicit NameMap(JSONLoader &);
+    explicit NameMap(BinaryLoader &);
     NameMap &operator=(const NameMap &) = default;
     NameMap &operator=(NameMap &&) = default;
     typedef typename map_t::value_type value_type;
@@ -147,6 +149,8 @@ class NameMap : public Node {
     void visit_children(Visitor &v) const override;
     void toJSON(JSONGenerator &json) const override;
     static NameMap<T, MAP, COMP, ALLOC> *fromJSON(JSONLoader &json);
+    void toBinary(BinaryGenerator &bin) const override;
+    static NameMap<T, MAP, COMP, ALLOC> *fromBinary(BinaryLoader &bin);
 
     Util::Enumerator<const T *> *valueEnumerator() const {
         return Util::Enumerator<const T *>::createEnumerator(Values(symbols).begin(),
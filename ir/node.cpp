@@ -20,15 +20,19 @@ limitations under the License.
 #include "node.h"
 
 #include <memory>
+#include <new>
 #include <ostream>
 // use in combination with "raise" below
 // #include <csignal>
 
+#include "ir/binary_generator.h"
+#include "ir/binary_loader.h"
 #include "ir/declaration.h"
 #include "ir/ir.h"
 #include "ir/json_generator.h"
 #include "ir/json_loader.h"
 #include "ir/visitor.h"
+#include "lib/arena.h"
 #include "lib/indent.h"
 #include "lib/json.h"
 #include "lib/log.h"
@@ -47,7 +51,31 @@ void IR::Node::traceCreation() const {
     LOG5("Created node " << id);
 }
 
-int IR::Node::currentId = 0;
+std::atomic<int> IR::Node::currentId(0);
+
+#if HAVE_IR_ARENA
+namespace {
+// Precedes every node and records where it was allocated, so that deleting the node does not
+// depend on which arena (if any) is current at that point.
+struct alignas(std::max_align_t) NodeHeader {
+    Util::Arena *arena;  // null if the node comes from the global operator new
+};
+}  // namespace
+
+void *IR::Node::operator new(size_t size) {
+    auto *arena = Util::Arena::current();
+    size += sizeof(NodeHeader);
+    void *p = arena ? arena->allocate(size) : ::operator new(size);
+    auto *header = new (p) NodeHeader{arena};
+    return header + 1;
+}
+
+void IR::Node::operator delete(void *p, size_t) {
+    auto *header = static_cast<NodeHeader *>(p) - 1;
+    if (header->arena) return;  // freed by Arena::release()
+    ::operator delete(header);
+}
+#endif
 
 void IR::Node::toJSON(JSONGenerator &json) const {
     json << json.indent << "\"Node_ID\" : " << id << "," << std::endl
@@ -63,6 +91,18 @@ IR::Node::Node(JSONLoader &json) : id(-1) {
     clone_id = id;
 }
 
+void IR::Node::toBinary(BinaryGenerator &bin) const {
+    bin.writeVarint(id);
+    bin.writeSourceInfo(srcInfo);
+}
+
+IR::Node::Node(BinaryLoader &bin) {
+    id = bin.readVarint();
+    if (id >= currentId) currentId = id + 1;
+    clone_id = id;
+    srcInfo = bin.readSourceInfo();
+}
+
 // Abbreviated debug print
 cstring IR::dbp(const IR::INode *node) {
     std::stringstream str;
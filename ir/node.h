@@ -17,9 +17,12 @@ limitations under the License.
 #ifndef _IR_NODE_H_
 #define _IR_NODE_H_
 
+#include <atomic>
 #include <iosfwd>
+#include <type_traits>
 #include <typeinfo>
 
+#include "config.h"
 #include "ir-tree-macros.h"
 #include "ir/gen-tree-macro.h"
 #include "lib/castable.h"
@@ -27,6 +30,8 @@ limitations under the License.
 #include "lib/exceptions.h"
 #include "lib/source_file.h"
 
+class BinaryGenerator;
+class BinaryLoader;
 class Visitor;
 struct Visitor_Context;
 class Inspector;
@@ -48,6 +53,18 @@ class Vector;  // IWYU pragma: keep
 template <class T>
 class IndexedVector;  // IWYU pragma: keep
 
+/// Identifies the dynamic class of a Node.  The ir-generator numbers the Node class tree in
+/// preorder, so the ids of a class and all of its subclasses form a contiguous range.
+using NodeTypeId = unsigned;
+
+/// True if T declares its own type id range (i.e., T is a class generated from a .def file),
+/// rather than inheriting the one of a base class (e.g., Vector<T> or a hand-written subclass).
+template <typename T, typename = void>
+struct has_static_type_id : std::false_type {};
+template <typename T>
+struct has_static_type_id<T, std::void_t<typename T::type_id_class>>
+    : std::is_same<typename T::type_id_class, T> {};
+
 // node interface
 class INode : public Util::IHasSourceInfo, public IHasDbPrint, public ICastable {
  public:
@@ -60,6 +77,18 @@ class INode : public Util::IHasSourceInfo, public IHasDbPrint, public ICastable
     virtual cstring node_type_name() const = 0;
     virtual void validate() const {}
     virtual const Annotation *getAnnotation(cstring) const { return nullptr; }
+
+    /// Casts for IR classes use the Node type id range check; interfaces and templates
+    /// fall back to the ICastable dynamic_cast.  Defined after Node below.
+    template <typename T>
+    bool is() const;
+    template <typename T>
+    const T *to() const;
+    template <typename T>
+    T *to();
+    template <typename T>
+    const T &as() const;
+
     /// A checked version of INode::to. A BUG occurs if the cast fails.
     ///
     /// A similar effect can be achieved with `&as<T>()`, but this method
@@ -91,7 +120,7 @@ class Node : public virtual INode {
     Node &operator=(Node &&) = default;
 
  protected:
-    static int currentId;
+    static std::atomic<int> currentId;  // atomic so nodes can be created on worker threads
     void traceVisit(const char *visitor) const;
     virtual void visit_children(Visitor &) {}
     virtual void visit_children(Visitor &) const {}
@@ -115,6 +144,15 @@ class Node : public virtual INode {
         traceCreation();
     }
     virtual ~Node() {}
+#if HAVE_IR_ARENA
+    /// Nodes are allocated from the calling thread's current Util::Arena, if any (see
+    /// lib/arena.h).  Each node records the arena it came from; deleting a node from an
+    /// arena is a no-op, as the memory is reclaimed when the arena is released.
+    static void *operator new(size_t size);
+    static void operator delete(void *p, size_t size);
+#endif
+    /// The id the next node will get, i.e., the number of nodes created so far.
+    static int nextId() { return currentId; }
     const Node *apply(Visitor &v, const Visitor_Context *ctxt = nullptr) const;
     const Node *apply(Visitor &&v, const Visitor_Context *ctxt = nullptr) const {
         return apply(v, ctxt);
@@ -132,6 +170,55 @@ class Node : public virtual INode {
     cstring toString() const override { return node_type_name(); }
     void toJSON(JSONGenerator &json) const override;
     void sourceInfoToJSON(JSONGenerator &json) const;
+    explicit Node(BinaryLoader &bin);
+    virtual void toBinary(BinaryGenerator &bin) const;
+
+    using type_id_class = Node;
+    static constexpr NodeTypeId static_type_id = 0;
+    static constexpr NodeTypeId static_type_id_last = ~0U;
+    /// The type id of the most derived class generated by the ir-generator.
+    virtual NodeTypeId node_type_id() const { return static_type_id; }
+
+    /// Checks whether the node is of type T.  For classes generated by the ir-generator
+    /// this is a range check on node_type_id() instead of a dynamic_cast.
+    template <typename T>
+    bool is() const {
+        if constexpr (has_static_type_id<T>::value) {
+            NodeTypeId id = node_type_id();
+            return T::static_type_id <= id && id <= T::static_type_id_last;
+        } else {
+            return ICastable::is<T>();
+        }
+    }
+
+    /// Tries to convert the node to type T. Returns a nullptr if the cast fails.
+    template <typename T>
+    const T *to() const {
+        if constexpr (has_static_type_id<T>::value)
+            return is<T>() ? static_cast<const T *>(this) : nullptr;
+        else
+            return ICastable::to<T>();
+    }
+
+    /// Tries to convert the node to type T. Returns a nullptr if the cast fails.
+    template <typename T>
+    T *to() {
+        if constexpr (has_static_type_id<T>::value)
+            return is<T>() ? static_cast<T *>(this) : nullptr;
+        else
+            return ICastable::to<T>();
+    }
+
+    /// Converts the node to type T. Throws std::bad_cast if the cast fails.
+    template <typename T>
+    const T &as() const {
+        if constexpr (has_static_type_id<T>::value) {
+            if (!is<T>()) throw std::bad_cast();
+            return static_cast<const T &>(*this);
+        } else {
+            return ICastable::as<T>();
+        }
+    }
     Util::JsonObject *sourceInfoJsonObj() const;
     /* operator== does a 'shallow' comparison, comparing two Node subclass objects for equality,
      * and comparing pointers in the Node directly for equality */
@@ -147,6 +234,38 @@ class Node : public virtual INode {
     bool operator!=(const Node &n) const { return !operator==(n); }
 };
 
+template <typename T>
+bool INode::is() const {
+    if constexpr (has_static_type_id<T>::value)
+        return getNode()->is<T>();
+    else
+        return ICastable::is<T>();
+}
+
+template <typename T>
+const T *INode::to() const {
+    if constexpr (has_static_type_id<T>::value)
+        return getNode()->to<T>();
+    else
+        return ICastable::to<T>();
+}
+
+template <typename T>
+T *INode::to() {
+    if constexpr (has_static_type_id<T>::value)
+        return getNode()->to<T>();
+    else
+        return ICastable::to<T>();
+}
+
+template <typename T>
+const T &INode::as() const {
+    if constexpr (has_static_type_id<T>::value)
+        return getNode()->as<T>();
+    else
+        return ICastable::as<T>();
+}
+
 // simple version of dbprint
 cstring dbp(const INode *node);
 
@@ -185,6 +304,14 @@ inline bool equiv(const INode *a, const INode *b) {
     void apply_visitor_revisit(Transform &v, const Node *n) const override; \
     void apply_visitor_loop_revisit(Transform &v) const override;
 
+/* type id range of a class generated by the ir-generator, see NodeTypeId */
+#define IRNODE_DECLARE_TYPE_ID(T, ID, LAST)                 \
+ public:                                                    \
+    using type_id_class = T;                                \
+    static constexpr NodeTypeId static_type_id = ID;        \
+    static constexpr NodeTypeId static_type_id_last = LAST; \
+    NodeTypeId node_type_id() const override { return static_type_id; }
+
 /* only define 'apply' for a limited number of classes (those we want to call
  * visitors directly on), as defining it and making it virtual would mean that
  * NO Transform could transform the class into a sibling class */
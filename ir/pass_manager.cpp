@@ -25,6 +25,7 @@ limitations under the License.
 
 #include "ir/dump.h"
 #include "ir/node.h"
+#include "ir/pass_profile.h"
 #include "ir/visitor.h"
 #include "lib/error.h"
 #include "lib/gc.h"
@@ -79,7 +80,11 @@ const IR::Node *PassManager::apply_visitor(const IR::Node *program, const char *
         try {
             try {
                 LOG1(log_indent << name() << " invoking " << v->name());
-                auto after = program->apply(**it);
+                const IR::Node *after;
+                {
+                    PassProfile::Scope profile(name(), v->name());
+                    after = program->apply(**it);
+                }
                 if (LOGGING(3)) {
                     size_t maxmem, mem = gc_mem_inuse(&maxmem);  // triggers gc
                     LOG3(log_indent << "heap after " << v->name() << ": in use " << n4(mem)
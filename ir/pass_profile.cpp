@@ -0,0 +1,117 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/pass_profile.h"
+
+#include <time.h>
+
+#include <cstdlib>
+#include <fstream>
+
+#include "ir/node.h"
+#include "ir/visitor.h"
+#include "lib/arena.h"
+#include "lib/error.h"
+#include "lib/gc.h"
+#include "lib/json.h"
+
+PassProfile *PassProfile::active = nullptr;
+
+static uint64_t clockNs(clockid_t clock) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1000000000UL + ts.tv_nsec;
+}
+
+PassProfile::Counters PassProfile::Counters::now() {
+    Counters rv;
+#ifdef CLOCK_MONOTONIC
+    rv.wallNs = clockNs(CLOCK_MONOTONIC);
+#endif
+#ifdef CLOCK_PROCESS_CPUTIME_ID
+    rv.cpuNs = clockNs(CLOCK_PROCESS_CPUTIME_ID);
+#endif
+    rv.bytesAllocated = gc_bytes_allocated();
+    rv.arenaBytesReserved = Util::Arena::totalBytesReserved();
+    rv.nodesCreated = IR::Node::nextId();
+    rv.nodesVisited = Visitor::nodesVisited;
+    return rv;
+}
+
+static void writeAtExit() {
+    auto *profile = PassProfile::get();
+    if (!profile) return;
+    std::ofstream out(profile->getFile());
+    if (!out) {
+        ::error(ErrorType::ERR_IO, "%1%: cannot open file for the pass profile",
+                profile->getFile());
+        return;
+    }
+    profile->writeTrace(out);
+}
+
+void PassProfile::enable(cstring file) {
+    if (!active) {
+        active = new PassProfile;
+        std::atexit(writeAtExit);
+    }
+    active->file = file;
+    active->owner = std::this_thread::get_id();
+}
+
+PassProfile::Scope::Scope(const char *manager, const char *pass) : profile(active) {
+    if (profile && profile->owner != std::this_thread::get_id()) profile = nullptr;
+    if (!profile) return;
+    event = profile->events.size();
+    profile->events.push_back(Event{manager, pass, profile->depth++, Counters(), Counters()});
+    // read the counters last, so the bookkeeping above is not charged to the pass
+    profile->events.back().start = Counters::now();
+}
+
+PassProfile::Scope::~Scope() {
+    if (!profile) return;
+    profile->events[event].end = Counters::now();
+    --profile->depth;
+}
+
+void PassProfile::writeTrace(std::ostream &out) const {
+    auto *trace = new Util::JsonArray();
+    uint64_t origin = events.empty() ? 0 : events.front().start.wallNs;
+    for (auto &e : events) {
+        auto *args = new Util::JsonObject();
+        args->emplace("manager", e.manager);
+        args->emplace("depth", e.depth);
+        args->emplace("cpu_us", (e.end.cpuNs - e.start.cpuNs) / 1000);
+        args->emplace("bytes_allocated", e.end.bytesAllocated - e.start.bytesAllocated);
+        args->emplace("arena_bytes_reserved",
+                      e.end.arenaBytesReserved - e.start.arenaBytesReserved);
+        args->emplace("nodes_created", e.end.nodesCreated - e.start.nodesCreated);
+        args->emplace("nodes_visited", e.end.nodesVisited - e.start.nodesVisited);
+        auto *ev = new Util::JsonObject();
+        ev->emplace("name", e.pass);
+        ev->emplace("cat", "pass");
+        ev->emplace("ph", "X");
+        ev->emplace("pid", 0);
+        ev->emplace("tid", 0);
+        ev->emplace("ts", (e.start.wallNs - origin) / 1000);
+        ev->emplace("dur", (e.end.wallNs - e.start.wallNs) / 1000);
+        ev->emplace("args", args);
+        trace->append(ev);
+    }
+    auto *root = new Util::JsonObject();
+    root->emplace("traceEvents", trace);
+    root->emplace("displayTimeUnit", "ms");
+    root->serialize(out);
+    out << std::endl;
+}
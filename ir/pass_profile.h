@@ -0,0 +1,82 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _IR_PASS_PROFILE_H_
+#define _IR_PASS_PROFILE_H_
+
+#include <cstdint>
+#include <iosfwd>
+#include <thread>
+#include <vector>
+
+#include "lib/cstring.h"
+
+/// Records the cost of every pass run by a PassManager (including nested PassManagers):
+/// wall time, CPU time, bytes allocated (and reserved by IR arenas), IR nodes created and IR
+/// nodes visited.
+/// Disabled unless enabled with --pass-profile; the results are written as a Chrome
+/// trace (load it in chrome://tracing or https://ui.perfetto.dev).
+/// Only passes run on the thread that enabled profiling are recorded; passes run by
+/// worker threads are accounted to the pass that started them.
+class PassProfile {
+ public:
+    struct Counters {
+        uint64_t wallNs = 0;
+        uint64_t cpuNs = 0;
+        uint64_t bytesAllocated = 0;
+        uint64_t arenaBytesReserved = 0;
+        uint64_t nodesCreated = 0;
+        uint64_t nodesVisited = 0;
+        static Counters now();
+    };
+
+    /// One pass invocation.
+    struct Event {
+        cstring manager;
+        cstring pass;
+        unsigned depth;
+        Counters start, end;
+    };
+
+    static bool enabled() { return active != nullptr; }
+    /// Enables profiling; the trace is written to @p file when the program exits.
+    static void enable(cstring file);
+    /// Stops profiling and discards the events; nothing is written at exit.
+    static void disable() { active = nullptr; }
+    static PassProfile *get() { return active; }
+    cstring getFile() const { return file; }
+
+    /// Measures one pass from construction to destruction; a no-op if profiling is off.
+    class Scope {
+        PassProfile *profile;
+        size_t event = 0;
+
+     public:
+        Scope(const char *manager, const char *pass);
+        ~Scope();
+    };
+
+    const std::vector<Event> &getEvents() const { return events; }
+    void writeTrace(std::ostream &out) const;
+    void clear() { events.clear(); }
+
+ private:
+    static PassProfile *active;
+    cstring file;
+    std::thread::id owner;
+    std::vector<Event> events;
+    unsigned depth = 0;
+};
+
+#endif /* _IR_PASS_PROFILE_H_ */
@@ -16,6 +16,7 @@ limitations under the License.
 
 #include <cstddef>
 #include <map>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,6 +29,7 @@ limitations under the License.
 #include "ir/indexed_vector.h"
 #include "ir/ir.h"
 #include "ir/vector.h"
+#include "lib/arena.h"
 #include "lib/cstring.h"
 #include "lib/error.h"
 #include "lib/error_catalog.h"
@@ -80,13 +82,29 @@ Annotations *Annotations::empty = new Annotations(Vector<Annotation>());
 
 const Type *Type_Stack::at(size_t) const { return elementType; }
 
+/// Types cached for the whole compilation; they must not come from the arena of the phase
+/// that first asks for them (see lib/arena.h).
+template <class T>
+static const T *makeCached() {
+    Util::NoArenaScope noArena;
+    return new T();
+}
+
 const Type_Bits *Type_Bits::get(int width, bool isSigned) {
     // map (width, signed) to type
     using bit_type_key = std::pair<int, bool>;
-    static std::map<bit_type_key, const IR::Type_Bits *> *type_map = nullptr;
-    if (type_map == nullptr) type_map = new std::map<bit_type_key, const IR::Type_Bits *>();
-    auto &result = (*type_map)[std::make_pair(width, isSigned)];
-    if (!result) result = new Type_Bits(width, isSigned);
+    static auto *type_map = new std::map<bit_type_key, const IR::Type_Bits *>();
+    static std::mutex lock;
+    const IR::Type_Bits *result;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto &cached = (*type_map)[std::make_pair(width, isSigned)];
+        if (!cached) {
+            Util::NoArenaScope noArena;
+            cached = new Type_Bits(width, isSigned);
+        }
+        result = cached;
+    }
     if (width > P4CContext::getConfig().maximumWidthSupported())
         ::error(ErrorType::ERR_UNSUPPORTED, "%1%: Compiler only supports widths up to %2%", result,
                 P4CContext::getConfig().maximumWidthSupported());
@@ -94,20 +112,17 @@ const Type_Bits *Type_Bits::get(int width, bool isSigned) {
 }
 
 const Type::Unknown *Type::Unknown::get() {
-    static const Type::Unknown *singleton = nullptr;
-    if (!singleton) singleton = (new Type::Unknown());
+    static const auto *singleton = makeCached<Type::Unknown>();
     return singleton;
 }
 
 const Type::Boolean *Type::Boolean::get() {
-    static const Type::Boolean *singleton = nullptr;
-    if (!singleton) singleton = (new Type::Boolean());
+    static const auto *singleton = makeCached<Type::Boolean>();
     return singleton;
 }
 
 const Type_String *Type_String::get() {
-    static const Type_String *singleton = nullptr;
-    if (!singleton) singleton = (new Type_String());
+    static const auto *singleton = makeCached<Type_String>();
     return singleton;
 }
 
@@ -139,26 +154,22 @@ const Type::Varbits *Type::Varbits::get(Util::SourceInfo si, int sz) {
 const Type::Varbits *Type::Varbits::get() { return new Type::Varbits(0); }
 
 const Type_Dontcare *Type_Dontcare::get() {
-    static const Type_Dontcare *singleton;
-    if (!singleton) singleton = (new Type_Dontcare());
+    static const auto *singleton = makeCached<Type_Dontcare>();
     return singleton;
 }
 
 const Type_State *Type_State::get() {
-    static const Type_State *singleton;
-    if (!singleton) singleton = (new Type_State());
+    static const auto *singleton = makeCached<Type_State>();
     return singleton;
 }
 
 const Type_Void *Type_Void::get() {
-    static const Type_Void *singleton;
-    if (!singleton) singleton = (new Type_Void());
+    static const auto *singleton = makeCached<Type_Void>();
     return singleton;
 }
 
 const Type_MatchKind *Type_MatchKind::get() {
-    static const Type_MatchKind *singleton;
-    if (!singleton) singleton = (new Type_MatchKind());
+    static const auto *singleton = makeCached<Type_MatchKind>();
     return singleton;
 }
 
@@ -29,6 +29,7 @@ limitations under the License.
 #include "ir/namemap.h"
 #include "ir/node.h"
 #include "ir/vector.h"
+#include "lib/arena.h"
 #include "lib/bitops.h"
 #include "lib/cstring.h"
 #include "lib/error.h"
@@ -40,7 +41,10 @@ limitations under the License.
 #define SINGLETON_TYPE(NAME)                                               \
     const IR::Type_##NAME *IR::Type_##NAME::get() {                        \
         static const Type_##NAME *singleton;                               \
-        if (!singleton) singleton = (new Type_##NAME(Util::SourceInfo())); \
+        if (!singleton) {                                                  \
+            Util::NoArenaScope noArena;                                    \
+            singleton = (new Type_##NAME(Util::SourceInfo()));             \
+        }                                                                  \
         return singleton;                                                  \
     }
 SINGLETON_TYPE(Block)
@@ -19,6 +19,9 @@ limitations under the License.
 #include <stdlib.h>
 #include <time.h>
 
+#include <mutex>
+#include <vector>
+
 #include "ir/ir-generated.h"
 #include "lib/source_file.h"
 
@@ -33,6 +36,7 @@ limitations under the License.
 #include "ir/vector.h"
 #include "lib/algorithm.h"
 #include "lib/error_catalog.h"
+#include "lib/flat_ptr_map.h"
 #include "lib/indent.h"
 #include "lib/log.h"
 #include "lib/map.h"
@@ -51,24 +55,26 @@ class Visitor::ChangeTracker {
         bool visitOnce;
         const IR::Node *result;
     };
-    typedef std::unordered_map<const IR::Node *, visit_info_t> visited_t;
+    typedef flat_ptr_map<const IR::Node *, visit_info_t> visited_t;
     visited_t visited;
 
  public:
+    /// Forget all nodes, keeping the memory for the next traversal.
+    void clear() { visited.clear(); }
+
     /** Begin tracking @n during a visiting pass.  Use `finish(@n)` to mark @n as
      * visited once the pass completes.
      */
     void start(const IR::Node *n, bool defaultVisitOnce) {
         // Initialization
-        visited_t::iterator visited_it;
+        visit_info_t *visit_info;
         bool inserted;
         bool visit_in_progress = true;
-        std::tie(visited_it, inserted) =
+        std::tie(visit_info, inserted) =
             visited.emplace(n, visit_info_t{visit_in_progress, defaultVisitOnce, n});
 
         // Sanity check for IR loops
         bool already_present = !inserted;
-        visit_info_t *visit_info = &(visited_it->second);
         if (already_present && visit_info->visit_in_progress) BUG("IR loop detected ");
     }
 
@@ -86,10 +92,9 @@ class Visitor::ChangeTracker {
      * previously been invoked.
      */
     bool finish(const IR::Node *orig, const IR::Node *final) {
-        auto it = visited.find(orig);
-        if (it == visited.end()) BUG("visitor state tracker corrupted");
+        visit_info_t *orig_visit_info = visited.find(orig);
+        if (!orig_visit_info) BUG("visitor state tracker corrupted");
 
-        visit_info_t *orig_visit_info = &(it->second);
         orig_visit_info->visit_in_progress = false;
         if (!final) {
             orig_visit_info->result = final;
@@ -114,19 +119,15 @@ class Visitor::ChangeTracker {
     /** Return a pointer to the visitOnce flag for node @n so that it can be changed
      */
     bool *refVisitOnce(const IR::Node *n) {
-        if (!visited.count(n)) BUG("visitor state tracker corrupted");
-        return &visited.at(n).visitOnce;
+        auto *visit_info = visited.find(n);
+        if (!visit_info) BUG("visitor state tracker corrupted");
+        return &visit_info->visitOnce;
     }
 
     /** Forget nodes that have already been visited, allowing them to be visited
      * again. */
     void revisit_visited() {
-        for (auto it = visited.begin(); it != visited.end();) {
-            if (!it->second.visit_in_progress)
-                it = visited.erase(it);
-            else
-                ++it;
-        }
+        visited.erase_if([](const visit_info_t &info) { return !info.visit_in_progress; });
     }
 
     /** Determine whether @n is currently being visited and the visitor has not finished
@@ -135,8 +136,8 @@ class Visitor::ChangeTracker {
      * @return true if @n is being visited and has not finished
      */
     bool busy(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && it->second.visit_in_progress;
+        auto *visit_info = visited.find(n);
+        return visit_info && visit_info->visit_in_progress;
     }
 
     /** Determine whether @n has been visited and the visitor has finished
@@ -147,8 +148,8 @@ class Visitor::ChangeTracker {
      * @return true if @n has been visited and the visitor is finished and visitOnce is true
      */
     bool done(const IR::Node *n) const {
-        auto it = visited.find(n);
-        return it != visited.end() && !it->second.visit_in_progress && it->second.visitOnce;
+        auto *visit_info = visited.find(n);
+        return visit_info && !visit_info->visit_in_progress && visit_info->visitOnce;
     }
 
     /** Produce the result of visiting @n.
@@ -158,11 +159,13 @@ class Visitor::ChangeTracker {
      * if `start(@n)` has not been invoked.
      */
     const IR::Node *result(const IR::Node *n) const {
-        if (!visited.count(n)) return n;
-        return visited.at(n).result;
+        auto *visit_info = visited.find(n);
+        return visit_info ? visit_info->result : n;
     }
 };
 
+thread_local uint64_t Visitor::nodesVisited = 0;
+
 // static
 bool Visitor::warning_enabled(const Visitor *visitor, int warning_kind) {
     auto errorString = ErrorCatalog::getCatalog().getName(warning_kind);
@@ -194,19 +197,51 @@ Visitor::profile_t Visitor::init_apply(const IR::Node *root, const Context *pare
     ctxt = parent_ctxt;
     return rv;
 }
+/** Visited tables are recycled across visitor applications: a table released by one pass is
+ * cleared and handed to the next one, so passes don't pay for allocating and growing a fresh
+ * hash table every time they are applied.  Clearing costs O(entries used by the last pass):
+ * the index is invalidated by bumping its generation, but the entries are reset one by one. */
+template <class T>
+static std::shared_ptr<T> acquireVisitedTable() {
+    // Not thread_local: libgc does not scan thread local data, so pooled tables would be
+    // collected.  Visitors may run on several threads (p4testgen --parallel), hence the
+    // lock.  The pool is never destroyed, because visitors released by the destructors of
+    // other static objects still return their tables to it.
+    static auto *pool = new std::vector<std::unique_ptr<T>>;
+    static auto *poolLock = new std::mutex;
+    static constexpr size_t maxPooled = 8;
+    T *table = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(*poolLock);
+        if (!pool->empty()) {
+            table = pool->back().release();
+            pool->pop_back();
+        }
+    }
+    if (!table) table = new T;
+    return std::shared_ptr<T>(table, [](T *t) {
+        t->clear();
+        std::lock_guard<std::mutex> lock(*poolLock);
+        if (pool->size() < maxPooled)
+            pool->emplace_back(t);
+        else
+            delete t;
+    });
+}
+
 Visitor::profile_t Modifier::init_apply(const IR::Node *root) {
     auto rv = Visitor::init_apply(root);
-    visited = std::make_shared<ChangeTracker>();
+    visited = acquireVisitedTable<ChangeTracker>();
     return rv;
 }
 Visitor::profile_t Inspector::init_apply(const IR::Node *root) {
     auto rv = Visitor::init_apply(root);
-    visited = std::make_shared<visited_t>();
+    visited = acquireVisitedTable<visited_t>();
     return rv;
 }
 Visitor::profile_t Transform::init_apply(const IR::Node *root) {
     auto rv = Visitor::init_apply(root);
-    visited = std::make_shared<ChangeTracker>();
+    visited = acquireVisitedTable<ChangeTracker>();
     return rv;
 }
 void Visitor::end_apply() {}
@@ -310,6 +345,7 @@ class ForwardChildren : public Visitor {
 const IR::Node *Modifier::apply_visitor(const IR::Node *n, const char *name) {
     if (ctxt) ctxt->child_name = name;
     if (n) {
+        ++nodesVisited;
         PushContext local(ctxt, n);
         if (visited->busy(n)) {
             n->apply_visitor_loop_revisit(*this);
@@ -345,22 +381,23 @@ const IR::Node *Modifier::apply_visitor(const IR::Node *n, const char *name) {
 const IR::Node *Inspector::apply_visitor(const IR::Node *n, const char *name) {
     if (ctxt) ctxt->child_name = name;
     if (n && !join_flows(n)) {
+        ++nodesVisited;
         PushContext local(ctxt, n);
         auto vp = visited->emplace(n, info_t{false, visitDagOnce});
-        if (!vp.second && !vp.first->second.done) {
+        if (!vp.second && !vp.first->done) {
             n->apply_visitor_loop_revisit(*this);
-        } else if (!vp.second && vp.first->second.visitOnce) {
+        } else if (!vp.second && vp.first->visitOnce) {
             n->apply_visitor_revisit(*this);
         } else {
-            vp.first->second.done = false;
-            visitCurrentOnce = &vp.first->second.visitOnce;
+            vp.first->done = false;
+            visitCurrentOnce = &vp.first->visitOnce;
             if (n->apply_visitor_preorder(*this)) {
                 n->visit_children(*this);
-                visitCurrentOnce = &vp.first->second.visitOnce;
+                visitCurrentOnce = &vp.first->visitOnce;
                 n->apply_visitor_postorder(*this);
             }
             if (vp.first != visited->find(n)) BUG("visitor state tracker corrupted");
-            vp.first->second.done = true;
+            vp.first->done = true;
         }
         post_join_flows(n, n);
     }
@@ -375,6 +412,7 @@ const IR::Node *Inspector::apply_visitor(const IR::Node *n, const char *name) {
 const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
     if (ctxt) ctxt->child_name = name;
     if (n) {
+        ++nodesVisited;
         PushContext local(ctxt, n);
         if (visited->busy(n)) {
             n->apply_visitor_loop_revisit(*this);
@@ -434,12 +472,7 @@ const IR::Node *Transform::apply_visitor(const IR::Node *n, const char *name) {
 }
 
 void Inspector::revisit_visited() {
-    for (auto it = visited->begin(); it != visited->end();) {
-        if (it->second.done)
-            it = visited->erase(it);
-        else
-            ++it;
-    }
+    visited->erase_if([](const info_t &info) { return info.done; });
 }
 void Modifier::revisit_visited() { visited->revisit_visited(); }
 bool Modifier::visit_in_progress(const IR::Node *n) const { return visited->busy(n); }
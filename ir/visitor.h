@@ -37,6 +37,7 @@ limitations under the License.
 #include "lib/cstring.h"
 #include "lib/error.h"
 #include "lib/exceptions.h"
+#include "lib/flat_ptr_map.h"
 #include "lib/null.h"
 #include "lib/source_file.h"
 
@@ -277,6 +278,9 @@ class Visitor {
     /// Static version of the above function, which can be called
     /// even if not directly in a visitor
     static bool warning_enabled(const Visitor *visitor, int warning_kind);
+    /// Number of nodes visited by all Inspectors, Modifiers and Transforms running on the
+    /// calling thread; used by PassProfile.
+    static thread_local uint64_t nodesVisited;
     template <
         class T,
         typename = typename std::enable_if<std::is_base_of<Util::IHasSourceInfo, T>::value>::type,
@@ -379,7 +383,7 @@ class Inspector : public virtual Visitor {
     struct info_t {
         bool done, visitOnce;
     };
-    typedef std::unordered_map<const IR::Node *, info_t> visited_t;
+    typedef flat_ptr_map<const IR::Node *, info_t> visited_t;
     std::shared_ptr<visited_t> visited;
     bool check_clone(const Visitor *) override;
 
@@ -399,8 +403,8 @@ class Inspector : public virtual Visitor {
 #undef DECLARE_VISIT_FUNCTIONS
     void revisit_visited();
     bool visit_in_progress(const IR::Node *n) const {
-        if (visited->count(n)) return !visited->at(n).done;
-        return false;
+        auto *info = visited->find(n);
+        return info && !info->done;
     }
 };
 
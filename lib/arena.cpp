@@ -0,0 +1,116 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "arena.h"
+
+#include "config.h"
+#if HAVE_LIBGC
+#include <gc/gc.h>
+#endif /* HAVE_LIBGC */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace Util {
+
+struct alignas(std::max_align_t) Arena::Chunk {
+    Chunk *next;
+    size_t size;  // usable bytes following the header
+    char *data() { return reinterpret_cast<char *>(this + 1); }
+    const char *data() const { return reinterpret_cast<const char *>(this + 1); }
+};
+
+static thread_local Arena *currentArena = nullptr;
+static std::atomic<uint64_t> totalReserved{0};
+
+static void *allocChunk(size_t bytes) {
+#if HAVE_LIBGC
+    // scanned for pointers, but never collected -- freed explicitly in release()
+    return GC_MALLOC_UNCOLLECTABLE(bytes);
+#else
+    return std::malloc(bytes);
+#endif
+}
+
+static void freeChunk(void *p) {
+#if HAVE_LIBGC
+    GC_FREE(p);
+#else
+    std::free(p);
+#endif
+}
+
+void *Arena::allocateSlow(size_t size, size_t align) {
+    // Requests that would waste much of a chunk get a chunk of their own, which goes behind
+    // the current one so that the free space left in the latter is not lost.
+    bool dedicated = size + align > chunkSize / 4;
+    size_t usable = dedicated ? size + align : chunkSize;
+    auto *chunk = static_cast<Chunk *>(allocChunk(sizeof(Chunk) + usable));
+    if (!chunk) throw std::bad_alloc();
+    chunk->size = usable;
+    stats.bytesReserved += usable;
+    stats.peakBytesReserved = std::max(stats.peakBytesReserved, stats.bytesReserved);
+    ++stats.chunks;
+    totalReserved += usable;
+    if (dedicated && chunks) {
+        chunk->next = chunks->next;
+        chunks->next = chunk;
+        auto addr = reinterpret_cast<uintptr_t>(chunk->data());
+        addr = (addr + align - 1) & ~uintptr_t(align - 1);
+        ++stats.allocations;
+        stats.bytesAllocated += size;
+        return reinterpret_cast<void *>(addr);
+    }
+    chunk->next = chunks;
+    chunks = chunk;
+    next = chunk->data();
+    limit = next + usable;
+    return allocate(size, align);
+}
+
+bool Arena::owns(const void *p) const {
+    auto *c = static_cast<const char *>(p);
+    for (auto *chunk = chunks; chunk; chunk = chunk->next)
+        if (c >= chunk->data() && c < chunk->data() + chunk->size) return true;
+    return false;
+}
+
+void Arena::release() {
+    while (auto *chunk = chunks) {
+        chunks = chunk->next;
+        freeChunk(chunk);
+    }
+    next = limit = nullptr;
+    auto peak = stats.peakBytesReserved;
+    auto releases = stats.releases + 1;
+    stats = Stats();
+    stats.peakBytesReserved = peak;
+    stats.releases = releases;
+}
+
+Arena *Arena::current() { return currentArena; }
+
+uint64_t Arena::totalBytesReserved() { return totalReserved; }
+
+ArenaScope::ArenaScope(Arena &arena) : saved(currentArena) { currentArena = &arena; }
+
+ArenaScope::~ArenaScope() { currentArena = saved; }
+
+NoArenaScope::NoArenaScope() : saved(currentArena) { currentArena = nullptr; }
+
+NoArenaScope::~NoArenaScope() { currentArena = saved; }
+
+}  // namespace Util
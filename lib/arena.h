@@ -0,0 +1,109 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _LIB_ARENA_H_
+#define _LIB_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Util {
+
+/// Bump allocator that hands out memory from large chunks and frees all of it at once.
+///
+/// With the ENABLE_IR_ARENA build option, IR nodes created while an arena is current on the
+/// calling thread (see ArenaScope) are allocated from it instead of through the global
+/// operator new.  release() then reclaims all of them in one step, e.g., at the end of a
+/// compilation or of a pipeline whose output has been copied out.  Destructors are not run,
+/// which matches how the rest of the compiler treats IR nodes.
+///
+/// When libgc is in use the chunks are allocated as uncollectable memory, so that the
+/// collector still scans them for pointers to collected objects (cstrings, vector storage).
+/// An Arena is not thread safe; each thread should use its own.
+class Arena {
+    struct Chunk;
+    Chunk *chunks = nullptr;
+    char *next = nullptr;  // free space in the first chunk
+    char *limit = nullptr;
+    size_t chunkSize;
+
+ public:
+    struct Stats {
+        uint64_t allocations = 0;
+        uint64_t bytesAllocated = 0;   // requested by allocate(), since the last release()
+        uint64_t bytesReserved = 0;    // held in chunks, since the last release()
+        uint64_t chunks = 0;
+        uint64_t peakBytesReserved = 0;
+        uint64_t releases = 0;
+    };
+
+    explicit Arena(size_t chunkSize = 1 << 20) : chunkSize(chunkSize) {}
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+    ~Arena() { release(); }
+
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t));
+    /// True if p points into memory handed out by this arena since the last release().
+    bool owns(const void *p) const;
+    /// Frees everything allocated from this arena.
+    void release();
+    const Stats &getStats() const { return stats; }
+
+    /// The arena used for IR nodes created by the calling thread, or null.
+    static Arena *current();
+    /// Bytes reserved by all arenas since the program started; used by --pass-profile.
+    static uint64_t totalBytesReserved();
+
+ private:
+    Stats stats;
+    void *allocateSlow(size_t size, size_t align);
+    friend class ArenaScope;
+};
+
+/// Makes an arena current on the calling thread for the lifetime of the object.  Scopes nest;
+/// the previously current arena (if any) is restored on destruction.
+class ArenaScope {
+    Arena *saved;
+
+ public:
+    explicit ArenaScope(Arena &arena);
+    ArenaScope(const ArenaScope &) = delete;
+    ~ArenaScope();
+};
+
+/// Makes no arena current on the calling thread for the lifetime of the object.  Used for
+/// nodes that are cached for the whole compilation, which must not be freed when the arena
+/// of the phase that first needed them is released.
+class NoArenaScope {
+    Arena *saved;
+
+ public:
+    NoArenaScope();
+    NoArenaScope(const NoArenaScope &) = delete;
+    ~NoArenaScope();
+};
+
+inline void *Arena::allocate(size_t size, size_t align) {
+    auto addr = (reinterpret_cast<uintptr_t>(next) + align - 1) & ~uintptr_t(align - 1);
+    if (next == nullptr || addr + size > reinterpret_cast<uintptr_t>(limit))
+        return allocateSlow(size, align);
+    next = reinterpret_cast<char *>(addr + size);
+    ++stats.allocations;
+    stats.bytesAllocated += size;
+    return reinterpret_cast<void *>(addr);
+}
+
+}  // namespace Util
+
+#endif /* _LIB_ARENA_H_ */
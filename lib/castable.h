@@ -22,6 +22,8 @@ limitations under the License.
 #include "lib/exceptions.h"
 
 /// Handy type conversion methods that can be inherited by various base classes.
+/// These use dynamic_cast; IR::Node shadows them with constant-time checks based on the
+/// type ids generated by the ir-generator.
 class ICastable {
  public:
     virtual ~ICastable() {}
@@ -17,7 +17,10 @@ limitations under the License.
 #include "cstring.h"
 
 #include <algorithm>
+#include <array>
 #include <ios>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_set>
 
@@ -42,6 +45,7 @@ inline table_entry_flags operator|(table_entry_flags l, table_entry_flags r) {
 // cache entry, ordered by string length
 class table_entry {
     std::size_t m_length = 0;
+    std::size_t m_hash = 0;
     table_entry_flags m_flags = table_entry_flags::none;
 
     union {
@@ -51,8 +55,9 @@ class table_entry {
 
  public:
     // entry ctor, makes copy of passed string
-    table_entry(const char *string, std::size_t length, table_entry_flags flags)
-        : m_length(length) {
+    table_entry(const char *string, std::size_t length, std::size_t hash,
+                table_entry_flags flags)
+        : m_length(length), m_hash(hash) {
         if ((flags & table_entry_flags::no_need_copy) == table_entry_flags::no_need_copy) {
             // No need to copy object, it's view of string, string literal or string allocated
             // on heap and wrapped with cstring.
@@ -87,7 +92,8 @@ class table_entry {
     // table_entry moveable only
     table_entry(const table_entry &) = delete;
 
-    table_entry(table_entry &&other) : m_length(other.m_length), m_flags(other.m_flags) {
+    table_entry(table_entry &&other)
+        : m_length(other.m_length), m_hash(other.m_hash), m_flags(other.m_flags) {
         // this object for internal usage only, length will never be accessed
         // if object was moved, so do not zero other.m_length here
 
@@ -110,6 +116,7 @@ class table_entry {
     }
 
     std::size_t length() const { return m_length; }
+    std::size_t hash() const { return m_hash; }
 
     const char *string() const {
         if (is_inplace()) {
@@ -130,35 +137,69 @@ class table_entry {
 };
 }  // namespace
 
-namespace std {
-template <>
-struct hash<table_entry> {
-    std::size_t operator()(const table_entry &entry) const {
-        return Util::Hash::murmur(entry.string(), entry.length());
-    }
+namespace {
+struct table_entry_hash {
+    std::size_t operator()(const table_entry &entry) const { return entry.hash(); }
 };
-}  // namespace std
 
-namespace {
-std::unordered_set<table_entry> &cache() {
-    static std::unordered_set<table_entry> g_cache;
+// The intern table is split into shards selected by the string hash, each with its own lock,
+// so threads interning different strings rarely contend.  Lookups of strings that are already
+// interned (the common case) only take a shared lock.
+class intern_table {
+    struct alignas(64) shard {
+        std::shared_mutex mutex;
+        std::unordered_set<table_entry, table_entry_hash> entries;
+    };
+    static constexpr std::size_t shard_count = 64;
+    std::array<shard, shard_count> shards;
 
-    return g_cache;
-}
+    // the low bits of the hash select the bucket in the shard's set
+    shard &get_shard(std::size_t hash) { return shards[(hash >> 16) % shard_count]; }
 
-const char *save_to_cache(const char *string, std::size_t length, table_entry_flags flags) {
-    if ((flags & table_entry_flags::no_need_copy) == table_entry_flags::no_need_copy) {
-        return cache().emplace(string, length, flags).first->string();
-    }
+ public:
+    const char *save(const char *string, std::size_t length, table_entry_flags flags) {
+        auto hash = Util::Hash::murmur(string, length);
+        auto &sh = get_shard(hash);
+        {
+            // temporary table_entry, used for searching only. no need to copy string
+            std::shared_lock<std::shared_mutex> lock(sh.mutex);
+            auto found = sh.entries.find(
+                table_entry(string, length, hash, table_entry_flags::no_need_copy));
+            if (found != sh.entries.end()) {
+                // we were given ownership of the string, but don't need it
+                if ((flags & table_entry_flags::require_destruction) ==
+                    table_entry_flags::require_destruction)
+                    delete[] string;
+                return found->string();
+            }
+        }
 
-    // temporary table_entry, used for searching only. no need to copy string
-    auto found = cache().find(table_entry(string, length, table_entry_flags::no_need_copy));
+        // another thread may have inserted the string in the meantime; emplace then
+        // returns its entry
+        std::unique_lock<std::shared_mutex> lock(sh.mutex);
+        return sh.entries.emplace(string, length, hash, flags).first->string();
+    }
 
-    if (found == cache().end()) {
-        return cache().emplace(string, length, flags).first->string();
+    std::size_t size(std::size_t &count) {
+        std::size_t rv = 0;
+        count = 0;
+        for (auto &sh : shards) {
+            std::shared_lock<std::shared_mutex> lock(sh.mutex);
+            count += sh.entries.size();
+            for (auto &s : sh.entries) rv += sizeof(s) + s.length();
+        }
+        return rv;
     }
+};
+
+intern_table &cache() {
+    static intern_table g_cache;
 
-    return found->string();
+    return g_cache;
+}
+
+const char *save_to_cache(const char *string, std::size_t length, table_entry_flags flags) {
+    return cache().save(string, length, flags);
 }
 
 }  // namespace
@@ -176,12 +217,7 @@ void cstring::construct_from_literal(const char *string, std::size_t length) {
     str = save_to_cache(string, length, table_entry_flags::no_need_copy);
 }
 
-size_t cstring::cache_size(size_t &count) {
-    size_t rv = 0;
-    count = cache().size();
-    for (auto &s : cache()) rv += sizeof(s) + s.length();
-    return rv;
-}
+size_t cstring::cache_size(size_t &count) { return cache().size(count); }
 
 cstring cstring::newline = cstring("\n");
 cstring cstring::empty = cstring("");
@@ -50,8 +50,11 @@ limitations under the License.
  *     std::string.
  *   - Interned strings can never be freed, so they'll stick around for the
  *     lifetime of the program.
- *   - The string interning cstring performs is currently not threadsafe, so you
- *     can't safely use cstrings off the main thread.
+ *   - The intern table is sharded and each shard has its own reader/writer
+ *     lock, so cstrings can be created from several threads; looking up an
+ *     already interned string only takes a shared lock.  Note that interning a
+ *     new string allocates memory, which with libgc is only safe on threads the
+ *     collector knows about.
  *
  * Given these tradeoffs, the general rule of thumb to follow is that you should
  * try to convert strings to cstrings early and keep them in that form. That
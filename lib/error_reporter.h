@@ -17,6 +17,8 @@ limitations under the License.
 #ifndef _LIB_ERROR_REPORTER_H_
 #define _LIB_ERROR_REPORTER_H_
 
+#include <mutex>
+
 #include "error_catalog.h"
 #include "error_helper.h"
 #include "exceptions.h"
@@ -65,6 +67,14 @@ class ErrorReporter {
         return !p.second;  // if insertion took place, then we have not seen the error.
     }
 
+    /// Serializes diagnostics reported by passes running on worker threads.  Shared by all
+    /// reporters so that they remain copyable; diagnostics are rare enough for this not
+    /// to matter.
+    static std::recursive_mutex &diagnosticLock() {
+        static std::recursive_mutex lock;
+        return lock;
+    }
+
     /// retrieve the format from the error catalog
     const char *get_error_name(int errorCode) {
         return ErrorCatalog::getCatalog().getName(errorCode);
@@ -100,6 +110,7 @@ class ErrorReporter {
         typename... Args>
     void diagnose(DiagnosticAction action, const int errorCode, const char *format,
                   const char *suffix, const T *node, Args... args) {
+        std::lock_guard<std::recursive_mutex> lock(diagnosticLock());
         if (!error_reported(errorCode, node->getSourceInfo())) {
             const char *name = get_error_name(errorCode);
             auto da = getDiagnosticAction(name, action);
@@ -136,6 +147,7 @@ class ErrorReporter {
     void diagnose(DiagnosticAction action, const char *diagnosticName, const char *format,
                   const char *suffix, T... args) {
         if (action == DiagnosticAction::Ignore) return;
+        std::lock_guard<std::recursive_mutex> lock(diagnosticLock());
 
         ErrorMessage::MessageType msgType = ErrorMessage::MessageType::None;
         if (action == DiagnosticAction::Warn) {
@@ -233,6 +245,11 @@ class ErrorReporter {
         diagnosticActions[diagnostic] = action;
     }
 
+    /// @return the actions set for individual diagnostics.
+    const std::unordered_map<cstring, DiagnosticAction> &getDiagnosticActions() const {
+        return diagnosticActions;
+    }
+
     /// @return the default diagnostic action for calls to `::warning()`.
     DiagnosticAction getDefaultWarningDiagnosticAction() { return defaultWarningDiagnosticAction; }
 
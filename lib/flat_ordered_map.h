@@ -0,0 +1,389 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _LIB_FLAT_ORDERED_MAP_H_
+#define _LIB_FLAT_ORDERED_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Map that iterates in insertion order, like ordered_map, but keyed on a hash instead of
+/// an ordering.  It is meant for the large, hot maps of the compiler (type maps, reference
+/// maps, declaration indexes, JSON objects), where ordered_map's std::list + std::map costs
+/// two allocations per insertion and a pointer chase per comparison.
+///
+/// - Entries are stored in insertion order in chunks of doubling size that are never moved,
+///   so references, pointers and iterators stay valid when other entries are inserted or
+///   erased.  end() stays end().  Iterators refer to the map object, so unlike references
+///   they do not survive moving the map.
+/// - Maps of up to linear_limit entries are searched linearly; larger ones get an
+///   open-addressing (linear probing) index over the entries.
+/// - Erasing leaves a hole that iteration skips; holes are reclaimed when they are at the
+///   end of the map, and when the map is cleared or copied.
+/// Unlike ordered_map there are no lower_bound/upper_bound queries, no insertion at a
+/// position and no sort().
+template <class K, class V, class HASH = std::hash<K>, class PRED = std::equal_to<K>>
+class flat_ordered_map {
+ public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<const K, V> value_type;
+    typedef HASH hasher;
+    typedef PRED key_equal;
+    typedef value_type &reference;
+    typedef const value_type &const_reference;
+    typedef size_t size_type;
+
+ private:
+    struct entry_t {
+        bool live;
+        alignas(value_type) unsigned char storage[sizeof(value_type)];
+        value_type &value() { return *std::launder(reinterpret_cast<value_type *>(storage)); }
+    };
+    static constexpr unsigned first_chunk_bits = 2;
+    static constexpr uint32_t linear_limit = 8;
+    static constexpr uint32_t npos = ~0U;
+    static constexpr uint32_t tombstone = ~0U;  // in the index; 0 is an empty slot
+
+    // Chunk c holds entries [B * (2^c - 1), B * (2^(c+1) - 1)), with B = 2^first_chunk_bits.
+    std::vector<std::unique_ptr<entry_t[]>> chunks;
+    uint32_t capacity = 0;
+    uint32_t used = 0;  // entries handed out, including holes
+    uint32_t live = 0;
+    std::vector<uint32_t> index;  // entry + 1, 0 or tombstone; empty while linear
+    unsigned index_bits = 0;
+    uint32_t index_used = 0;  // slots that are not empty, including tombstones
+    HASH hash;
+    PRED equal;
+
+    entry_t &get_entry(uint32_t e) const {
+        uint64_t q = (uint64_t(e) >> first_chunk_bits) + 1;
+        unsigned c = 63 - __builtin_clzll(q);
+        return chunks[c][e - ((uint64_t(1) << (c + first_chunk_bits)) - (1U << first_chunk_bits))];
+    }
+    size_t bucket(const K &k) const {
+        // Fibonacci hashing, since std::hash is the identity for pointers
+        uint64_t h = hash(k);
+        return (h * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - index_bits);
+    }
+    uint32_t find_entry(const K &k) const {
+        if (index.empty()) {
+            for (uint32_t e = 0; e < used; ++e) {
+                auto &ent = get_entry(e);
+                if (ent.live && equal(ent.value().first, k)) return e;
+            }
+            return npos;
+        }
+        for (size_t i = bucket(k);; i = (i + 1) & (index.size() - 1)) {
+            uint32_t s = index[i];
+            if (s == 0) return npos;
+            if (s != tombstone && equal(get_entry(s - 1).value().first, k)) return s - 1;
+        }
+    }
+    void place(uint32_t e) {
+        size_t i = bucket(get_entry(e).value().first);
+        while (index[i] != 0) i = (i + 1) & (index.size() - 1);
+        index[i] = e + 1;
+        ++index_used;
+    }
+    void rehash() {
+        unsigned bits = 4;
+        while ((size_t(1) << bits) < size_t(live) * 4) ++bits;
+        index_bits = bits;
+        index.assign(size_t(1) << bits, 0);
+        index_used = 0;
+        for (uint32_t e = 0; e < used; ++e)
+            if (get_entry(e).live) place(e);
+    }
+    template <typename KK, typename... VV>
+    uint32_t append(KK &&k, VV &&...v) {
+        if (used == capacity) {
+            uint32_t size = 1U << (chunks.size() + first_chunk_bits);
+            chunks.emplace_back(new entry_t[size]());
+            capacity += size;
+        }
+        uint32_t e = used;
+        auto &ent = get_entry(e);
+        new (ent.storage) value_type(std::piecewise_construct,
+                                     std::forward_as_tuple(std::forward<KK>(k)),
+                                     std::forward_as_tuple(std::forward<VV>(v)...));
+        ent.live = true;
+        ++used;
+        ++live;
+        if (!index.empty() && (index_used + 1) * 2 <= index.size())
+            place(e);
+        else if (!index.empty() || used > linear_limit)
+            rehash();
+        return e;
+    }
+    void destroy(uint32_t e) {
+        auto &ent = get_entry(e);
+        ent.value().~value_type();
+        ent.live = false;
+        --live;
+    }
+    uint32_t next_live(uint32_t e) const {
+        while (e < used && !get_entry(e).live) ++e;
+        return e < used ? e : npos;
+    }
+    void copy_from(const flat_ordered_map &a) {
+        for (auto &v : a) append(v.first, v.second);
+    }
+
+ public:
+    template <bool Const>
+    class iter_t {
+        friend class flat_ordered_map;
+        template <bool>
+        friend class iter_t;
+        typedef typename std::conditional<Const, const flat_ordered_map, flat_ordered_map>::type
+            map_t;
+        map_t *map = nullptr;
+        uint32_t e = npos;
+        iter_t(map_t *map, uint32_t e) : map(map), e(e) {}
+
+     public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef flat_ordered_map::value_type value_type;
+        typedef ptrdiff_t difference_type;
+        typedef typename std::conditional<Const, const value_type *, value_type *>::type pointer;
+        typedef typename std::conditional<Const, const value_type &, value_type &>::type
+            reference;
+
+        iter_t() = default;
+        template <bool C, typename = typename std::enable_if<Const && !C>::type>
+        iter_t(const iter_t<C> &a) : map(a.map), e(a.e) {}  // NOLINT(runtime/explicit)
+
+        reference operator*() const { return map->get_entry(e).value(); }
+        pointer operator->() const { return &map->get_entry(e).value(); }
+        iter_t &operator++() {
+            e = map->next_live(e + 1);
+            return *this;
+        }
+        iter_t operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+        iter_t &operator--() {
+            if (e == npos) e = map->used;
+            do {
+                --e;
+            } while (!map->get_entry(e).live);
+            return *this;
+        }
+        iter_t operator--(int) {
+            auto copy = *this;
+            --*this;
+            return copy;
+        }
+        template <bool C>
+        bool operator==(const iter_t<C> &a) const {
+            return e == a.e;
+        }
+        template <bool C>
+        bool operator!=(const iter_t<C> &a) const {
+            return e != a.e;
+        }
+    };
+    typedef iter_t<false> iterator;
+    typedef iter_t<true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    flat_ordered_map() = default;
+    flat_ordered_map(const flat_ordered_map &a) : hash(a.hash), equal(a.equal) { copy_from(a); }
+    flat_ordered_map(flat_ordered_map &&a) noexcept { swap(a); }
+    template <typename InputIt>
+    flat_ordered_map(InputIt first, InputIt last) {
+        insert(first, last);
+    }
+    flat_ordered_map(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+    ~flat_ordered_map() { clear(); }
+    flat_ordered_map &operator=(const flat_ordered_map &a) {
+        if (this != &a) {
+            clear();
+            copy_from(a);
+        }
+        return *this;
+    }
+    flat_ordered_map &operator=(flat_ordered_map &&a) noexcept {
+        if (this != &a) {
+            clear();
+            swap(a);
+        }
+        return *this;
+    }
+    void swap(flat_ordered_map &a) noexcept {
+        using std::swap;
+        swap(chunks, a.chunks);
+        swap(capacity, a.capacity);
+        swap(used, a.used);
+        swap(live, a.live);
+        swap(index, a.index);
+        swap(index_bits, a.index_bits);
+        swap(index_used, a.index_used);
+        swap(hash, a.hash);
+        swap(equal, a.equal);
+    }
+
+    iterator begin() noexcept { return iterator(this, next_live(0)); }
+    const_iterator begin() const noexcept { return const_iterator(this, next_live(0)); }
+    iterator end() noexcept { return iterator(this, npos); }
+    const_iterator end() const noexcept { return const_iterator(this, npos); }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    bool empty() const noexcept { return live == 0; }
+    size_type size() const noexcept { return live; }
+    size_type max_size() const noexcept { return npos - 1; }
+    bool operator==(const flat_ordered_map &a) const {
+        if (size() != a.size()) return false;
+        for (auto i = begin(), j = a.begin(); i != end(); ++i, ++j)
+            if (!(*i == *j)) return false;
+        return true;
+    }
+    bool operator!=(const flat_ordered_map &a) const { return !(*this == a); }
+    void clear() {
+        for (uint32_t e = 0; e < used; ++e)
+            if (get_entry(e).live) destroy(e);
+        used = 0;
+        index.clear();
+        index_bits = 0;
+        index_used = 0;
+    }
+
+    iterator find(const key_type &k) {
+        uint32_t e = find_entry(k);
+        return iterator(this, e);
+    }
+    const_iterator find(const key_type &k) const { return const_iterator(this, find_entry(k)); }
+    size_type count(const key_type &k) const { return find_entry(k) != npos; }
+
+    V &operator[](const K &k) {
+        uint32_t e = find_entry(k);
+        if (e == npos) e = append(k);
+        return get_entry(e).value().second;
+    }
+    V &operator[](K &&k) {
+        uint32_t e = find_entry(k);
+        if (e == npos) e = append(std::move(k));
+        return get_entry(e).value().second;
+    }
+    V &at(const K &k) {
+        uint32_t e = find_entry(k);
+        if (e == npos) throw std::out_of_range("flat_ordered_map::at");
+        return get_entry(e).value().second;
+    }
+    const V &at(const K &k) const {
+        uint32_t e = find_entry(k);
+        if (e == npos) throw std::out_of_range("flat_ordered_map::at");
+        return get_entry(e).value().second;
+    }
+
+    template <typename KK, typename... VV>
+    std::pair<iterator, bool> emplace(KK &&k, VV &&...v) {
+        uint32_t e = find_entry(k);
+        if (e != npos) return std::make_pair(iterator(this, e), false);
+        e = append(std::forward<KK>(k), std::forward<VV>(v)...);
+        return std::make_pair(iterator(this, e), true);
+    }
+    std::pair<iterator, bool> insert(const value_type &v) { return emplace(v.first, v.second); }
+    template <class InputIterator>
+    void insert(InputIterator b, InputIterator e) {
+        for (; b != e; ++b) insert(*b);
+    }
+
+    iterator erase(const_iterator pos) {
+        uint32_t e = pos.e;
+        if (!index.empty()) {
+            size_t i = bucket(get_entry(e).value().first);
+            while (index[i] != e + 1) i = (i + 1) & (index.size() - 1);
+            index[i] = tombstone;
+        }
+        destroy(e);
+        uint32_t next = next_live(e + 1);
+        if (next == npos) {
+            while (used > 0 && !get_entry(used - 1).live) --used;
+        }
+        if (live == 0) clear();
+        return iterator(this, next);
+    }
+    size_type erase(const K &k) {
+        uint32_t e = find_entry(k);
+        if (e == npos) return 0;
+        erase(const_iterator(this, e));
+        return 1;
+    }
+};
+
+// See ordered_map.h for why these are in a namespace.
+namespace GetImpl {
+
+template <class K, class T, class V, class Hash, class Pred>
+inline V get(const flat_ordered_map<K, V, Hash, Pred> &m, T key, V def = V()) {
+    auto it = m.find(key);
+    if (it != m.end()) return it->second;
+    return def;
+}
+
+template <class K, class T, class V, class Hash, class Pred>
+inline V *getref(flat_ordered_map<K, V, Hash, Pred> &m, T key) {
+    auto it = m.find(key);
+    if (it != m.end()) return &it->second;
+    return 0;
+}
+
+template <class K, class T, class V, class Hash, class Pred>
+inline const V *getref(const flat_ordered_map<K, V, Hash, Pred> &m, T key) {
+    auto it = m.find(key);
+    if (it != m.end()) return &it->second;
+    return 0;
+}
+
+template <class K, class T, class V, class Hash, class Pred>
+inline V get(const flat_ordered_map<K, V, Hash, Pred> *m, T key, V def = V()) {
+    return m ? get(*m, key, def) : def;
+}
+
+template <class K, class T, class V, class Hash, class Pred>
+inline V *getref(flat_ordered_map<K, V, Hash, Pred> *m, T key) {
+    return m ? getref(*m, key) : 0;
+}
+
+template <class K, class T, class V, class Hash, class Pred>
+inline const V *getref(const flat_ordered_map<K, V, Hash, Pred> *m, T key) {
+    return m ? getref(*m, key) : 0;
+}
+
+}  // namespace GetImpl
+using namespace GetImpl;  // NOLINT(build/namespaces)
+
+#endif /* _LIB_FLAT_ORDERED_MAP_H_ */
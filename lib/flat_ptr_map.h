@@ -0,0 +1,142 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _LIB_FLAT_PTR_MAP_H_
+#define _LIB_FLAT_PTR_MAP_H_
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// Map from pointers to small values, intended for per-traversal bookkeeping (such as the
+/// visited tables of the IR visitors) where the same map is filled and cleared many times.
+///
+/// - Lookup is an open-addressing (linear probing) hash table over an index array.
+/// - Values live in fixed-size chunks that are never moved, so pointers returned by find()
+///   and emplace() stay valid until clear(), even when the table grows or entries are erased.
+/// - clear() bumps a generation counter instead of touching the index, and keeps all memory
+///   for reuse.  It resets the entries handed out since the last clear(), so that the chunks,
+///   which the garbage collector scans, do not keep the keys and values of a finished
+///   traversal alive.
+/// Keys must not be null.  Erased entries are not reclaimed until the next clear().
+template <class K, class V>
+class flat_ptr_map {
+    static_assert(std::is_pointer<K>::value, "flat_ptr_map keys must be pointers");
+
+    struct entry_t {
+        K key;
+        V value;
+    };
+    struct slot_t {
+        uint32_t gen = 0;    // slot is empty unless gen == generation
+        uint32_t entry = 0;  // index into the chunks, or tombstone
+    };
+    static constexpr unsigned chunk_bits = 10;
+    static constexpr uint32_t chunk_size = 1U << chunk_bits;
+    static constexpr uint32_t tombstone = ~0U;
+
+    std::vector<std::unique_ptr<entry_t[]>> chunks;
+    std::vector<slot_t> index;
+    unsigned index_bits = 4;
+    uint32_t generation = 1;
+    uint32_t used = 0;      // entries handed out from the chunks since the last clear()
+    uint32_t occupied = 0;  // index slots of the current generation, including tombstones
+    uint32_t live = 0;
+
+    entry_t &get_entry(uint32_t e) const { return chunks[e >> chunk_bits][e & (chunk_size - 1)]; }
+    size_t bucket(K key) const {
+        // Fibonacci hashing: the high bits of the product are well mixed
+        uint64_t h = reinterpret_cast<uintptr_t>(key);
+        return (h * UINT64_C(0x9E3779B97F4A7C15)) >> (64 - index_bits);
+    }
+    // Returns the slot holding key, or the first empty slot of its probe sequence.
+    slot_t *probe(K key) const {
+        for (size_t i = bucket(key);; i = (i + 1) & (index.size() - 1)) {
+            auto *slot = const_cast<slot_t *>(&index[i]);
+            if (slot->gen != generation) return slot;
+            if (slot->entry != tombstone && get_entry(slot->entry).key == key) return slot;
+        }
+    }
+    void rehash(unsigned bits) {
+        index_bits = bits;
+        index.assign(size_t(1) << bits, slot_t());
+        generation = 1;
+        occupied = 0;
+        for (uint32_t e = 0; e < used; ++e) {
+            auto &ent = get_entry(e);
+            if (!ent.key) continue;
+            auto *slot = probe(ent.key);
+            *slot = slot_t{generation, e};
+            ++occupied;
+        }
+    }
+
+ public:
+    flat_ptr_map() { index.resize(size_t(1) << index_bits); }
+    flat_ptr_map(const flat_ptr_map &) = delete;
+    flat_ptr_map &operator=(const flat_ptr_map &) = delete;
+
+    size_t size() const { return live; }
+    bool empty() const { return live == 0; }
+
+    V *find(K key) {
+        auto *slot = probe(key);
+        return slot->gen == generation ? &get_entry(slot->entry).value : nullptr;
+    }
+    const V *find(K key) const { return const_cast<flat_ptr_map *>(this)->find(key); }
+    size_t count(K key) const { return find(key) != nullptr; }
+
+    /// Inserts (key, value) unless key is already present.  Returns a pointer to the value
+    /// stored for key, and whether it was inserted.
+    std::pair<V *, bool> emplace(K key, const V &value) {
+        if (auto *v = find(key)) return {v, false};
+        if ((occupied + 1) * 2 > index.size())
+            rehash(live * 4 >= index.size() ? index_bits + 1 : index_bits);
+        if (used == chunks.size() * chunk_size) chunks.emplace_back(new entry_t[chunk_size]);
+        auto &ent = get_entry(used);
+        ent.key = key;
+        ent.value = value;
+        *probe(key) = slot_t{generation, used++};
+        ++occupied;
+        ++live;
+        return {&ent.value, true};
+    }
+
+    /// Erases all entries whose value satisfies pred; the others do not move.
+    template <class P>
+    void erase_if(P pred) {
+        for (auto &slot : index) {
+            if (slot.gen != generation || slot.entry == tombstone) continue;
+            auto &ent = get_entry(slot.entry);
+            if (!pred(ent.value)) continue;
+            ent.key = nullptr;
+            slot.entry = tombstone;
+            --live;
+        }
+    }
+
+    void clear() {
+        for (uint32_t e = 0; e < used; ++e) get_entry(e) = entry_t();
+        used = occupied = live = 0;
+        if (++generation == 0) {
+            // wrapped around -- old slots could look current again
+            index.assign(index.size(), slot_t());
+            generation = 1;
+        }
+    }
+};
+
+#endif /* _LIB_FLAT_PTR_MAP_H_ */
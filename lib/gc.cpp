@@ -16,6 +16,7 @@ limitations under the License.
 
 #include "config.h"
 #if HAVE_LIBGC
+#define GC_THREADS
 #include <gc/gc_cpp.h>
 #include <gc/gc_mark.h>
 #endif /* HAVE_LIBGC */
@@ -53,6 +54,7 @@ void *operator new(std::size_t size) {
     if (!done_init) {
         started_init = true;
         GC_INIT();
+        GC_allow_register_threads();
         done_init = true;
     }
     auto *rv = ::operator new(size, UseGC, 0, 0);
@@ -220,3 +222,27 @@ size_t gc_mem_inuse(size_t *max) {
     return 0;
 #endif
 }
+
+size_t gc_bytes_allocated() {
+#if HAVE_LIBGC
+    return GC_get_total_bytes();
+#else
+    return 0;
+#endif
+}
+
+GCThreadScope::GCThreadScope() {
+#if HAVE_LIBGC
+    struct GC_stack_base stack;
+    // GC_register_my_thread fails with GC_DUPLICATE on threads that are already known,
+    // e.g. the main thread; those must not be unregistered.
+    registered = GC_get_stack_base(&stack) == GC_SUCCESS &&
+                 GC_register_my_thread(&stack) == GC_SUCCESS;
+#endif
+}
+
+GCThreadScope::~GCThreadScope() {
+#if HAVE_LIBGC
+    if (registered) GC_unregister_my_thread();
+#endif
+}
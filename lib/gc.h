@@ -21,5 +21,18 @@ limitations under the License.
 
 void setup_gc_logging();
 size_t gc_mem_inuse(size_t *max = 0);  // trigger GC, return inuse after
+size_t gc_bytes_allocated();           // total bytes allocated so far, 0 without libgc
+
+/// Registers the calling thread with the garbage collector for the lifetime of the object.
+/// Threads other than the main one must hold one while they allocate memory or hold
+/// pointers to collected memory.
+class GCThreadScope {
+    bool registered = false;
+
+ public:
+    GCThreadScope();
+    GCThreadScope(const GCThreadScope &) = delete;
+    ~GCThreadScope();
+};
 
 #endif /* LIB_GC_H_ */
@@ -116,29 +116,7 @@ bool JsonValue::operator==(const JsonValue &other) const {
     }
 }
 
-void JsonArray::serialize(std::ostream &out) const {
-    bool isSmall = true;
-    for (auto v : *this) {
-        if (!v->is<JsonValue>()) isSmall = false;
-    }
-    out << "[";
-    if (!isSmall) out << IndentCtl::indent;
-    bool first = true;
-    for (auto v : *this) {
-        if (!first) {
-            out << ",";
-            if (isSmall) out << " ";
-        }
-        if (!isSmall) out << IndentCtl::endl;
-        if (v == nullptr)
-            out << "null";
-        else
-            v->serialize(out);
-        first = false;
-    }
-    if (!isSmall) out << IndentCtl::unindent << IndentCtl::endl;
-    out << "]";
-}
+void JsonArray::serialize(std::ostream &out) const { JsonWriter(out).json(this); }
 
 bool JsonValue::getBool() const {
     if (!isBool()) throw std::logic_error("Incorrect json value kind");
@@ -166,22 +144,7 @@ JsonArray *JsonArray::append(IJson *value) {
     return this;
 }
 
-void JsonObject::serialize(std::ostream &out) const {
-    out << "{" << IndentCtl::indent;
-    bool first = true;
-    for (auto &it : *this) {
-        if (!first) out << ",";
-        first = false;
-        out << IndentCtl::endl;
-        out << "\"" << it.first << "\""
-            << " : ";
-        if (it.second == nullptr)
-            out << "null";
-        else
-            it.second->serialize(out);
-    }
-    out << IndentCtl::unindent << IndentCtl::endl << "}";
-}
+void JsonObject::serialize(std::ostream &out) const { JsonWriter(out).json(this); }
 
 JsonObject *JsonObject::emplace(cstring label, IJson *value) {
     if (label.isNullOrEmpty()) throw std::logic_error("Empty label");
@@ -192,7 +155,7 @@ JsonObject *JsonObject::emplace(cstring label, IJson *value) {
                                        "for a label which already exists ") +
                                label.c_str() + " " + s.c_str());
     }
-    ordered_map<cstring, IJson *>::emplace(label, value);
+    flat_ordered_map<cstring, IJson *>::emplace(label, value);
     return this;
 }
 
@@ -203,4 +166,105 @@ JsonObject *JsonObject::emplace_non_null(cstring label, IJson *value) {
     return this;
 }
 
+void JsonWriter::newline() {
+    // Unlike IndentCtl::endl, does not flush the stream at every line
+    out << '\n' << indent_t::getindent(out);
+}
+
+void JsonWriter::beginValue() {
+    if (scopes.empty()) return;
+    auto &scope = scopes.back();
+    if (!scope.isArray) return;  // the key was written
+    if (!scope.empty) {
+        out << ",";
+        if (scope.isSmall) out << " ";
+    }
+    if (!scope.isSmall) newline();
+    scope.empty = false;
+}
+
+JsonWriter &JsonWriter::beginObject() {
+    beginValue();
+    out << "{" << IndentCtl::indent;
+    scopes.push_back({false, false, true});
+    return *this;
+}
+
+JsonWriter &JsonWriter::endObject() {
+    if (scopes.empty() || scopes.back().isArray) throw std::logic_error("Not in an object");
+    scopes.pop_back();
+    out << IndentCtl::unindent;
+    newline();
+    out << "}";
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray(bool small) {
+    beginValue();
+    out << "[";
+    if (!small) out << IndentCtl::indent;
+    scopes.push_back({true, small, true});
+    return *this;
+}
+
+JsonWriter &JsonWriter::endArray() {
+    if (scopes.empty() || !scopes.back().isArray) throw std::logic_error("Not in an array");
+    auto scope = scopes.back();
+    scopes.pop_back();
+    if (!scope.isSmall) {
+        out << IndentCtl::unindent;
+        // An empty array is small
+        if (!scope.empty) newline();
+    }
+    out << "]";
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(cstring label) {
+    if (scopes.empty() || scopes.back().isArray) throw std::logic_error("Not in an object");
+    auto &scope = scopes.back();
+    if (!scope.empty) out << ",";
+    scope.empty = false;
+    newline();
+    out << "\"" << label << "\""
+        << " : ";
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const JsonValue &value) {
+    beginValue();
+    value.serialize(out);
+    return *this;
+}
+
+JsonWriter &JsonWriter::json(const IJson *json) {
+    if (json == nullptr) return value(JsonValue());
+    if (auto value = json->to<JsonValue>()) return this->value(*value);
+    if (auto obj = json->to<JsonObject>()) {
+        beginObject();
+        for (auto &it : *obj) {
+            key(it.first);
+            this->json(it.second);
+        }
+        return endObject();
+    }
+    if (auto arr = json->to<JsonArray>()) {
+        bool isSmall = true;
+        for (auto v : *arr) {
+            if (v == nullptr || !v->is<JsonValue>()) isSmall = false;
+        }
+        beginArray(isSmall);
+        for (auto v : *arr) this->json(v);
+        return endArray();
+    }
+    beginValue();
+    json->serialize(out);
+    return *this;
+}
+
+void JsonStream::serialize(std::ostream &out) const {
+    JsonWriter writer(out);
+    write(writer);
+}
+
 }  // namespace Util
@@ -17,15 +17,18 @@ limitations under the License.
 #ifndef _LIB_JSON_H_
 #define _LIB_JSON_H_
 
+#include <functional>
 #include <iostream>
 #include <stdexcept>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "gtest/gtest_prod.h"
 #include "lib/big_int_util.h"
 #include "lib/castable.h"
 #include "lib/cstring.h"
+#include "lib/flat_ordered_map.h"
 #include "lib/ordered_map.h"
 
 namespace Test {
@@ -147,7 +150,7 @@ class JsonArray final : public IJson, public std::vector<IJson *> {
     JsonArray(std::vector<IJson *> &data) : std::vector<IJson *>(data) {}  // NOLINT
 };
 
-class JsonObject final : public IJson, public ordered_map<cstring, IJson *> {
+class JsonObject final : public IJson, public flat_ordered_map<cstring, IJson *> {
     friend class Test::TestJson;
 
  public:
@@ -183,6 +186,48 @@ class JsonObject final : public IJson, public ordered_map<cstring, IJson *> {
     IJson *get(cstring label) const { return ::get(*this, label); }
 };
 
+/// Writes JSON to a stream as it is produced, with the same layout as IJson::serialize.
+/// Documents too large to be built as a tree of JsonObject and JsonArray, like the const
+/// entries of large tables, can be written one element at a time. Object members are written
+/// by calling key() and then writing the value.
+class JsonWriter {
+    struct Scope {
+        bool isArray;
+        // The elements of a small array are values, written on one line
+        bool isSmall;
+        bool empty;
+    };
+
+    std::ostream &out;
+    std::vector<Scope> scopes;
+
+    void newline();
+    void beginValue();
+
+ public:
+    explicit JsonWriter(std::ostream &out) : out(out) {}
+
+    JsonWriter &beginObject();
+    JsonWriter &endObject();
+    /// Like JsonArray::serialize, an array is small if all its elements are JsonValue.
+    JsonWriter &beginArray(bool small = false);
+    JsonWriter &endArray();
+    JsonWriter &key(cstring label);
+    JsonWriter &value(const JsonValue &value);
+    /// Writes a tree, or null if @a json is nullptr.
+    JsonWriter &json(const IJson *json);
+};
+
+/// A JSON value which is written by a function each time it is serialized instead of being
+/// stored as a tree. The function must write exactly one value.
+class JsonStream final : public IJson {
+    std::function<void(JsonWriter &)> write;
+
+ public:
+    explicit JsonStream(std::function<void(JsonWriter &)> write) : write(std::move(write)) {}
+    void serialize(std::ostream &out) const;
+};
+
 }  // namespace Util
 
 #endif /* _LIB_JSON_H_ */
@@ -0,0 +1,147 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _LIB_PERSISTENT_LIST_H_
+#define _LIB_PERSISTENT_LIST_H_
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/// Append-only sequence whose copies share their elements.  Copying a list is O(1), and
+/// push_back adds one node that only this list sees: lists copied from a common ancestor share
+/// the ancestor's elements and each store only what was appended to them since.  Meant for
+/// histories that grow along every path of a search, like path constraints and traces.
+///
+/// Each list points to its last element, so there is no random access; rbegin() iterates
+/// from the last element to the first without copying, and to_vector() collects the elements
+/// in order in O(n).
+template <class T>
+class persistent_list {
+    struct node_t {
+        T value;
+        // only changed by release(), once no list shares the node any more
+        mutable std::shared_ptr<const node_t> prev;
+        node_t(T value, std::shared_ptr<const node_t> prev)
+            : value(std::move(value)), prev(std::move(prev)) {}
+    };
+    std::shared_ptr<const node_t> last;
+    size_t length = 0;
+
+    /// Frees the nodes no other list shares one at a time; letting the shared_ptrs do it
+    /// would take one stack frame per node.
+    void release() {
+        while (last && last.use_count() == 1) last = std::move(last->prev);
+        last.reset();
+        length = 0;
+    }
+
+ public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    /// Iterates over the elements from the last appended to the first.
+    class const_reverse_iterator {
+        friend class persistent_list;
+        const node_t *node;
+        explicit const_reverse_iterator(const node_t *node) : node(node) {}
+
+     public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
+        const T &operator*() const { return node->value; }
+        const T *operator->() const { return &node->value; }
+        const_reverse_iterator &operator++() {
+            node = node->prev.get();
+            return *this;
+        }
+        const_reverse_iterator operator++(int) {
+            auto rv = *this;
+            ++*this;
+            return rv;
+        }
+        bool operator==(const const_reverse_iterator &a) const { return node == a.node; }
+        bool operator!=(const const_reverse_iterator &a) const { return node != a.node; }
+    };
+
+    persistent_list() = default;
+    persistent_list(const persistent_list &) = default;
+    persistent_list(persistent_list &&a) : last(std::move(a.last)), length(a.length) {
+        a.length = 0;
+    }
+    persistent_list &operator=(const persistent_list &a) {
+        if (this != &a) {
+            auto keep = a.last;  // a may share nodes with this list, or be part of one
+            release();
+            last = std::move(keep);
+            length = a.length;
+        }
+        return *this;
+    }
+    persistent_list &operator=(persistent_list &&a) {
+        if (this != &a) {
+            release();
+            last = std::move(a.last);
+            length = a.length;
+            a.length = 0;
+        }
+        return *this;
+    }
+    ~persistent_list() { release(); }
+
+    bool empty() const { return length == 0; }
+    size_t size() const { return length; }
+    const T &back() const { return last->value; }
+
+    void push_back(T value) {
+        last = std::make_shared<const node_t>(std::move(value), std::move(last));
+        ++length;
+    }
+    template <class... Args>
+    void emplace_back(Args &&...args) {
+        push_back(T(std::forward<Args>(args)...));
+    }
+    void clear() { release(); }
+
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(last.get()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(nullptr); }
+
+    /// @returns the elements in the order they were appended.
+    std::vector<T> to_vector() const {
+        std::vector<const T *> elements(length);
+        auto it = elements.rbegin();
+        for (const node_t *n = last.get(); n; n = n->prev.get()) *it++ = &n->value;
+        std::vector<T> rv;
+        rv.reserve(length);
+        for (const T *e : elements) rv.push_back(*e);
+        return rv;
+    }
+
+    bool operator==(const persistent_list &a) const {
+        if (length != a.length) return false;
+        for (const node_t *n = last.get(), *m = a.last.get(); n != m; n = n->prev.get(),
+                          m = m->prev.get())
+            if (!(n->value == m->value)) return false;
+        return true;
+    }
+    bool operator!=(const persistent_list &a) const { return !(*this == a); }
+};
+
+#endif /* _LIB_PERSISTENT_LIST_H_ */
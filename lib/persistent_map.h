@@ -0,0 +1,334 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#ifndef _LIB_PERSISTENT_MAP_H_
+#define _LIB_PERSISTENT_MAP_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// Ordered map whose copies share structure.  Copying a map is O(1); an insertion or erasure
+/// copies the O(log n) nodes on the path to the key and shares all others with the maps it was
+/// copied from, which never see the change.  Meant for state that is copied often and changed
+/// a little after each copy, like the states of a symbolic executor.
+///
+/// - The map is an AVL tree of immutable, reference-counted nodes.  Iteration is in key order,
+///   like std::map.
+/// - There is no operator[] and no mutable access to values, since a node may be shared; use
+///   insert_or_assign.
+/// - Insertions and erasures invalidate iterators of this map, but not of its copies.
+template <class K, class V, class COMP = std::less<K>>
+class persistent_map {
+ public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<const K, V> value_type;
+    typedef COMP key_compare;
+    typedef const value_type &const_reference;
+    typedef size_t size_type;
+
+ private:
+    struct node_t;
+    typedef std::shared_ptr<const node_t> node_ptr;
+    struct node_t {
+        value_type value;
+        node_ptr left, right;
+        int height;
+        node_t(const value_type &value, node_ptr left, node_ptr right)
+            : value(value),
+              left(std::move(left)),
+              right(std::move(right)),
+              height(1 + std::max(height_of(this->left), height_of(this->right))) {}
+    };
+
+    node_ptr root;
+    size_t entries = 0;
+    COMP comp;
+
+    static int height_of(const node_ptr &n) { return n ? n->height : 0; }
+
+    static node_ptr make(const value_type &v, node_ptr l, node_ptr r) {
+        return std::make_shared<const node_t>(v, std::move(l), std::move(r));
+    }
+
+    /// Makes a node from @p v, @p l and @p r, whose heights differ by at most 2, rotating
+    /// so that the heights of the children of the result differ by at most 1.
+    static node_ptr balance(const value_type &v, const node_ptr &l, const node_ptr &r) {
+        int hl = height_of(l), hr = height_of(r);
+        if (hl > hr + 1) {
+            if (height_of(l->left) >= height_of(l->right))
+                return make(l->value, l->left, make(v, l->right, r));
+            return make(l->right->value, make(l->value, l->left, l->right->left),
+                        make(v, l->right->right, r));
+        }
+        if (hr > hl + 1) {
+            if (height_of(r->right) >= height_of(r->left))
+                return make(r->value, make(v, l, r->left), r->right);
+            return make(r->left->value, make(v, l, r->left->left),
+                        make(r->value, r->left->right, r->right));
+        }
+        return make(v, l, r);
+    }
+
+    node_ptr insert(const node_ptr &n, const value_type &v, bool &added) const {
+        if (!n) {
+            added = true;
+            return make(v, nullptr, nullptr);
+        }
+        if (comp(v.first, n->value.first))
+            return balance(n->value, insert(n->left, v, added), n->right);
+        if (comp(n->value.first, v.first))
+            return balance(n->value, n->left, insert(n->right, v, added));
+        return make(v, n->left, n->right);
+    }
+
+    static node_ptr erase_min(const node_ptr &n) {
+        if (!n->left) return n->right;
+        return balance(n->value, erase_min(n->left), n->right);
+    }
+
+    node_ptr erase(const node_ptr &n, const K &k, bool &removed) const {
+        if (!n) return n;
+        if (comp(k, n->value.first)) {
+            auto l = erase(n->left, k, removed);
+            return removed ? balance(n->value, l, n->right) : n;
+        }
+        if (comp(n->value.first, k)) {
+            auto r = erase(n->right, k, removed);
+            return removed ? balance(n->value, n->left, r) : n;
+        }
+        removed = true;
+        if (!n->left) return n->right;
+        if (!n->right) return n->left;
+        const node_t *min = n->right.get();
+        while (min->left) min = min->left.get();
+        return balance(min->value, n->left, erase_min(n->right));
+    }
+
+ public:
+    /// Iterates in key order.  Holds the path from the root, so it is as large as the tree
+    /// is high.
+    class const_iterator {
+        friend class persistent_map;
+        // The nodes whose values are yet to be visited and whose right subtrees are not;
+        // the current node is at the back.
+        std::vector<const node_t *> path;
+
+        void push_leftmost(const node_t *n) {
+            for (; n; n = n->left.get()) path.push_back(n);
+        }
+
+     public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef typename persistent_map::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type *pointer;
+        typedef const value_type &reference;
+
+        const_iterator() = default;
+        reference operator*() const { return path.back()->value; }
+        pointer operator->() const { return &path.back()->value; }
+        const_iterator &operator++() {
+            const node_t *n = path.back();
+            path.pop_back();
+            push_leftmost(n->right.get());
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto rv = *this;
+            ++*this;
+            return rv;
+        }
+        bool operator==(const const_iterator &a) const {
+            return path.empty() ? a.path.empty() : !a.path.empty() && path.back() == a.path.back();
+        }
+        bool operator!=(const const_iterator &a) const { return !(*this == a); }
+    };
+    typedef const_iterator iterator;
+
+    persistent_map() = default;
+    explicit persistent_map(const COMP &comp) : comp(comp) {}
+    persistent_map(std::initializer_list<value_type> il, const COMP &comp = COMP())
+        : comp(comp) {
+        for (auto &v : il) insert_or_assign(v.first, v.second);
+    }
+    template <class InputIt>
+    persistent_map(InputIt first, InputIt last, const COMP &comp = COMP()) : comp(comp) {
+        for (; first != last; ++first) insert(first->first, first->second);
+    }
+
+    const_iterator begin() const {
+        const_iterator rv;
+        rv.push_leftmost(root.get());
+        return rv;
+    }
+    const_iterator end() const { return const_iterator(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return entries == 0; }
+    size_t size() const { return entries; }
+    key_compare key_comp() const { return comp; }
+
+    const_iterator find(const K &k) const {
+        const_iterator rv;
+        for (const node_t *n = root.get(); n;) {
+            if (comp(k, n->value.first)) {
+                rv.path.push_back(n);
+                n = n->left.get();
+            } else if (comp(n->value.first, k)) {
+                n = n->right.get();
+            } else {
+                rv.path.push_back(n);
+                return rv;
+            }
+        }
+        return end();
+    }
+    size_t count(const K &k) const { return find(k) != end(); }
+    const V &at(const K &k) const {
+        for (const node_t *n = root.get(); n;) {
+            if (comp(k, n->value.first))
+                n = n->left.get();
+            else if (comp(n->value.first, k))
+                n = n->right.get();
+            else
+                return n->value.second;
+        }
+        throw std::out_of_range("persistent_map::at");
+    }
+
+    /// Inserts @p v under @p k, unless @p k is already present.
+    std::pair<const_iterator, bool> insert(const K &k, const V &v) {
+        auto it = find(k);
+        if (it != end()) return {it, false};
+        insert_or_assign(k, v);
+        return {find(k), true};
+    }
+    std::pair<const_iterator, bool> insert(const value_type &v) {
+        return insert(v.first, v.second);
+    }
+    /// Sets the value of @p k to @p v.
+    void insert_or_assign(const K &k, const V &v) {
+        bool added = false;
+        root = insert(root, value_type(k, v), added);
+        entries += added;
+    }
+    size_t erase(const K &k) {
+        bool removed = false;
+        root = erase(root, k, removed);
+        entries -= removed;
+        return removed;
+    }
+    void clear() {
+        root.reset();
+        entries = 0;
+    }
+    void swap(persistent_map &a) {
+        std::swap(root, a.root);
+        std::swap(entries, a.entries);
+        std::swap(comp, a.comp);
+    }
+
+    /// @returns true if this map and @p a are copies of each other that have not been changed
+    /// since, which is a sufficient but not a necessary condition for being equal.
+    bool shares_root_with(const persistent_map &a) const { return root == a.root; }
+
+    bool operator==(const persistent_map &a) const {
+        return root == a.root || (entries == a.entries && std::equal(begin(), end(), a.begin()));
+    }
+    bool operator!=(const persistent_map &a) const { return !(*this == a); }
+};
+
+/// Ordered set whose copies share structure; see persistent_map.
+template <class K, class COMP = std::less<K>>
+class persistent_set {
+    struct empty_t {
+        bool operator==(const empty_t &) const { return true; }
+    };
+    typedef persistent_map<K, empty_t, COMP> map_t;
+    map_t data;
+
+ public:
+    typedef K key_type;
+    typedef K value_type;
+    typedef COMP key_compare;
+    typedef size_t size_type;
+
+    class const_iterator {
+        friend class persistent_set;
+        typename map_t::const_iterator it;
+        explicit const_iterator(typename map_t::const_iterator it) : it(std::move(it)) {}
+
+     public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef K value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const K *pointer;
+        typedef const K &reference;
+
+        const_iterator() = default;
+        reference operator*() const { return it->first; }
+        pointer operator->() const { return &it->first; }
+        const_iterator &operator++() {
+            ++it;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            auto rv = *this;
+            ++it;
+            return rv;
+        }
+        bool operator==(const const_iterator &a) const { return it == a.it; }
+        bool operator!=(const const_iterator &a) const { return it != a.it; }
+    };
+    typedef const_iterator iterator;
+
+    persistent_set() = default;
+    explicit persistent_set(const COMP &comp) : data(comp) {}
+    persistent_set(std::initializer_list<K> il, const COMP &comp = COMP()) : data(comp) {
+        for (auto &k : il) insert(k);
+    }
+
+    const_iterator begin() const { return const_iterator(data.begin()); }
+    const_iterator end() const { return const_iterator(data.end()); }
+
+    bool empty() const { return data.empty(); }
+    size_t size() const { return data.size(); }
+    const_iterator find(const K &k) const { return const_iterator(data.find(k)); }
+    size_t count(const K &k) const { return data.count(k); }
+
+    std::pair<const_iterator, bool> insert(const K &k) {
+        auto rv = data.insert(k, empty_t());
+        return {const_iterator(rv.first), rv.second};
+    }
+    template <class... Args>
+    std::pair<const_iterator, bool> emplace(Args &&...args) {
+        return insert(K(std::forward<Args>(args)...));
+    }
+    size_t erase(const K &k) { return data.erase(k); }
+    void clear() { data.clear(); }
+
+    bool operator==(const persistent_set &a) const { return data == a.data; }
+    bool operator!=(const persistent_set &a) const { return data != a.data; }
+};
+
+#endif /* _LIB_PERSISTENT_MAP_H_ */
@@ -189,6 +189,9 @@ class SourceInfo final {
 
     const SourcePosition &getEnd() const { return this->end; }
 
+    /// The input this position refers to, or null for positions without one.
+    const InputSources *getSources() const { return this->sources; }
+
     /**
        True if this comes 'before' this source position.
        'invalid' source positions come first.
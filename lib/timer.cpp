@@ -3,8 +3,11 @@
 #include <algorithm>
 #include <chrono>  // NOLINT linter forbids using chrono, but we don't have alternatives
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace Util {
 
@@ -20,6 +23,7 @@ struct CounterEntry {
     const char *name;
     std::unordered_map<std::string, std::unique_ptr<CounterEntry>> counters;
     Clock::duration duration{};
+    size_t invocations = 0;
 
     /// Lookup existing or create new child counter.
     CounterEntry *openSubcounter(const char *name) {
@@ -30,37 +34,71 @@ struct CounterEntry {
         return it->second.get();
     }
 
-    /// Adds specified duration to the current counter.
-    void add(Clock::duration d) { duration += d; }
+    /// Adds specified duration of one invocation to the current counter.
+    void add(Clock::duration d) {
+        duration += d;
+        invocations++;
+    }
+
+    /// Adds the subcounters of @p other to those of this counter.
+    void merge(const CounterEntry &other) {
+        for (const auto &sub : other.counters) {
+            auto *mine = openSubcounter(sub.second->name);
+            mine->duration += sub.second->duration;
+            mine->invocations += sub.second->invocations;
+            mine->merge(*sub.second);
+        }
+    }
 
     explicit CounterEntry(const char *n) : name(n) {}
 };
 
-struct RootCounter {
+/// The counters of one thread.
+struct ThreadCounters {
     /// The topmost counter.
-    CounterEntry counter;
+    CounterEntry counter{""};
     /// The most inner currently active counter.
-    CounterEntry *current;
+    CounterEntry *current = &counter;
+};
+
+struct RootCounter {
+    /// The counters of the thread that first used a timer.
+    ThreadCounters main;
     Clock::time_point start;
+    std::thread::id owner;
 
-    static RootCounter &get() {
-        // TODO: not threadsafe currently. Instance of RootCounter could be thread_local:
-        //
-        // thread_local RootCounter root;
-        //
-        // however libgc cannot scan thread local data, which can lead to premature object
-        // garbage collection.
+    /// The counters of the other threads, which are kept after the threads exit.  Each thread
+    /// only updates its own counters; the lock guards the list.
+    std::mutex lock;
+    std::vector<std::unique_ptr<ThreadCounters>> others;
+
+    static RootCounter &instance() {
         static RootCounter ROOT;
-        ROOT.counter.duration = Clock::now() - ROOT.start;
         return ROOT;
     }
 
-    CounterEntry *getCurrent() const { return current; }
+    static RootCounter &get() {
+        auto &root = instance();
+        root.main.counter.duration = Clock::now() - root.start;
+        return root;
+    }
 
-    void setCurrent(CounterEntry *c) { current = c; }
+    /// The counters of the calling thread.
+    ThreadCounters &forThisThread() {
+        if (std::this_thread::get_id() == owner) return main;
+        // libgc cannot scan thread local data, so the counters themselves are owned by
+        // 'others', which it can scan, and only a pointer to them is thread local.
+        thread_local ThreadCounters *local = nullptr;
+        if (!local) {
+            std::lock_guard<std::mutex> guard(lock);
+            others.emplace_back(new ThreadCounters);
+            local = others.back().get();
+        }
+        return *local;
+    }
 
  private:
-    RootCounter() : counter(""), current(&counter) { start = Clock::now(); }
+    RootCounter() : owner(std::this_thread::get_id()) { start = Clock::now(); }
 };
 
 }  // namespace
@@ -77,23 +115,26 @@ struct RootCounter {
 #endif
 // RAII helper which manages lifetime of one timer invocation.
 struct ScopedTimerCtx {
+    ThreadCounters &counters;
     CounterEntry *parent = nullptr;
     CounterEntry *self = nullptr;
     Clock::time_point startTime;
 
     explicit ScopedTimerCtx(const char *timerName)
-        : parent(RootCounter::get().getCurrent()), self(parent->openSubcounter(timerName)) {
+        : counters(RootCounter::instance().forThisThread()),
+          parent(counters.current),
+          self(parent->openSubcounter(timerName)) {
         startTime = Clock::now();
         // Push new active counter - the current active counter becomes the parent of this
         // counter, and this counter becomes the current active counter.
-        RootCounter::get().setCurrent(self);
+        counters.current = self;
     }
     ~ScopedTimerCtx() {
         // Close the current timer invocation, measure time and add it to the counter.
         auto duration = Clock::now() - startTime;
         self->add(duration);
         // Restore previous counter as current.
-        RootCounter::get().setCurrent(parent);
+        counters.current = parent;
     }
 };
 #pragma GCC diagnostic pop
@@ -121,6 +162,7 @@ static void formatCounters(std::vector<TimerEntry> &out, CounterEntry &current,
     TimerEntry entry;
     entry.timerName = namePrefix;
     entry.milliseconds = currentTotalDuration.count();
+    entry.invocations = current.invocations;
     if (parentDurationMs == 0) {
         entry.relativeToParent = 1;
     } else {
@@ -136,7 +178,18 @@ static void formatCounters(std::vector<TimerEntry> &out, CounterEntry &current,
 std::vector<TimerEntry> getTimers() {
     std::vector<TimerEntry> ret;
     std::string namePrefix;
-    formatCounters(ret, RootCounter::get().counter, namePrefix, 0);
+    auto &root = RootCounter::get();
+    std::lock_guard<std::mutex> guard(root.lock);
+    if (root.others.empty()) {
+        formatCounters(ret, root.main.counter, namePrefix, 0);
+        return ret;
+    }
+    // The timers of all threads are summed up by name; the root keeps the wall time.
+    CounterEntry total("");
+    total.duration = root.main.counter.duration;
+    total.merge(root.main.counter);
+    for (const auto &thread : root.others) total.merge(thread->counter);
+    formatCounters(ret, total, namePrefix, 0);
     return ret;
 }
 
@@ -29,11 +29,15 @@ struct TimerEntry {
     std::string timerName;
     /// Total duration in milliseconds.
     size_t milliseconds;
+    /// Number of times the timer was run; zero for the root timer.
+    size_t invocations;
     /// Portion of this timer's name relative to the parent timer.
     float relativeToParent;
 };
 
-/// Returns list of all timers for and their current values.
+/// Returns list of all timers for and their current values.  Timers run on different threads
+/// are added up by name, so a timer may account for more time than its parent; the result is
+/// only consistent once the other threads have stopped using timers.
 std::vector<TimerEntry> getTimers();
 
 // Internal implementation.
@@ -189,6 +189,7 @@ void DoLocalCopyPropagation::flow_copy(ControlFlowVisitor &a_) {
     auto &a = dynamic_cast<DoLocalCopyPropagation &>(a_);
     BUG_CHECK(working == a.working, "inconsistent DoLocalCopyPropagation state on copy");
     available = a.available;
+    valueUses = a.valueUses;
     need_key_rewrite = a.need_key_rewrite;
     BUG_CHECK(inferForTable == a.inferForTable,
               "inconsistent DoLocalCopyPropagation state on copy");
@@ -210,28 +211,65 @@ void DoLocalCopyPropagation::forOverlapAvail(cstring name,
         auto it = available.find(name.before(pfx));
         if (it != available.end()) fn(it->first, &it->second);
     }
+    // Keys that extend name are contiguous, but interleaved with siblings such as name2
+    // ('2' sorts before '[').
     for (auto it = available.upper_bound(name); it != available.end(); ++it) {
-        if (!it->first.startsWith(name) || !strchr(".[", it->first.get(name.size()))) break;
-        fn(it->first, &it->second);
+        if (!it->first.startsWith(name)) break;
+        if (strchr(".[", it->first.get(name.size()))) fn(it->first, &it->second);
     }
 }
 
 void DoLocalCopyPropagation::dropValuesUsing(cstring name) {
     LOG6("dropValuesUsing(" << name << ")");
-    for (auto &var : available) {
-        LOG7("  checking " << var.first << " = " << var.second.val);
-        if (name_overlap(var.first, name)) {
-            LOG4("   dropping " << (var.second.val ? "" : "(nop) ") << "as " << name
-                                << " is being assigned to");
-            var.second.val = nullptr;
-        } else if (var.second.val && exprUses(var.second.val, name)) {
-            LOG4("   dropping " << (var.second.val ? "" : "(nop) ") << var.first << " as it uses "
-                                << name);
-            var.second.val = nullptr;
+    forOverlapAvail(name, [name](cstring, VarInfo *var) {
+        LOG4("   dropping " << (var->val ? "" : "(nop) ") << "as " << name
+                            << " is being assigned to");
+        var->val = nullptr;
+    });
+    // exprUses matches a path whose name is the whole of name or a prefix of it ending
+    // at a field or index, so only the values indexed under those need to be checked.
+    for (const char *pfx = name.c_str(); *pfx; pfx += strspn(pfx, ".[")) {
+        pfx += strcspn(pfx, ".[");
+        auto uses = valueUses.find(name.before(pfx));
+        if (uses == valueUses.end()) continue;
+        for (auto it = uses->second.begin(); it != uses->second.end();) {
+            auto var = ::getref(available, *it);
+            if (!var || !var->val) {
+                it = uses->second.erase(it);
+                continue;
+            }
+            LOG7("  checking " << *it << " = " << var->val);
+            if (exprUses(var->val, name)) {
+                LOG4("   dropping " << *it << " as it uses " << name);
+                var->val = nullptr;
+                it = uses->second.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
 }
 
+/// Record @p val as the value of available entry @p name, and index it under the
+/// variables it reads.
+void DoLocalCopyPropagation::saveValue(cstring name, VarInfo &var, const IR::Expression *val) {
+    struct FindUses : public Inspector {
+        DoLocalCopyPropagation &self;
+        cstring name;
+        bool preorder(const IR::Path *p) override {
+            self.valueUses[p->name].insert(name);
+            return false;
+        }
+        bool preorder(const IR::Primitive *p) override {
+            self.valueUses[p->name].insert(name);
+            return true;
+        }
+        FindUses(DoLocalCopyPropagation &self, cstring name) : self(self), name(name) {}
+    };
+    var.val = val;
+    val->apply(FindUses(*this, name));
+}
+
 void DoLocalCopyPropagation::visit_local_decl(const IR::Declaration_Variable *var) {
     LOG4("Visiting " << var);
     if (available.count(var->name)) BUG("duplicate var declaration for %s", var->name);
@@ -240,7 +278,7 @@ void DoLocalCopyPropagation::visit_local_decl(const IR::Declaration_Variable *va
     if (var->initializer) {
         if (!hasSideEffects(var->initializer)) {
             LOG3("  saving init value for " << var->name << ": " << var->initializer);
-            local.val = var->initializer;
+            saveValue(var->name, local, var->initializer);
         } else {
             local.live = true;
         }
@@ -381,7 +419,7 @@ IR::AssignmentStatement *DoLocalCopyPropagation::postorder(IR::AssignmentStateme
                 return as;
             }
             LOG3("  saving value for " << dest << ": " << as->right);
-            available[dest].val = as->right;
+            saveValue(dest, available[dest], as->right);
         } else {
             LOG3("Can't copyprop " << as->right << " due to side effects");
         }
@@ -534,7 +572,7 @@ IR::P4Action *DoLocalCopyPropagation::postorder(IR::P4Action *act) {
     BUG_CHECK(inferForFunc == &actions[act->name], "corrupt internal data struct");
     act->body = act->body->apply(ElimDead(*this))->to<IR::BlockStatement>();
     working = false;
-    available.clear();
+    clearAvailable();
     LOG3("DoLocalCopyPropagation finished action " << act->name);
     LOG4("reads=" << inferForFunc->reads << " writes=" << inferForFunc->writes);
     LOG4(act);
@@ -570,7 +608,7 @@ IR::Function *DoLocalCopyPropagation::postorder(IR::Function *fn) {
     BUG_CHECK(inferForFunc == &methods[name], "corrupt internal data struct");
     fn->body = fn->body->apply(ElimDead(*this))->to<IR::BlockStatement>();
     working = false;
-    available.clear();
+    clearAvailable();
     LOG3("DoLocalCopyPropagation finished function " << name);
     LOG4("reads=" << inferForFunc->reads << " writes=" << inferForFunc->writes);
     LOG4(fn);
@@ -615,7 +653,7 @@ IR::P4Control *DoLocalCopyPropagation::preorder(IR::P4Control *ctrl) {
     ctrl->controlLocals = *ctrl->controlLocals.apply(ElimDead(*this));
     ctrl->body = ctrl->body->apply(ElimDead(*this))->to<IR::BlockStatement>();
     working = false;
-    available.clear();
+    clearAvailable();
     LOG3("DoLocalCopyPropagation finished control " << ctrl->name);
     LOG4(ctrl);
     prune();
@@ -701,7 +739,7 @@ const IR::P4Parser *DoLocalCopyPropagation::postorder(IR::P4Parser *parser) {
     for (auto *state : parser->states) apply_function(&states[state->name]);
     auto *rv = parser->apply(ElimDead(*this));
     working = false;
-    available.clear();
+    clearAvailable();
     return rv;
 }
 
@@ -722,7 +760,7 @@ IR::ParserState *DoLocalCopyPropagation::postorder(IR::ParserState *state) {
     state->components = *state->components.apply(ElimDead(*this));
     working = false;
     inferForFunc = nullptr;
-    available.clear();
+    clearAvailable();
     LOG3("DoLocalCopyPropagation finished parser state " << state->name);
     LOG4(state);
     return state;
@@ -732,7 +770,7 @@ IR::ParserState *DoLocalCopyPropagation::postorder(IR::ParserState *state) {
 // needed for this pass to function correctly when used in a PassRepeated
 Visitor::profile_t DoLocalCopyPropagation::init_apply(const IR::Node *node) {
     // clear maps
-    available.clear();
+    clearAvailable();
     tables.clear();
     actions.clear();
     methods.clear();
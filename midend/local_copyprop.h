@@ -74,6 +74,10 @@ class DoLocalCopyPropagation : public ControlFlowVisitor, Transform, P4WriteCont
         bool is_first_write_insert = false;
     };
     std::map<cstring, VarInfo> available;
+    /// For each variable read by a value in available, the names of the entries that
+    /// (may) hold such a value, so assignments need not check every available value.
+    /// Entries are added when a value is saved and removed lazily once the value is gone.
+    std::map<cstring, std::set<cstring>> valueUses;
     std::map<cstring, TableInfo> &tables;
     std::map<cstring, FuncInfo> &actions;
     std::map<cstring, FuncInfo> &methods;
@@ -90,6 +94,11 @@ class DoLocalCopyPropagation : public ControlFlowVisitor, Transform, P4WriteCont
     bool name_overlap(cstring, cstring);
     void forOverlapAvail(cstring, std::function<void(cstring, VarInfo *)>);
     void dropValuesUsing(cstring);
+    void saveValue(cstring, VarInfo &, const IR::Expression *);
+    void clearAvailable() {
+        available.clear();
+        valueUses.clear();
+    }
     bool hasSideEffects(const IR::Expression *e) {
         return bool(::hasSideEffects(refMap, typeMap, e));
     }
@@ -0,0 +1,114 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/arena.h"
+
+#include <cstdint>
+#include <set>
+
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+TEST(arena, allocate_release) {
+    Util::Arena arena(4096);
+    std::set<void *> seen;
+    for (int i = 0; i < 1000; ++i) {
+        auto *p = arena.allocate(24, 8);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 8, 0u);
+        EXPECT_TRUE(arena.owns(p));
+        EXPECT_TRUE(seen.insert(p).second);
+    }
+    auto &stats = arena.getStats();
+    EXPECT_EQ(stats.allocations, 1000u);
+    EXPECT_EQ(stats.bytesAllocated, 24000u);
+    EXPECT_GT(stats.chunks, 1u);
+    EXPECT_GE(stats.bytesReserved, stats.bytesAllocated);
+
+    // a large request gets a chunk of its own and leaves the current one in use
+    auto *small = static_cast<char *>(arena.allocate(8, 8));
+    auto *big = arena.allocate(100000);
+    EXPECT_TRUE(arena.owns(big));
+    EXPECT_EQ(static_cast<char *>(arena.allocate(8, 8)), small + 8);
+
+    auto reserved = stats.bytesReserved;
+    arena.release();
+    EXPECT_FALSE(arena.owns(small));
+    EXPECT_EQ(stats.allocations, 0u);
+    EXPECT_EQ(stats.bytesReserved, 0u);
+    EXPECT_EQ(stats.peakBytesReserved, reserved);
+    EXPECT_EQ(stats.releases, 1u);
+}
+
+TEST(arena, scopes_nest) {
+    Util::Arena outer, inner;
+    EXPECT_EQ(Util::Arena::current(), nullptr);
+    {
+        Util::ArenaScope s1(outer);
+        EXPECT_EQ(Util::Arena::current(), &outer);
+        {
+            Util::ArenaScope s2(inner);
+            EXPECT_EQ(Util::Arena::current(), &inner);
+        }
+        {
+            Util::NoArenaScope s3;
+            EXPECT_EQ(Util::Arena::current(), nullptr);
+        }
+        EXPECT_EQ(Util::Arena::current(), &outer);
+    }
+    EXPECT_EQ(Util::Arena::current(), nullptr);
+}
+
+#if HAVE_IR_ARENA
+TEST(arena, ir_nodes) {
+    Util::Arena arena;
+    const IR::Node *inArena, *outside;
+    {
+        Util::ArenaScope scope(arena);
+        inArena = new IR::Constant(42);
+    }
+    outside = new IR::Constant(42);
+    EXPECT_TRUE(arena.owns(inArena));
+    EXPECT_FALSE(arena.owns(outside));
+    EXPECT_EQ(inArena->to<IR::Constant>()->asInt(), 42);
+    EXPECT_EQ(arena.getStats().allocations, 1u);
+}
+
+TEST(arena, delete_ir_nodes) {
+    Util::Arena arena, other;
+    IR::Node *inArena, *outside = new IR::Constant(1);
+    {
+        Util::ArenaScope scope(arena);
+        inArena = new IR::Constant(2);
+    }
+    // neither delete may depend on the arena current at the time
+    delete inArena;
+    Util::ArenaScope scope(other);
+    delete outside;
+    EXPECT_EQ(other.getStats().allocations, 0u);
+}
+
+TEST(arena, cached_types) {
+    Util::Arena arena;
+    {
+        Util::ArenaScope scope(arena);
+        EXPECT_FALSE(arena.owns(IR::Type_Bits::get(13)));
+        EXPECT_FALSE(arena.owns(IR::Type_Boolean::get()));
+    }
+    EXPECT_EQ(arena.getStats().allocations, 0u);
+}
+#endif
+
+}  // namespace Test
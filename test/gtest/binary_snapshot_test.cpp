@@ -0,0 +1,149 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/binary_generator.h"
+#include "ir/binary_loader.h"
+#include "ir/ir.h"
+#include "ir/json_generator.h"
+#include "lib/error.h"
+
+namespace Test {
+
+namespace {
+
+std::string toJSON(const IR::Node *node) {
+    std::stringstream ss;
+    JSONGenerator(ss) << node << std::endl;
+    return ss.str();
+}
+
+std::string snapshot(const IR::Node *node) {
+    std::stringstream ss;
+    BinaryGenerator().write(ss, node);
+    return ss.str();
+}
+
+}  // namespace
+
+class BinarySnapshotTest : public P4CTest {};
+
+TEST_F(BinarySnapshotTest, SharedNodes) {
+    auto *c = new IR::Constant(2);
+    auto *add = new IR::Add(c, c);
+    auto data = snapshot(add);
+
+    auto *loaded = BinarySnapshot::fromBuffer("test", data.data(), data.size());
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->nodesLoaded(), 0u);
+    auto *root = loaded->getRoot()->to<IR::Add>();
+    ASSERT_NE(root, nullptr);
+    EXPECT_EQ(root->id, add->id);
+    EXPECT_EQ(root->left, root->right);
+    EXPECT_EQ(root->left->to<IR::Constant>()->value, 2);
+    EXPECT_EQ(loaded->nodesLoaded(), loaded->nodeCount());
+    EXPECT_EQ(toJSON(root), toJSON(add));
+}
+
+TEST_F(BinarySnapshotTest, RoundTripProgram) {
+    auto test = FrontendTestCase::create(P4_SOURCE(P4Headers::CORE, R"(
+        header h_t { bit<8> f; bit<16> g; }
+        struct headers_t { h_t h; }
+        extern void log_value<T>(in T value);
+        control c(inout headers_t hdr) {
+            action set(bit<8> v) { hdr.h.f = v; }
+            table t {
+                key = { hdr.h.g : exact @name("g"); }
+                actions = { set; NoAction; }
+                default_action = NoAction();
+            }
+            apply {
+                if (hdr.h.isValid()) t.apply();
+                log_value(hdr.h.f);
+            }
+        }
+    )"));
+    ASSERT_TRUE(test);
+
+    auto data = snapshot(test->program);
+    auto *loaded = BinarySnapshot::fromBuffer("test", data.data(), data.size());
+    ASSERT_NE(loaded, nullptr);
+    auto *program = loaded->getRoot()->to<IR::P4Program>();
+    ASSERT_NE(program, nullptr);
+    EXPECT_EQ(loaded->nodesLoaded(), loaded->nodeCount());
+    EXPECT_EQ(toJSON(program), toJSON(test->program));
+    EXPECT_EQ(program->getDeclsByName("c")->count(), 1u);
+    // writing the loaded program again gives the same snapshot
+    EXPECT_EQ(snapshot(program), data);
+}
+
+TEST_F(BinarySnapshotTest, LoadsObjectsOnDemand) {
+    auto test = FrontendTestCase::create(P4_SOURCE(P4Headers::CORE, R"(
+        header h_t { bit<8> f; }
+        control c(inout h_t h) { apply { h.f = h.f + 1; } }
+        control d(inout h_t h) { apply { if (h.isValid()) h.setInvalid(); } }
+    )"));
+    ASSERT_TRUE(test);
+
+    auto data = snapshot(test->program);
+    auto *loaded = BinarySnapshot::fromBuffer("test", data.data(), data.size());
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->objectCount(), test->program->objects.size());
+    EXPECT_EQ(loaded->getObjectName(loaded->objectCount() - 1), "d");
+    EXPECT_EQ(loaded->findObject("missing"), nullptr);
+
+    auto *c = loaded->findObject("c");
+    ASSERT_NE(c, nullptr);
+    ASSERT_TRUE(c->is<IR::P4Control>());
+    EXPECT_EQ(toJSON(c), toJSON(test->program->getDeclsByName("c")->single()->getNode()));
+    // only c and the nodes it refers to (e.g., the header type) were decoded
+    auto afterC = loaded->nodesLoaded();
+    EXPECT_LT(afterC, loaded->nodeCount());
+
+    // the whole program shares the nodes loaded already
+    auto *program = loaded->getRoot()->to<IR::P4Program>();
+    ASSERT_NE(program, nullptr);
+    EXPECT_EQ(program->getDeclsByName("c")->single()->getNode(), c);
+    EXPECT_EQ(loaded->nodesLoaded(), loaded->nodeCount());
+}
+
+TEST_F(BinarySnapshotTest, ReportsCorruptData) {
+    auto data = snapshot(new IR::Add(new IR::Constant(1), new IR::Constant(2)));
+    // overwrite the node records with bytes that do not end a varint
+    for (size_t i = sizeof(BinarySnapshot::Header); i < data.size() / 2; ++i) data[i] = '\xff';
+
+    auto errors = ::errorCount();
+    auto *loaded = BinarySnapshot::fromBuffer("test", data.data(), data.size(), false);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getRoot(), nullptr);
+    EXPECT_TRUE(loaded->failed());
+    EXPECT_EQ(::errorCount(), errors);
+
+    loaded = BinarySnapshot::fromBuffer("test", data.data(), data.size());
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->getRoot(), nullptr);
+    EXPECT_EQ(::errorCount(), errors + 1);
+}
+
+TEST_F(BinarySnapshotTest, RejectsOtherFiles) {
+    std::string data = "{ \"Node_ID\" : 1 }";
+    auto errors = ::errorCount();
+    EXPECT_EQ(BinarySnapshot::fromBuffer("test", data.data(), data.size()), nullptr);
+    EXPECT_EQ(::errorCount(), errors + 1);
+}
+
+}  // namespace Test
@@ -0,0 +1,141 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "backends/bmv2/common/control.h"
+#include "backends/bmv2/common/helpers.h"
+#include "backends/bmv2/common/programStructure.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/ir.h"
+#include "lib/error.h"
+#include "lib/gc.h"
+#include "lib/json.h"
+
+namespace Test {
+
+namespace {
+
+/// Gives the test access to the writer of the const entries of a table.
+class EntriesConverter : public BMV2::ControlConverter<Standard::Arch::V1MODEL> {
+ public:
+    using ControlConverter::ControlConverter;
+    using ControlConverter::writeTableEntries;
+};
+
+/// Returns a control with a table that has @entries const entries.
+std::string tableWithEntries(int entries) {
+    std::string source = R"(
+header h_t { bit<32> f; }
+control c(inout h_t h) {
+    action a(bit<32> x) { h.f = x; }
+    table t {
+        key = { h.f : exact; }
+        actions = { a; }
+        const entries = {
+)";
+    for (int i = 0; i < entries; i++)
+        source += "            " + std::to_string(i) + " : a(1);\n";
+    source += R"(        }
+    }
+    apply { t.apply(); }
+}
+)";
+    return source;
+}
+
+/// Builds the const entries of @table as a JSON tree, the way the converter did before it
+/// wrote them to a stream.  Only handles the exact constant keys and the single action with
+/// constant arguments of the table made by tableWithEntries.
+Util::JsonArray *entriesTree(const IR::P4Table *table, unsigned actionId) {
+    auto entries = new Util::JsonArray();
+    int entryPriority = 1;
+    for (auto e : table->getEntries()->entries) {
+        auto entry = new Util::JsonObject();
+        entry->emplace_non_null("source_info", e->sourceInfoJsonObj());
+        auto matchKeys = BMV2::mkArrayField(entry, "match_key");
+        for (auto k : e->getKeys()->components) {
+            auto key = new Util::JsonObject();
+            key->emplace("match_type", "exact");
+            key->emplace("key", BMV2::stringRepr(k->to<IR::Constant>()->value, 4));
+            matchKeys->append(key);
+        }
+        auto action = new Util::JsonObject();
+        action->emplace("action_id", actionId);
+        auto actionData = BMV2::mkArrayField(action, "action_data");
+        for (auto arg : *e->getAction()->to<IR::MethodCallExpression>()->arguments)
+            actionData->append(BMV2::stringRepr(arg->expression->to<IR::Constant>()->value, 0));
+        entry->emplace("action_entry", action);
+        entry->emplace("priority", entryPriority++);
+        entries->append(entry);
+    }
+    return entries;
+}
+
+/// Runs @write and prints the time it took and the bytes it allocated from the GC heap.
+template <typename Write>
+void measure(const char *what, Write write) {
+    auto bytes = gc_bytes_allocated();
+    auto start = std::chrono::steady_clock::now();
+    write();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << what << ": " << elapsed.count() << " ms, "
+              << (gc_bytes_allocated() - bytes) / 1024 << " kB allocated" << std::endl;
+}
+
+}  // namespace
+
+class Bmv2JsonTest : public P4CTest {};
+
+TEST_F(Bmv2JsonTest, DISABLED_ConstEntriesBenchmark) {
+    // Compares writing the entries of a large table from the IR, as the BMv2 converter does,
+    // with building them as a JSON tree and serializing that, as it did before.  Both write to
+    // a stream which discards the output, so that only the memory used to produce it counts.
+    // Allocations are read from the GC heap, which is only possible when libgc is used.
+    const int entries = 1000000;
+    std::string source = tableWithEntries(entries);
+    auto test = FrontendTestCase::create(P4_SOURCE(P4Headers::CORE, source.c_str()));
+    ASSERT_TRUE(test);
+
+    P4::ReferenceMap refMap;
+    P4::TypeMap typeMap;
+    auto program = test->program->apply(P4::TypeChecking(&refMap, &typeMap));
+    ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+    auto control = program->getDeclsByName("c")->single()->to<IR::P4Control>();
+    ASSERT_TRUE(control != nullptr);
+    auto table = control->getDeclByName("t")->to<IR::P4Table>();
+    auto action = control->getDeclByName("a")->to<IR::P4Action>();
+    ASSERT_TRUE(table != nullptr && action != nullptr);
+
+    BMV2::ProgramStructure structure;
+    structure.ids.emplace(action, 0);
+    BMV2::ConversionContext ctxt(&refMap, &typeMap, nullptr, &structure, nullptr, nullptr);
+    const bool emitExterns = false;
+    EntriesConverter converter(&ctxt, "c", emitExterns);
+
+    std::ostream discard(nullptr);
+    if (gc_bytes_allocated() == 0) std::cout << "built without libgc: no allocation counts\n";
+    measure("tree", [&] { entriesTree(table, 0)->serialize(discard); });
+    measure("stream", [&] {
+        Util::JsonWriter writer(discard);
+        converter.writeTableEntries(table->getEntries(), table, writer);
+    });
+    EXPECT_EQ(::errorCount(), 0u);
+}
+
+}  // namespace Test
@@ -14,6 +14,12 @@ See the License for the specific language governing permissions and
 limitations under the License.
 */
 
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "lib/cstring.h"
 
@@ -120,4 +126,36 @@ TEST(cstring, replace) {
     EXPECT_EQ(c.replace("i", ""), "Orgnal");
 }
 
+// Interning from several threads must yield the same pointers as on the main thread.  The
+// threads only look up strings that are already interned: interning new strings allocates,
+// which libgc only allows on threads it knows about.  Also reports the lookup throughput.
+TEST(cstring, concurrent_lookup) {
+    constexpr int strings = 4096, rounds = 50;
+    std::vector<std::string> names;
+    std::vector<const char *> interned;
+    for (int i = 0; i < strings; ++i) {
+        names.push_back("concurrent_lookup_name_" + std::to_string(i));
+        interned.push_back(cstring(names.back()).c_str());
+    }
+
+    for (unsigned threads : {1u, 8u}) {
+        std::vector<std::thread> workers;
+        std::vector<int> mismatches(threads);
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (int r = 0; r < rounds; ++r)
+                    for (int i = 0; i < strings; ++i)
+                        if (cstring(names[i].c_str()).c_str() != interned[i]) ++mismatches[t];
+            });
+        }
+        for (auto &w : workers) w.join();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        for (auto m : mismatches) EXPECT_EQ(m, 0);
+        std::cout << threads << " thread(s): " << threads * rounds * strings << " lookups in "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()
+                  << "us" << std::endl;
+    }
+}
+
 }  // namespace Test
@@ -0,0 +1,89 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "frontends/p4/def_use.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+class DefUseTest : public P4CTest {};
+
+TEST_F(DefUseTest, ProgramPointsMerge) {
+    P4::ProgramPointTable table;
+    auto *s1 = new IR::EmptyStatement();
+    auto *s2 = new IR::EmptyStatement();
+    P4::ProgramPoint p1(s1), p2(s2), p3(p1, s2);
+    EXPECT_EQ(table.getId(P4::ProgramPoint::beforeStart), P4::ProgramPointTable::beforeStartId);
+    EXPECT_EQ(table.getId(p1), table.getId(P4::ProgramPoint(s1)));
+    EXPECT_NE(table.getId(p1), table.getId(p3));
+
+    auto *a = new P4::ProgramPoints(&table, p3);
+    auto *b = new P4::ProgramPoints(&table, p2);
+    auto *ab = a->merge(b);
+    EXPECT_EQ(ab->size(), 2u);
+    EXPECT_TRUE(*ab == *b->merge(a));
+    // merging a subset does not create a new set
+    EXPECT_EQ(ab->merge(a), ab);
+    EXPECT_EQ(b->merge(ab), ab);
+    EXPECT_EQ(a->merge(new P4::ProgramPoints()), a);
+    EXPECT_FALSE(ab->containsBeforeStart());
+    EXPECT_TRUE(ab->merge(new P4::ProgramPoints(&table, P4::ProgramPoint::beforeStart))
+                    ->containsBeforeStart());
+
+    std::vector<P4::ProgramPoint> points(ab->begin(), ab->end());
+    ASSERT_EQ(points.size(), 2u);
+    EXPECT_TRUE(points[0] == p2 || points[1] == p2);
+    EXPECT_TRUE(points[0] == p3 || points[1] == p3);
+}
+
+TEST_F(DefUseTest, UninitializedOnOnePath) {
+    auto test = FrontendTestCase::create(P4_SOURCE(P4Headers::CORE, R"(
+        control c(inout bit<8> v) {
+            apply {
+                bit<8> x;
+                if (v == 1) x = 2;
+                v = x;
+            }
+        }
+        control proto(inout bit<8> v);
+        package top(proto p);
+        top(c()) main;
+    )"));
+    ASSERT_TRUE(test);
+    EXPECT_GT(::diagnosticCount(), 0u);
+}
+
+TEST_F(DefUseTest, InitializedOnAllPaths) {
+    auto test = FrontendTestCase::create(P4_SOURCE(P4Headers::CORE, R"(
+        control c(inout bit<8> v) {
+            apply {
+                bit<8> x;
+                if (v == 1) x = 2; else x = 3;
+                v = x;
+            }
+        }
+        control proto(inout bit<8> v);
+        package top(proto p);
+        top(c()) main;
+    )"));
+    ASSERT_TRUE(test);
+    EXPECT_EQ(::diagnosticCount(), 0u);
+}
+
+}  // namespace Test
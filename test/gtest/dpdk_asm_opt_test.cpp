@@ -0,0 +1,280 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "backends/dpdk/dpdkAsmOpt.h"
+
+#include <initializer_list>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "frontends/p4/coreLibrary.h"
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+namespace {
+
+const IR::Expression *metadata(cstring field) {
+    return new IR::Member(new IR::PathExpression(IR::ID("m")), IR::ID(field));
+}
+
+const IR::Expression *header(cstring field) {
+    return new IR::Member(new IR::Member(new IR::PathExpression(IR::ID("h")), IR::ID("h")),
+                          IR::ID(field));
+}
+
+const IR::Expression *constant(int value) { return new IR::Constant(value); }
+
+IR::IndexedVector<IR::StructField> fields(
+    std::initializer_list<std::pair<const char *, int>> widths) {
+    IR::IndexedVector<IR::StructField> result;
+    for (auto [name, width] : widths)
+        result.push_back(new IR::StructField(IR::ID(name), IR::Type_Bits::get(width)));
+    return result;
+}
+
+/// Returns a program with the apply block body, the tables, and a metadata struct with the
+/// fields, by default the bit<8> fields a and b.
+const IR::DpdkAsmProgram *makeProgram(
+    const IR::IndexedVector<IR::DpdkAsmStatement> &body,
+    const IR::IndexedVector<IR::StructField> &metadataFields = fields({{"a", 8}, {"b", 8}}),
+    const IR::IndexedVector<IR::DpdkTable> &tables = {}) {
+    auto *annotations = new IR::Annotations({new IR::Annotation(IR::ID("__metadata__"), {})});
+    IR::IndexedVector<IR::DpdkStructType> structs;
+    structs.push_back(new IR::DpdkStructType(Util::SourceInfo(), IR::ID("metadata_t"),
+                                             annotations, metadataFields));
+    IR::IndexedVector<IR::DpdkAsmStatement> statements;
+    statements.push_back(new IR::DpdkListStatement(body));
+    return new IR::DpdkAsmProgram({}, structs, {}, {}, tables, {}, {}, statements, {});
+}
+
+/// Returns a table with exact match keys on the metadata fields.
+const IR::DpdkTable *exactTable(cstring name, std::initializer_list<const char *> keyFields) {
+    IR::Vector<IR::KeyElement> keys;
+    for (auto field : keyFields)
+        keys.push_back(new IR::KeyElement(
+            metadata(field), new IR::PathExpression(P4::P4CoreLibrary::instance.exactMatch.Id())));
+    IR::IndexedVector<IR::ActionListElement> actions;
+    actions.push_back(new IR::ActionListElement(new IR::PathExpression(IR::ID("NoAction"))));
+    return new IR::DpdkTable(name, new IR::Key(keys), new IR::ActionList(actions),
+                             new IR::PathExpression(IR::ID("NoAction")),
+                             new IR::TableProperties(), IR::ParameterList());
+}
+
+std::vector<cstring> fieldNames(const IR::DpdkAsmProgram *program) {
+    std::vector<cstring> names;
+    for (auto field : program->structType.at(0)->fields) names.push_back(field->name.name);
+    return names;
+}
+
+std::string applyBlock(const IR::DpdkAsmProgram *program) {
+    std::stringstream out;
+    program->statements.at(0)->toSpec(out);
+    return out.str();
+}
+
+/// Optimizes the instructions of an apply block and returns the block in .spec format.
+std::string optimize(const IR::IndexedVector<IR::DpdkAsmStatement> &body) {
+    auto *program = makeProgram(body);
+    return applyBlock(
+        program->apply(DPDK::DpdkInstructionOptimization())->to<IR::DpdkAsmProgram>());
+}
+
+/// The apply block of the metadata layout tests, m.a and m.b are never live at the same time.
+IR::IndexedVector<IR::DpdkAsmStatement> disjointTemporaries() {
+    IR::IndexedVector<IR::DpdkAsmStatement> body;
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), header("f")));
+    body.push_back(new IR::DpdkMovStatement(header("g"), metadata("a")));
+    body.push_back(new IR::DpdkMovStatement(metadata("b"), header("g")));
+    body.push_back(new IR::DpdkMovStatement(header("f"), metadata("b")));
+    return body;
+}
+
+}  // namespace
+
+class DpdkInstructionOptimizationTest : public P4CTest {};
+
+TEST_F(DpdkInstructionOptimizationTest, ConstantsMeetAtLabels) {
+    IR::IndexedVector<IR::DpdkAsmStatement> body;
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), constant(1)));
+    body.push_back(new IR::DpdkJmpEqualStatement("LABEL_1", header("f"), constant(5)));
+    body.push_back(new IR::DpdkMovStatement(metadata("b"), constant(2)));
+    body.push_back(new IR::DpdkJmpLabelStatement("LABEL_2"));
+    body.push_back(new IR::DpdkLabelStatement("LABEL_1"));
+    body.push_back(new IR::DpdkMovStatement(metadata("b"), constant(3)));
+    body.push_back(new IR::DpdkLabelStatement("LABEL_2"));
+    // m.a is 1 on both paths, m.b is not known after the paths meet
+    body.push_back(new IR::DpdkJmpNotEqualStatement("LABEL_3", metadata("a"), constant(1)));
+    body.push_back(new IR::DpdkMovStatement(header("f"), metadata("a")));
+    body.push_back(new IR::DpdkMovStatement(header("g"), metadata("b")));
+    body.push_back(new IR::DpdkLabelStatement("LABEL_3"));
+    body.push_back(new IR::DpdkApplyStatement("tbl"));
+
+    EXPECT_EQ(optimize(body),
+              "apply {\n"
+              "\tmov m.a 0x1\n"
+              "\tjmpeq LABEL_1 h.h.f 0x5\n"
+              "\tmov m.b 0x2\n"
+              "\tjmp LABEL_2\n"
+              "\tLABEL_1 :\tmov m.b 0x3\n"
+              "\tLABEL_2 :\tmov h.h.f 0x1\n"
+              "\tmov h.h.g m.b\n"
+              "\ttable tbl\n"
+              "}\n");
+}
+
+TEST_F(DpdkInstructionOptimizationTest, WritesKillCopies) {
+    IR::IndexedVector<IR::DpdkAsmStatement> body;
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), header("f")));
+    body.push_back(new IR::DpdkMovStatement(header("g"), metadata("a")));
+    // m.a still holds h.h.f
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), header("f")));
+    body.push_back(new IR::DpdkMovStatement(header("f"), header("g")));
+    // h.h.f was written, m.a no longer holds it
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), header("f")));
+
+    EXPECT_EQ(optimize(body),
+              "apply {\n"
+              "\tmov m.a h.h.f\n"
+              "\tmov h.h.g m.a\n"
+              "\tmov h.h.f h.h.g\n"
+              "\tmov m.a h.h.f\n"
+              "}\n");
+}
+
+TEST_F(DpdkInstructionOptimizationTest, WritesKillConstants) {
+    auto *a = metadata("a");
+    IR::IndexedVector<IR::DpdkAsmStatement> body;
+    body.push_back(new IR::DpdkMovStatement(a, constant(1)));
+    body.push_back(new IR::DpdkAddStatement(a, a, constant(1)));
+    body.push_back(new IR::DpdkJmpEqualStatement("LABEL_1", a, constant(1)));
+    body.push_back(new IR::DpdkMovStatement(metadata("b"), constant(2)));
+    body.push_back(new IR::DpdkLabelStatement("LABEL_1"));
+    body.push_back(new IR::DpdkMovStatement(header("f"), a));
+
+    EXPECT_EQ(optimize(body),
+              "apply {\n"
+              "\tmov m.a 0x1\n"
+              "\tadd m.a 0x1\n"
+              "\tjmpeq LABEL_1 m.a 0x1\n"
+              "\tmov m.b 0x2\n"
+              "\tLABEL_1 :\tmov h.h.f m.a\n"
+              "}\n");
+}
+
+TEST_F(DpdkInstructionOptimizationTest, FoldsBranchOnConstant) {
+    IR::IndexedVector<IR::DpdkAsmStatement> body;
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), constant(1)));
+    body.push_back(new IR::DpdkJmpEqualStatement("LABEL_1", metadata("a"), constant(1)));
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), constant(2)));
+    body.push_back(new IR::DpdkLabelStatement("LABEL_1"));
+    body.push_back(new IR::DpdkMovStatement(header("f"), metadata("a")));
+
+    EXPECT_EQ(optimize(body),
+              "apply {\n"
+              "\tmov m.a 0x1\n"
+              "\tmov h.h.f 0x1\n"
+              "}\n");
+}
+
+TEST_F(DpdkInstructionOptimizationTest, BarriersKillEverything) {
+    IR::IndexedVector<IR::DpdkAsmStatement> body;
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), constant(1)));
+    // The table may run an action which writes m.a
+    body.push_back(new IR::DpdkApplyStatement("tbl"));
+    body.push_back(new IR::DpdkJmpEqualStatement("LABEL_1", metadata("a"), constant(1)));
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), constant(1)));
+    body.push_back(new IR::DpdkLabelStatement("LABEL_1"));
+    body.push_back(new IR::DpdkMovStatement(header("f"), metadata("a")));
+
+    EXPECT_EQ(optimize(body),
+              "apply {\n"
+              "\tmov m.a 0x1\n"
+              "\ttable tbl\n"
+              "\tjmpeq LABEL_1 m.a 0x1\n"
+              "\tmov m.a 0x1\n"
+              "\tLABEL_1 :\tmov h.h.f m.a\n"
+              "}\n");
+}
+
+TEST_F(DpdkInstructionOptimizationTest, RemovesDeadMovs) {
+    IR::IndexedVector<IR::DpdkAsmStatement> body;
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), header("f")));
+    body.push_back(new IR::DpdkMovStatement(metadata("a"), header("g")));
+    body.push_back(new IR::DpdkMovStatement(metadata("b"), metadata("a")));
+
+    EXPECT_EQ(optimize(body),
+              "apply {\n"
+              "\tmov m.a h.h.g\n"
+              "\tmov m.b m.a\n"
+              "}\n");
+}
+
+class DpdkMetadataLayoutTest : public P4CTest {};
+
+TEST_F(DpdkMetadataLayoutTest, SharesTemporaries) {
+    auto *program = makeProgram(disjointTemporaries());
+    auto *result = program->apply(DPDK::OptimizeMetadataLayout())->to<IR::DpdkAsmProgram>();
+
+    std::vector<cstring> expected = {"a"};
+    EXPECT_EQ(fieldNames(result), expected);
+    EXPECT_EQ(applyBlock(result),
+              "apply {\n"
+              "\tmov m.a h.h.f\n"
+              "\tmov h.h.g m.a\n"
+              "\tmov m.a h.h.g\n"
+              "\tmov h.h.f m.a\n"
+              "}\n");
+}
+
+TEST_F(DpdkMetadataLayoutTest, MirrorKeepsTemporaries) {
+    auto body = disjointTemporaries();
+    // The mirrored copy of the packet carries the metadata, no field may be shared
+    body.push_back(new IR::DpdkMirrorStatement(header("slot"), header("session")));
+    auto *program = makeProgram(body);
+    auto *result = program->apply(DPDK::OptimizeMetadataLayout())->to<IR::DpdkAsmProgram>();
+
+    std::vector<cstring> expected = {"a", "b"};
+    EXPECT_EQ(fieldNames(result), expected);
+    EXPECT_EQ(applyBlock(result),
+              "apply {\n"
+              "\tmov m.a h.h.f\n"
+              "\tmov h.h.g m.a\n"
+              "\tmov m.b h.h.g\n"
+              "\tmov h.h.f m.b\n"
+              "\tmirror h.h.slot h.h.session\n"
+              "}\n");
+}
+
+TEST_F(DpdkMetadataLayoutTest, TableKeysKeepTheirOrder) {
+    IR::IndexedVector<IR::DpdkAsmStatement> body;
+    body.push_back(new IR::DpdkMovStatement(metadata("hot"), header("f")));
+    body.push_back(new IR::DpdkMovStatement(header("g"), metadata("hot")));
+    body.push_back(new IR::DpdkApplyStatement("t"));
+    IR::IndexedVector<IR::DpdkTable> tables;
+    tables.push_back(exactTable("t", {"key0", "key1"}));
+    auto *program = makeProgram(
+        body, fields({{"key0", 8}, {"key1", 32}, {"cold", 16}, {"hot", 16}}), tables);
+    auto *result = program->apply(DPDK::OptimizeMetadataLayout())->to<IR::DpdkAsmProgram>();
+
+    // The key fields stay contiguous and in order, between the hot and the smaller cold field
+    std::vector<cstring> expected = {"hot", "key0", "key1", "cold"};
+    EXPECT_EQ(fieldNames(result), expected);
+}
+
+}  // namespace Test
@@ -0,0 +1,184 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/flat_ordered_map.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "lib/cstring.h"
+#include "lib/ordered_map.h"
+
+namespace Test {
+
+TEST(flat_ordered_map, insertion_order) {
+    flat_ordered_map<int, int> m;
+    EXPECT_TRUE(m.empty());
+    for (int i : {5, 3, 9, 1, 7}) m[i] = i * 10;
+    EXPECT_FALSE(m.emplace(3, 0).second);
+    EXPECT_EQ(m.size(), 5u);
+    std::vector<int> keys;
+    for (auto &kv : m) keys.push_back(kv.first);
+    EXPECT_EQ(keys, std::vector<int>({5, 3, 9, 1, 7}));
+    keys.clear();
+    for (auto it = m.rbegin(); it != m.rend(); ++it) keys.push_back(it->first);
+    EXPECT_EQ(keys, std::vector<int>({7, 1, 9, 3, 5}));
+    EXPECT_EQ(m.at(9), 90);
+    EXPECT_THROW(m.at(4), std::out_of_range);
+    EXPECT_EQ(get(m, 1), 10);
+    EXPECT_EQ(get(m, 2), 0);
+}
+
+TEST(flat_ordered_map, large) {
+    flat_ordered_map<int, int> m;
+    for (int i = 0; i < 10000; ++i) EXPECT_TRUE(m.emplace(i * 7919 % 10007, i).second);
+    EXPECT_EQ(m.size(), 10000u);
+    for (int i = 0; i < 10000; ++i) EXPECT_EQ(m.at(i * 7919 % 10007), i);
+    int i = 0;
+    for (auto &kv : m) EXPECT_EQ(kv.second, i++);
+    EXPECT_EQ(m.count(10007), 0u);
+}
+
+TEST(flat_ordered_map, erase) {
+    flat_ordered_map<int, int> m;
+    for (int i = 0; i < 100; ++i) m[i] = i;
+    for (auto it = m.begin(); it != m.end();) {
+        if (it->first % 3 != 0)
+            it = m.erase(it);
+        else
+            ++it;
+    }
+    EXPECT_EQ(m.size(), 34u);
+    EXPECT_EQ(m.count(4), 0u);
+    EXPECT_EQ(m.erase(4), 0u);
+    EXPECT_EQ(m.erase(99), 1u);
+    // re-inserted keys go to the end
+    m[4] = 4;
+    std::vector<int> keys;
+    for (auto &kv : m) keys.push_back(kv.first);
+    EXPECT_EQ(keys.size(), 34u);
+    EXPECT_EQ(keys.front(), 0);
+    EXPECT_EQ(keys[32], 96);
+    EXPECT_EQ(keys.back(), 4);
+    EXPECT_EQ((--m.end())->first, 4);
+    for (int i = 0; i < 100; ++i) m.erase(i);
+    EXPECT_TRUE(m.empty());
+    EXPECT_EQ(m.begin(), m.end());
+}
+
+TEST(flat_ordered_map, stable_references) {
+    flat_ordered_map<int, int> m;
+    int &first = m[0];
+    auto it = m.find(0);
+    auto end = m.end();
+    for (int i = 1; i < 5000; ++i) m[i] = i;
+    EXPECT_EQ(&first, &m[0]);
+    EXPECT_EQ(it, m.find(0));
+    EXPECT_EQ(end, m.end());
+    m.erase(1);
+    EXPECT_EQ(&first, &m.at(0));
+    EXPECT_EQ((++it)->first, 2);
+}
+
+TEST(flat_ordered_map, copy_and_compare) {
+    flat_ordered_map<cstring, int> a = {{"x", 1}, {"y", 2}, {"z", 3}};
+    a.erase("y");
+    auto b = a;
+    EXPECT_TRUE(a == b);
+    b["y"] = 2;
+    EXPECT_TRUE(a != b);
+    flat_ordered_map<cstring, int> c;
+    c["z"] = 3;
+    c["x"] = 1;
+    EXPECT_TRUE(a != c);  // same contents, different order
+    flat_ordered_map<cstring, int> d(std::move(b));
+    EXPECT_EQ(d.size(), 3u);
+    EXPECT_TRUE(b.empty());
+    c = d;
+    EXPECT_TRUE(c == d);
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <class Map, class Keys>
+double timeTypeMap(const Keys &keys, const Keys &misses) {
+    auto start = Clock::now();
+    Map m;
+    size_t found = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        m.emplace(keys[i], keys[i]);
+        // passes look up each node a few times, and also nodes that have no type
+        found += m.count(keys[i / 2]) + m.count(keys[i / 3]) + m.count(misses[i]);
+    }
+    for (auto &kv : m) found += kv.second != nullptr;
+    EXPECT_EQ(found, 3 * keys.size());
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template <class Map>
+double timeDeclarations(const std::vector<std::vector<cstring>> &scopes) {
+    auto start = Clock::now();
+    size_t found = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (auto &scope : scopes) {
+            Map m;
+            for (auto name : scope) m.emplace(name, nullptr);
+            Map copy(m);  // IndexedVectors are copied whenever a node is cloned
+            for (auto name : scope) found += copy.count(name);
+        }
+    }
+    EXPECT_GT(found, 0u);
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+// Compares flat_ordered_map with ordered_map on key distributions like the compiler's:
+// - node pointers from the heap, as in TypeMap and ReferenceMap (tens of thousands of
+//   entries, most lookups hit);
+// - declaration names, as in IndexedVector (many small maps that are copied).
+// Run with --gtest_also_run_disabled_tests --gtest_filter='*benchmark*'.
+TEST(flat_ordered_map, DISABLED_benchmark) {
+    std::mt19937 rng(1);
+    std::vector<std::unique_ptr<char[]>> nodes;
+    std::vector<const void *> keys, misses;
+    for (int i = 0; i < 200000; ++i) {
+        nodes.emplace_back(new char[32 + rng() % 96]);
+        (i % 2 ? misses : keys).push_back(nodes.back().get());
+    }
+
+    std::vector<std::vector<cstring>> scopes(20000);
+    for (auto &scope : scopes) {
+        size_t n = 1 + rng() % 12;
+        for (size_t i = 0; i < n; ++i)
+            scope.push_back(cstring((i % 3 ? "tmp_" : "hdr_") + std::to_string(rng() % 64)));
+    }
+
+    double a = timeTypeMap<ordered_map<const void *, const void *>>(keys, misses);
+    double b = timeTypeMap<flat_ordered_map<const void *, const void *>>(keys, misses);
+    std::cout << "node pointers:     ordered_map " << a << " ms, flat_ordered_map " << b
+              << " ms" << std::endl;
+    a = timeDeclarations<ordered_map<cstring, const void *>>(scopes);
+    b = timeDeclarations<flat_ordered_map<cstring, const void *>>(scopes);
+    std::cout << "declaration names: ordered_map " << a << " ms, flat_ordered_map " << b
+              << " ms" << std::endl;
+}
+
+}  // namespace Test
@@ -0,0 +1,74 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/flat_ptr_map.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace Test {
+
+TEST(flat_ptr_map, emplace_find) {
+    std::vector<int> keys(5000);
+    flat_ptr_map<const int *, int> m;
+    EXPECT_TRUE(m.empty());
+    for (int i = 0; i < 5000; ++i) EXPECT_TRUE(m.emplace(&keys[i], i).second);
+    EXPECT_EQ(m.size(), 5000u);
+    auto rv = m.emplace(&keys[42], -1);
+    EXPECT_FALSE(rv.second);
+    EXPECT_EQ(*rv.first, 42);
+    for (int i = 0; i < 5000; ++i) EXPECT_EQ(*m.find(&keys[i]), i);
+    int other;
+    EXPECT_EQ(m.find(&other), nullptr);
+    EXPECT_EQ(m.count(&other), 0u);
+}
+
+TEST(flat_ptr_map, stable_values) {
+    std::vector<int> keys(5000);
+    flat_ptr_map<const int *, int> m;
+    int *first = m.emplace(&keys[0], 0).first;
+    for (int i = 1; i < 5000; ++i) m.emplace(&keys[i], i);
+    m.erase_if([](int v) { return v % 2 == 1; });
+    EXPECT_EQ(m.size(), 2500u);
+    EXPECT_EQ(m.find(&keys[0]), first);
+    EXPECT_EQ(m.find(&keys[1]), nullptr);
+    EXPECT_EQ(*m.find(&keys[2]), 2);
+    EXPECT_TRUE(m.emplace(&keys[1], 7).second);
+    EXPECT_EQ(*m.find(&keys[1]), 7);
+}
+
+TEST(flat_ptr_map, clear) {
+    std::vector<int> keys(100);
+    flat_ptr_map<const int *, int> m;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 100; ++i) m.emplace(&keys[i], i + round);
+        EXPECT_EQ(*m.find(&keys[99]), 99 + round);
+        m.clear();
+        EXPECT_TRUE(m.empty());
+        EXPECT_EQ(m.find(&keys[99]), nullptr);
+    }
+}
+
+TEST(flat_ptr_map, clear_drops_references) {
+    // The chunks keep their memory across clear(), but not the pointers stored in it.
+    std::vector<int> keys(10);
+    flat_ptr_map<const int *, const int *> m;
+    const int **value = m.emplace(&keys[0], &keys[1]).first;
+    m.clear();
+    EXPECT_EQ(*value, nullptr);
+    EXPECT_EQ(m.emplace(&keys[2], &keys[3]).first, value);
+}
+
+}  // namespace Test
@@ -0,0 +1,160 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#include "frontends/common/parseInput.h"
+#include "frontends/p4/frontend.h"
+#include "frontends/p4/frontendCache.h"
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/binary_loader.h"
+#include "ir/ir.h"
+#include "ir/json_generator.h"
+
+namespace Test {
+
+namespace {
+
+std::string toJSON(const IR::Node *node) {
+    std::stringstream ss;
+    JSONGenerator(ss) << node << std::endl;
+    return ss.str();
+}
+
+const std::string &source() {
+    static const std::string text = P4_SOURCE(P4Headers::CORE, R"(
+        header h_t { bit<8> f; bit<16> g; }
+        struct headers_t { h_t h; }
+        control c(inout headers_t hdr) {
+            action set(bit<8> v) { hdr.h.f = v; }
+            table t {
+                key = { hdr.h.g : exact; }
+                actions = { set; NoAction; }
+                default_action = NoAction();
+            }
+            apply { if (hdr.h.isValid()) t.apply(); }
+        }
+        control proto(inout headers_t hdr);
+        package top(proto p);
+        top(c()) main;
+    )");
+    return text;
+}
+
+const IR::P4Program *parse() {
+    return P4::parseP4String(source(), CompilerOptions::FrontendVersion::P4_16);
+}
+
+}  // namespace
+
+class FrontEndCacheTest : public P4CTest {
+ protected:
+    std::filesystem::path dir;
+    CompilerOptions options;
+
+    void SetUp() override {
+        dir = std::filesystem::temp_directory_path() /
+              ("p4c-frontend-cache-" + std::to_string(getpid()));
+        options.langVersion = CompilerOptions::FrontendVersion::P4_16;
+        options.frontendCacheDir = dir.string();
+        options.sourceHash = P4::FrontEndCache::hashSource(source());
+    }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+};
+
+TEST_F(FrontEndCacheTest, HitReturnsFrontEndOutput) {
+    auto *first = P4::FrontEnd().run(options, parse());
+    ASSERT_NE(first, nullptr);
+    ASSERT_EQ(::diagnosticCount(), 0u);
+
+    P4::FrontEndCache cache(options, P4::ParseAnnotations().fingerprint());
+    ASSERT_TRUE(cache.enabled());
+    auto *program = parse();
+    auto *cached = cache.lookup(program);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_NE(cached, first);
+    EXPECT_EQ(toJSON(cached), toJSON(first));
+
+    // Source positions refer to the input parsed again
+    auto *decl = cached->getDeclsByName("c")->single();
+    ASSERT_NE(decl, nullptr);
+    EXPECT_EQ(decl->getNode()->srcInfo.getSources(),
+              program->objects.at(0)->srcInfo.getSources());
+
+    auto *second = P4::FrontEnd().run(options, parse());
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(toJSON(second), toJSON(first));
+}
+
+TEST_F(FrontEndCacheTest, KeyDependsOnOptions) {
+    ASSERT_NE(P4::FrontEnd().run(options, parse()), nullptr);
+
+    options.optimizeParserInlining = true;
+    EXPECT_EQ(P4::FrontEndCache(options, P4::ParseAnnotations().fingerprint()).lookup(parse()),
+              nullptr);
+    options.optimizeParserInlining = false;
+    EXPECT_EQ(P4::FrontEndCache(options, P4::ParseAnnotations(true).fingerprint()).lookup(parse()),
+              nullptr);
+    options.sourceHash = P4::FrontEndCache::hashSource(source() + "\n");
+    EXPECT_EQ(P4::FrontEndCache(options, P4::ParseAnnotations().fingerprint()).lookup(parse()),
+              nullptr);
+}
+
+TEST_F(FrontEndCacheTest, KeyIgnoresAnnotationPassName) {
+    EXPECT_EQ(P4::ParseAnnotations("target", true, {}).fingerprint(),
+              P4::ParseAnnotations().fingerprint());
+    EXPECT_NE(P4::ParseAnnotations("target", false, {}).fingerprint(),
+              P4::ParseAnnotations().fingerprint());
+}
+
+TEST_F(FrontEndCacheTest, CorruptEntryIsMiss) {
+    auto *first = P4::FrontEnd().run(options, parse());
+    ASSERT_NE(first, nullptr);
+    for (auto &entry : std::filesystem::directory_iterator(dir)) {
+        // keep the header and the tables, so that only decoding the nodes fails
+        std::fstream file(entry.path(), std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(sizeof(BinarySnapshot::Header));
+        file << std::string(64, '\xff');
+    }
+
+    P4::FrontEndCache cache(options, P4::ParseAnnotations().fingerprint());
+    auto errors = ::errorCount();
+    EXPECT_EQ(cache.lookup(parse()), nullptr);
+    EXPECT_EQ(::errorCount(), errors);
+
+    // the frontend runs again and replaces the entry
+    auto *second = P4::FrontEnd().run(options, parse());
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(toJSON(second), toJSON(first));
+    EXPECT_NE(cache.lookup(parse()), nullptr);
+}
+
+TEST_F(FrontEndCacheTest, Disabled) {
+    EXPECT_TRUE(P4::FrontEndCache(options, "").enabled());
+    options.sourceHash = nullptr;
+    EXPECT_FALSE(P4::FrontEndCache(options, "").enabled());
+    options.sourceHash = P4::FrontEndCache::hashSource(source());
+    options.langVersion = CompilerOptions::FrontendVersion::P4_14;
+    EXPECT_FALSE(P4::FrontEndCache(options, "").enabled());
+    options.langVersion = CompilerOptions::FrontendVersion::P4_16;
+    options.frontendCacheDir = nullptr;
+    EXPECT_FALSE(P4::FrontEndCache(options, "").enabled());
+}
+
+}  // namespace Test
@@ -0,0 +1,125 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "frontends/common/parseInput.h"
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeChecking/typeChecker.h"
+#include "frontends/p4/typeMap.h"
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+using namespace P4;
+
+namespace Test {
+
+namespace {
+
+// Changes the constant 2 into 3, i.e., only the body of action a2 below.
+class ChangeConstant : public Transform {
+    const IR::Node *postorder(IR::Constant *c) override {
+        if (c->value == 2) return new IR::Constant(c->srcInfo, c->type, 3);
+        return c;
+    }
+};
+
+// Changes the type of the parameter of action a2 below.
+class ChangeParameter : public Transform {
+    const IR::Node *postorder(IR::Parameter *p) override {
+        if (p->name == "y") p->type = IR::Type_Bits::get(16);
+        return p;
+    }
+};
+
+const IR::Expression *rhs(const IR::P4Program *program, cstring action) {
+    for (auto *obj : program->objects) {
+        auto *a = obj->to<IR::P4Action>();
+        if (a && a->name == action)
+            return a->body->components.at(0)->to<IR::AssignmentStatement>()->right;
+    }
+    return nullptr;
+}
+
+}  // namespace
+
+class IncrementalTypeMap : public P4CTest {
+ protected:
+    const IR::P4Program *program = nullptr;
+    ReferenceMap refMap;
+    TypeMap typeMap;
+
+    void SetUp() override {
+        std::string source = P4_SOURCE(R"(
+            action a1(inout bit<8> x) { x = x + 1; }
+            action a2(inout bit<8> y) { y = y + 2; }
+            control c(inout bit<8> v) { apply { a1(v); a2(v); } }
+        )");
+        program = P4::parseP4String(source, CompilerOptions::FrontendVersion::P4_16);
+        ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+        typeMap.setIncremental(true);
+        program = program->apply(TypeChecking(&refMap, &typeMap));
+        ASSERT_TRUE(program != nullptr && ::errorCount() == 0);
+    }
+};
+
+TEST_F(IncrementalTypeMap, KeepsUnchangedObjects) {
+    auto *unchanged = rhs(program, "a1");
+    auto *a1Type = typeMap.getType(unchanged);
+    ASSERT_NE(a1Type, nullptr);
+
+    auto *changed = program->apply(ChangeConstant());
+    ASSERT_NE(changed, program);
+    changed = changed->apply(ClearTypeMap(&typeMap));
+    EXPECT_TRUE(typeMap.contains(unchanged));
+    EXPECT_FALSE(typeMap.contains(rhs(changed, "a2")));
+
+    changed = changed->apply(TypeChecking(&refMap, &typeMap));
+    ASSERT_TRUE(changed != nullptr && ::errorCount() == 0);
+    EXPECT_EQ(typeMap.getType(unchanged), a1Type);
+    EXPECT_NE(typeMap.getType(rhs(changed, "a2")), nullptr);
+}
+
+TEST_F(IncrementalTypeMap, DropsTypeVariablesOfChangedObjects) {
+    const IR::P4Action *oldA2 = nullptr;
+    for (auto *obj : program->objects)
+        if (auto *a = obj->to<IR::P4Action>(); a && a->name == "a2") oldA2 = a;
+    ASSERT_NE(oldA2, nullptr);
+
+    auto *changed = program->apply(ChangeConstant());
+    changed->apply(ClearTypeMap(&typeMap));
+    forAllMatching<IR::Type_InfInt>(oldA2, [&](const IR::Type_InfInt *var) {
+        EXPECT_FALSE(typeMap.getSubstitutions()->containsKey(var));
+    });
+}
+
+TEST(TypeVariableSubstitution, Retain) {
+    auto *t1 = new IR::Type_Var(IR::ID("T1"));
+    auto *t2 = new IR::Type_Var(IR::ID("T2"));
+    TypeVariableSubstitution tvs;
+    tvs.setBinding(t1, IR::Type_Bits::get(8));
+    tvs.setBinding(t2, IR::Type_Bits::get(16));
+    tvs.retain([t1](const IR::ITypeVar *var) { return var == t1; });
+    EXPECT_TRUE(tvs.containsKey(t1));
+    EXPECT_FALSE(tvs.containsKey(t2));
+}
+
+TEST_F(IncrementalTypeMap, ClearsWhenSignatureChanges) {
+    auto *unchanged = rhs(program, "a1");
+    auto *changed = program->apply(ChangeParameter());
+    ASSERT_NE(changed, program);
+    changed->apply(ClearTypeMap(&typeMap));
+    EXPECT_FALSE(typeMap.contains(unchanged));
+}
+
+}  // namespace Test
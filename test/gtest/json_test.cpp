@@ -71,4 +71,41 @@ TEST(Util, Json) {
               obj->toString());
 }
 
+TEST(Util, JsonWriter) {
+    // The writer lays out documents like serialize.
+    auto obj = new JsonObject();
+    obj->emplace("x", "x");
+    obj->emplace("empty", new JsonArray());
+    obj->emplace("small", (new JsonArray())->append(5)->append("5"));
+    auto arr = new JsonArray();
+    arr->append(new JsonObject());
+    arr->append((new JsonArray())->append(true));
+    obj->emplace("large", arr);
+
+    std::stringstream out;
+    JsonWriter writer(out);
+    writer.beginObject();
+    writer.key("x").value("x");
+    writer.key("empty").beginArray().endArray();
+    writer.key("small").beginArray(true).value(5).value("5").endArray();
+    writer.key("large").beginArray();
+    writer.beginObject().endObject();
+    writer.json((new JsonArray())->append(true));
+    writer.endArray();
+    writer.endObject();
+    EXPECT_EQ(obj->toString(), out.str());
+
+    // A streamed value is written in place, at the indentation of the enclosing tree.
+    auto streamed = new JsonObject();
+    streamed->emplace("x", "x");
+    streamed->emplace("empty", new JsonStream([](JsonWriter &w) { w.beginArray().endArray(); }));
+    streamed->emplace("small", new JsonStream([](JsonWriter &w) {
+                          w.beginArray(true).value(5).value("5").endArray();
+                      }));
+    streamed->emplace("large", new JsonStream([arr](JsonWriter &w) { w.json(arr); }));
+    EXPECT_EQ(obj->toString(), streamed->toString());
+
+    EXPECT_THROW(writer.endArray(), std::logic_error);
+}
+
 }  // namespace Util
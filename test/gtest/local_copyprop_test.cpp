@@ -0,0 +1,156 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "midend/local_copyprop.h"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+#include "frontends/common/resolveReferences/referenceMap.h"
+#include "frontends/p4/typeMap.h"
+#include "gtest/gtest.h"
+#include "helpers.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string program(const std::string &headerFields, const std::string &body) {
+    std::string source = R"(
+        header h_t { )" + headerFields + R"( }
+        struct headers_t { h_t h; }
+        control c(inout headers_t hdr) {
+            apply {
+                )" + body + R"(
+            }
+        }
+        control proto(inout headers_t hdr);
+        package top(proto p);
+        top(c()) main;
+    )";
+    return P4_SOURCE(P4Headers::CORE, source.c_str());
+}
+
+const IR::P4Program *copyprop(const std::string &source) {
+    auto test = FrontendTestCase::create(source);
+    if (!test) return nullptr;
+    P4::ReferenceMap refMap;
+    P4::TypeMap typeMap;
+    return test->program->apply(P4::LocalCopyPropagation(&refMap, &typeMap));
+}
+
+/// The right-hand sides of the assignments to the fields of hdr.h, by field name.
+std::map<cstring, const IR::Expression *> fieldAssignments(const IR::P4Program *program) {
+    std::map<cstring, const IR::Expression *> result;
+    forAllMatching<IR::AssignmentStatement>(program, [&](const IR::AssignmentStatement *as) {
+        if (auto *m = as->left->to<IR::Member>()) result[m->member] = as->right;
+    });
+    return result;
+}
+
+}  // namespace
+
+class LocalCopyPropTest : public P4CTest {};
+
+TEST_F(LocalCopyPropTest, AssignmentDropsValuesUsingIt) {
+    auto *result = copyprop(program("bit<16> f; bit<16> g; bit<16> g2;", R"(
+        bit<16> a = hdr.h.g;
+        bit<16> b = a;
+        hdr.h.f = b;
+        hdr.h.g = 1;
+        hdr.h.g2 = b;
+    )"));
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(::errorCount(), 0u);
+    auto assignments = fieldAssignments(result);
+    // b is available as hdr.h.g until hdr.h.g is written
+    ASSERT_TRUE(assignments.count("f"));
+    auto *f = assignments.at("f")->to<IR::Member>();
+    ASSERT_NE(f, nullptr);
+    EXPECT_EQ(f->member, "g");
+    ASSERT_TRUE(assignments.count("g2"));
+    EXPECT_TRUE(assignments.at("g2")->is<IR::PathExpression>());
+}
+
+TEST_F(LocalCopyPropTest, AssignmentToHeaderDropsFieldValues) {
+    auto *result = copyprop(program("bit<16> f; bit<16> g;", R"(
+        bit<16> a = hdr.h.g;
+        hdr.h.f = a;
+        hdr.h.setInvalid();
+        hdr.h.g = a;
+    )"));
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(::errorCount(), 0u);
+    auto assignments = fieldAssignments(result);
+    ASSERT_TRUE(assignments.count("f"));
+    EXPECT_TRUE(assignments.at("f")->is<IR::Member>());
+    ASSERT_TRUE(assignments.count("g"));
+    EXPECT_TRUE(assignments.at("g")->is<IR::PathExpression>());
+}
+
+TEST_F(LocalCopyPropTest, StackWriteDropsElementValuesPastSiblings) {
+    // hdr.vlan2.f sorts between hdr.vlan and hdr.vlan[0].f
+    auto *result = copyprop(P4_SOURCE(P4Headers::CORE, R"(
+        header h_t { bit<16> f; }
+        struct headers_t { h_t[2] vlan; h_t vlan2; }
+        control c(inout headers_t hdr) {
+            apply {
+                hdr.vlan[0].f = 1;
+                hdr.vlan2.f = 2;
+                hdr.vlan.pop_front(1);
+                hdr.vlan[1].f = hdr.vlan[0].f;
+            }
+        }
+        control proto(inout headers_t hdr);
+        package top(proto p);
+        top(c()) main;
+    )"));
+    ASSERT_NE(result, nullptr);
+    ASSERT_EQ(::errorCount(), 0u);
+    const IR::Expression *last = nullptr;
+    forAllMatching<IR::AssignmentStatement>(result, [&](const IR::AssignmentStatement *as) {
+        last = as->right;
+    });
+    ASSERT_NE(last, nullptr);
+    EXPECT_FALSE(last->is<IR::Constant>());
+}
+
+// Straight-line blocks in which n locals keep their values while a header field is written
+// n times.  Each of those writes used to check every available value, which made the pass
+// quadratic in the size of the block.
+// Run with --gtest_also_run_disabled_tests --gtest_filter='*benchmark*'.
+TEST_F(LocalCopyPropTest, DISABLED_benchmark) {
+    for (int n : {1000, 5000, 10000, 50000}) {
+        std::stringstream body;
+        for (int i = 0; i < n; ++i)
+            body << "bit<16> x" << i << " = " << i << ";\n"
+                 << "hdr.h.g = hdr.h.g + x" << i << ";\n";
+        auto test = FrontendTestCase::create(program("bit<16> g;", body.str()));
+        ASSERT_TRUE(test);
+        P4::ReferenceMap refMap;
+        P4::TypeMap typeMap;
+        auto start = Clock::now();
+        auto *result = test->program->apply(P4::LocalCopyPropagation(&refMap, &typeMap));
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+        ASSERT_NE(result, nullptr);
+        std::cout << n << " assignments: " << elapsed.count() << " ms" << std::endl;
+    }
+}
+
+}  // namespace Test
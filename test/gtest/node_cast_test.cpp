@@ -0,0 +1,100 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+
+namespace Test {
+
+TEST(NodeCast, TypeIdRanges) {
+    // Every generated class range must be contained in the range of its parent.
+    EXPECT_LE(IR::Expression::static_type_id, IR::Operation_Binary::static_type_id);
+    EXPECT_GE(IR::Expression::static_type_id_last, IR::Operation_Binary::static_type_id_last);
+    EXPECT_LE(IR::Operation_Binary::static_type_id, IR::Add::static_type_id);
+    EXPECT_GE(IR::Operation_Binary::static_type_id_last, IR::Add::static_type_id_last);
+    EXPECT_EQ(IR::Add::static_type_id, IR::Add::static_type_id_last);
+    EXPECT_TRUE(IR::has_static_type_id<IR::Add>::value);
+    EXPECT_FALSE(IR::has_static_type_id<IR::Vector<IR::Node>>::value);
+    EXPECT_FALSE(IR::has_static_type_id<IR::IDeclaration>::value);
+}
+
+TEST(NodeCast, IsAndTo) {
+    auto *c = new IR::Constant(IR::Type_Bits::get(8), 1);
+    const IR::Node *add = new IR::Add(c, c);
+    EXPECT_TRUE(add->is<IR::Add>());
+    EXPECT_TRUE(add->is<IR::Operation_Binary>());
+    EXPECT_TRUE(add->is<IR::Expression>());
+    EXPECT_TRUE(add->is<IR::Node>());
+    EXPECT_FALSE(add->is<IR::Sub>());
+    EXPECT_FALSE(add->is<IR::Operation_Unary>());
+    EXPECT_FALSE(add->is<IR::Type>());
+    EXPECT_EQ(add->to<IR::Operation_Binary>()->left, c);
+    EXPECT_EQ(add->to<IR::Sub>(), nullptr);
+    EXPECT_EQ(&add->as<IR::Add>(), add);
+    EXPECT_THROW(add->as<IR::Constant>(), std::bad_cast);
+
+    // Casts through INode and to interfaces fall back to dynamic_cast.
+    const IR::INode *inode = add;
+    EXPECT_TRUE(inode->is<IR::Add>());
+    EXPECT_FALSE(inode->is<IR::Constant>());
+    const IR::Node *decl = new IR::Declaration_Variable("x", IR::Type_Bits::get(8));
+    EXPECT_TRUE(decl->is<IR::IDeclaration>());
+    EXPECT_NE(decl->to<IR::IDeclaration>(), nullptr);
+    EXPECT_FALSE(add->is<IR::IDeclaration>());
+
+    const IR::Node *vec = new IR::Vector<IR::Expression>({c});
+    EXPECT_TRUE((vec->is<IR::Vector<IR::Expression>>()));
+    EXPECT_FALSE((vec->is<IR::Vector<IR::Type>>()));
+    EXPECT_FALSE(vec->is<IR::Expression>());
+}
+
+// Not a pass/fail test: reports the cost of the type id checks against dynamic_cast.
+TEST(NodeCast, Microbenchmark) {
+    std::vector<const IR::Node *> nodes;
+    auto *c = new IR::Constant(IR::Type_Bits::get(8), 1);
+    for (int i = 0; i < 1000; ++i) {
+        nodes.push_back(new IR::Add(c, c));
+        nodes.push_back(new IR::LNot(c));
+        nodes.push_back(c);
+        nodes.push_back(new IR::PathExpression("a"));
+    }
+    constexpr int rounds = 1000;
+    using clock = std::chrono::steady_clock;
+
+    size_t hits = 0;
+    auto start = clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (auto *n : nodes) hits += n->is<IR::Operation_Binary>() + n->is<IR::Constant>();
+    auto typeId = clock::now() - start;
+
+    size_t dynHits = 0;
+    start = clock::now();
+    for (int r = 0; r < rounds; ++r)
+        for (auto *n : nodes)
+            dynHits += (dynamic_cast<const IR::Operation_Binary *>(n) != nullptr) +
+                       (dynamic_cast<const IR::Constant *>(n) != nullptr);
+    auto dynCast = clock::now() - start;
+
+    EXPECT_EQ(hits, dynHits);
+    using std::chrono::microseconds;
+    std::cout << "Node::is<T>: " << std::chrono::duration_cast<microseconds>(typeId).count()
+              << "us, dynamic_cast: " << std::chrono::duration_cast<microseconds>(dynCast).count()
+              << "us" << std::endl;
+}
+
+}  // namespace Test
@@ -0,0 +1,69 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "ir/pass_profile.h"
+
+#include <cstring>
+#include <sstream>
+
+#include "gtest/gtest.h"
+#include "ir/ir.h"
+#include "ir/pass_manager.h"
+
+namespace Test {
+
+namespace {
+
+class CountConstants : public Inspector {
+ public:
+    void postorder(const IR::Constant *) override {}
+};
+
+class RenumberConstants : public Transform {
+ public:
+    const IR::Node *postorder(IR::Constant *c) override {
+        return new IR::Constant(c->type, c->value + 1);
+    }
+};
+
+}  // namespace
+
+TEST(PassProfile, RecordsNestedPasses) {
+    auto *c = new IR::Constant(IR::Type_Bits::get(8), 1);
+    const IR::Node *expr = new IR::Add(c, c);
+
+    PassProfile::enable("/dev/null");
+    PassManager inner({new CountConstants});
+    PassManager outer({new RenumberConstants, &inner});
+    expr = expr->apply(outer);
+    auto events = PassProfile::get()->getEvents();
+    std::stringstream trace;
+    PassProfile::get()->writeTrace(trace);
+    PassProfile::disable();
+
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_NE(strstr(events[0].pass, "RenumberConstants"), nullptr);
+    EXPECT_EQ(events[0].depth, 0u);
+    EXPECT_GE(events[0].end.nodesVisited - events[0].start.nodesVisited, 3u);
+    EXPECT_GE(events[0].end.nodesCreated - events[0].start.nodesCreated, 2u);
+    EXPECT_EQ(events[1].pass, "PassManager");
+    EXPECT_NE(strstr(events[2].pass, "CountConstants"), nullptr);
+    EXPECT_EQ(events[2].depth, 1u);
+    EXPECT_LE(events[1].start.wallNs, events[2].start.wallNs);
+    EXPECT_GE(events[1].end.wallNs, events[2].end.wallNs);
+    EXPECT_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+    EXPECT_NE(trace.str().find("\"nodes_visited\""), std::string::npos);
+}
+
+}  // namespace Test
@@ -0,0 +1,129 @@
+/*
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+#include "lib/persistent_map.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "lib/persistent_list.h"
+
+namespace Test {
+
+TEST(persistent_map, ordered) {
+    persistent_map<int, int> m;
+    EXPECT_TRUE(m.empty());
+    for (int i : {5, 3, 9, 1, 7}) m.insert_or_assign(i, i * 10);
+    EXPECT_FALSE(m.insert(3, 0).second);
+    EXPECT_EQ(m.size(), 5u);
+    std::vector<int> keys;
+    for (auto &kv : m) keys.push_back(kv.first);
+    EXPECT_EQ(keys, std::vector<int>({1, 3, 5, 7, 9}));
+    EXPECT_EQ(m.at(9), 90);
+    EXPECT_THROW(m.at(4), std::out_of_range);
+    EXPECT_EQ(m.find(4), m.end());
+    keys.clear();
+    for (auto it = m.find(5); it != m.end(); ++it) keys.push_back(it->first);
+    EXPECT_EQ(keys, std::vector<int>({5, 7, 9}));
+}
+
+TEST(persistent_map, matches_std_map) {
+    persistent_map<int, int> m;
+    std::map<int, int> ref;
+    std::mt19937 rng(1);
+    for (int i = 0; i < 20000; ++i) {
+        int k = rng() % 500;
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(m.erase(k), ref.erase(k));
+        } else {
+            m.insert_or_assign(k, i);
+            ref[k] = i;
+        }
+    }
+    EXPECT_EQ(m.size(), ref.size());
+    EXPECT_TRUE(std::equal(m.begin(), m.end(), ref.begin(), ref.end()));
+}
+
+TEST(persistent_map, copies_are_independent) {
+    persistent_map<int, int> m;
+    for (int i = 0; i < 100; ++i) m.insert_or_assign(i, i);
+    auto copy = m;
+    EXPECT_TRUE(copy.shares_root_with(m));
+    m.insert_or_assign(100, 100);
+    m.insert_or_assign(50, -1);
+    m.erase(0);
+    copy.insert_or_assign(200, 200);
+    EXPECT_FALSE(copy.shares_root_with(m));
+    EXPECT_EQ(copy.size(), 101u);
+    EXPECT_EQ(copy.at(50), 50);
+    EXPECT_EQ(copy.count(0), 1u);
+    EXPECT_EQ(copy.count(100), 0u);
+    EXPECT_EQ(m.size(), 100u);
+    EXPECT_EQ(m.at(50), -1);
+    EXPECT_EQ(m.count(200), 0u);
+    copy.erase(200);
+    copy.erase(0);
+    copy.insert_or_assign(100, 100);
+    copy.insert_or_assign(50, -1);
+    EXPECT_EQ(copy, m);
+}
+
+TEST(persistent_set, copies_are_independent) {
+    persistent_set<int> s;
+    for (int i : {4, 2, 8, 6}) EXPECT_TRUE(s.insert(i).second);
+    EXPECT_FALSE(s.insert(2).second);
+    auto copy = s;
+    s.erase(2);
+    s.insert(5);
+    EXPECT_EQ(std::vector<int>(s.begin(), s.end()), std::vector<int>({4, 5, 6, 8}));
+    EXPECT_EQ(std::vector<int>(copy.begin(), copy.end()), std::vector<int>({2, 4, 6, 8}));
+}
+
+TEST(persistent_list, copies_share_prefix) {
+    persistent_list<int> l;
+    EXPECT_TRUE(l.empty());
+    for (int i = 0; i < 3; ++i) l.push_back(i);
+    auto copy = l;
+    l.push_back(3);
+    copy.push_back(4);
+    copy.push_back(5);
+    EXPECT_EQ(l.size(), 4u);
+    EXPECT_EQ(l.back(), 3);
+    EXPECT_EQ(l.to_vector(), std::vector<int>({0, 1, 2, 3}));
+    EXPECT_EQ(copy.to_vector(), std::vector<int>({0, 1, 2, 4, 5}));
+    EXPECT_NE(l, copy);
+    EXPECT_EQ(std::vector<int>(copy.rbegin(), copy.rend()), std::vector<int>({5, 4, 2, 1, 0}));
+}
+
+TEST(persistent_list, long_lists_are_released_iteratively) {
+    // would overflow the stack if the nodes were freed recursively
+    persistent_list<int> l;
+    for (int i = 0; i < 1000000; ++i) l.push_back(i);
+    auto copy = l;
+    copy.push_back(-1);
+    l = persistent_list<int>();
+    EXPECT_EQ(copy.size(), 1000001u);
+    EXPECT_EQ(*++copy.rbegin(), 999999);
+    const auto &self = copy;
+    copy = self;
+    EXPECT_EQ(copy.size(), 1000001u);
+    copy.clear();
+    EXPECT_TRUE(copy.empty());
+}
+
+}  // namespace Test
@@ -16,6 +16,9 @@ limitations under the License.
 
 #include "irclass.h"
 
+#include <functional>
+#include <map>
+
 #include "lib/enumerator.h"
 #include "lib/exceptions.h"
 
@@ -103,6 +106,23 @@ Util::Enumerator<IrClass *> *IrDefinitions::getClasses() const {
         ->where([](IrClass *e) { return e != nullptr; });
 }
 
+// Number all Node subclasses in preorder, so that the ids of all subclasses of a class C
+// form the contiguous range [C.typeId, C.typeIdLast].  This is what allows Node::is<T>
+// to be a range check instead of a dynamic_cast.
+void IrDefinitions::assignTypeIds() {
+    std::map<const IrClass *, std::vector<IrClass *>> children;
+    for (auto cls : *getClasses())
+        if (cls->kind == NodeKind::Abstract || cls->kind == NodeKind::Concrete)
+            children[cls->getParent()].push_back(cls);
+    unsigned next = 0;
+    std::function<void(IrClass *)> number = [&](IrClass *cls) {
+        cls->typeId = next++;
+        for (auto child : children[cls]) number(child);
+        cls->typeIdLast = next - 1;
+    };
+    number(IrClass::nodeClass());
+}
+
 void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &impl) const {
     std::string macroname = "_IR_GENERATED_H_";
     out << "#ifndef " << macroname << "\n"
@@ -110,6 +130,8 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
         << std::endl;
 
     impl << "#include \"ir/ir-generated.h\"    // IWYU pragma: keep\n\n"
+         << "#include \"ir/binary_generator.h\" // IWYU pragma: keep\n"
+         << "#include \"ir/binary_loader.h\"   // IWYU pragma: keep\n"
          << "#include \"ir/ir-inline.h\"       // IWYU pragma: keep\n"
          << "#include \"ir/json_generator.h\"  // IWYU pragma: keep\n"
          << "#include \"ir/json_loader.h\"     // IWYU pragma: keep\n"
@@ -131,26 +153,33 @@ void IrDefinitions::generate(std::ostream &t, std::ostream &out, std::ostream &i
         << std::endl
         << "class JSONLoader;\n"
         << "using NodeFactoryFn = IR::Node*(*)(JSONLoader&);\n"
+        << "class BinaryLoader;\n"
+        << "using BinaryFactoryFn = IR::Node*(*)(BinaryLoader&);\n"
         << std::endl
         << "namespace IR {\n"
         << "extern std::map<cstring, NodeFactoryFn> unpacker_table;\n"
+        << "extern std::map<cstring, BinaryFactoryFn> binary_unpacker_table;\n"
         << "}\n";
 
-    impl << "std::map<cstring, NodeFactoryFn> IR::unpacker_table = {\n";
-
-    bool first = true;
-    for (auto cls : *getClasses()) {
-        if (cls->kind == NodeKind::Concrete) {
-            if (first)
-                first = false;
-            else
-                impl << ",\n";
-            impl << "{\"" << cls->name << "\", NodeFactoryFn(&IR::";
-            if (cls->containedIn && cls->containedIn->name) impl << cls->containedIn->name << "::";
-            impl << cls->name << "::fromJSON)}";
+    auto unpackerTable = [&](const char *table, const char *fnType, const char *factory) {
+        impl << "std::map<cstring, " << fnType << "> IR::" << table << " = {\n";
+        bool first = true;
+        for (auto cls : *getClasses()) {
+            if (cls->kind == NodeKind::Concrete) {
+                if (first)
+                    first = false;
+                else
+                    impl << ",\n";
+                impl << "{\"" << cls->name << "\", " << fnType << "(&IR::";
+                if (cls->containedIn && cls->containedIn->name)
+                    impl << cls->containedIn->name << "::";
+                impl << cls->name << "::" << factory << ")}";
+            }
         }
-    }
-    impl << " };\n" << std::endl;
+        impl << " };\n" << std::endl;
+    };
+    unpackerTable("unpacker_table", "NodeFactoryFn", "fromJSON");
+    unpackerTable("binary_unpacker_table", "BinaryFactoryFn", "fromBinary");
 
     for (auto e : elements) {
         e->generate_hdr(out);
@@ -363,9 +392,12 @@ void IrClass::generate_hdr(std::ostream &out) const {
         e->generate_hdr(out);
     }
 
-    if (kind != NodeKind::Interface && kind != NodeKind::Nested)
+    if (kind != NodeKind::Interface && kind != NodeKind::Nested) {
         out << indent << "IRNODE" << (kind == NodeKind::Abstract ? "_ABSTRACT" : "") << "_SUBCLASS("
             << name << ")" << std::endl;
+        out << indent << "IRNODE_DECLARE_TYPE_ID(" << name << ", " << typeId << ", " << typeIdLast
+            << ")" << std::endl;
+    }
 
     out << "};" << std::endl;
     if (kind != NodeKind::Nested) {
@@ -263,6 +263,8 @@ class IrClass : public IrElement {
     mutable bool needIndexedVector = false;  // using an IndexedVecor of this class
     mutable bool needNameMap = false;        // using a NameMap of this class
     mutable bool needNodeMap = false;        // using a NodeMap of this class
+    unsigned typeId = 0;                     // preorder number in the Node class tree
+    unsigned typeIdLast = 0;                 // largest typeId of any subclass
     access_t current_access = Public;        // used while parsing the class body
 
     static const char *indent;
@@ -342,6 +344,7 @@ class IrEnumType : public IrElement {
 class IrDefinitions {
     std::vector<IrElement *> elements;
     Util::Enumerator<IrClass *> *getClasses() const;
+    void assignTypeIds();
 
  public:
     explicit IrDefinitions(std::vector<IrElement *> classes) : elements(classes) {}
@@ -353,6 +356,7 @@ class IrDefinitions {
         IrClass::ideclaration()->resolve();
         IrClass::indexedVectorClass()->resolve();
         for (auto cls : *getClasses()) cls->resolve();
+        assignTypeIds();
     }
     void generate(std::ostream &t, std::ostream &out, std::ostream &impl) const;
 };
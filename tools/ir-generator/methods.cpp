@@ -275,6 +275,51 @@ const ordered_map<cstring, IrMethod::info_t> IrMethod::Generate = {
           buf << "{ return new " << cl->name << "(json); }";
           return buf.str();
       }}},
+    {"toBinary",
+     {&NamedType::Void(),
+      {new IrField(new ReferenceType(&NamedType::BinaryGenerator()), "bin")},
+      CONST + IN_IMPL + OVERRIDE + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          buf << "{" << std::endl;
+          if (auto parent = cl->getParent())
+              buf << cl->indent << parent->qualified_name(cl->containedIn) << "::toBinary(bin);"
+                  << std::endl;
+          for (auto f : *cl->getFields()) {
+              if (*f->type == NamedType::SourceInfo()) continue;  // FIXME -- deal with SourcInfo
+              buf << cl->indent << "bin << this->" << f->name << ";" << std::endl;
+          }
+          buf << "}";
+          return buf.str();
+      }}},
+    // constructor, keyed by its argument type as the one for JSONLoader has the null key
+    {"BinaryLoader",
+     {nullptr,
+      {new IrField(new ReferenceType(&NamedType::BinaryLoader()), "bin")},
+      IN_IMPL + CONSTRUCTOR + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          if (auto parent = cl->getParent())
+              buf << ": " << parent->qualified_name(cl->containedIn) << "(bin)";
+          buf << " {" << std::endl;
+          for (auto f : *cl->getFields()) {
+              if (*f->type == NamedType::SourceInfo()) continue;  // FIXME -- deal with SourcInfo
+              buf << cl->indent << "bin >> this->" << f->name << ";" << std::endl;
+          }
+          buf << "}";
+          return buf.str();
+      }}},
+    {"fromBinary",
+     {nullptr,
+      {
+          new IrField(new ReferenceType(&NamedType::BinaryLoader()), "bin"),
+      },
+      FACTORY + IN_IMPL + CONCRETE_ONLY + INCL_NESTED,
+      [](IrClass *cl, Util::SourceInfo, cstring) -> cstring {
+          std::stringstream buf;
+          buf << "{ return new " << cl->name << "(bin); }";
+          return buf.str();
+      }}},
     {"toString",
      {&NamedType::Cstring(),
       {},
@@ -347,7 +392,7 @@ void IrClass::generateMethods() {
         if (!IrMethod::Generate.count(m->name))
             throw Util::CompilationError("Unrecognized predefined method %1%", m->name);
         auto &info = IrMethod::Generate.at(m->name);
-        if (m->name) {
+        if (m->name && !(info.flags & CONSTRUCTOR)) {
             if (info.rtype) {
                 // This predefined method has an explicit return type.
                 m->rtype = info.rtype;
@@ -105,6 +105,16 @@ NamedType &NamedType::Unordered_Set() {
     return nt;
 }
 
+NamedType &NamedType::BinaryGenerator() {
+    static NamedType nt("BinaryGenerator");
+    return nt;
+}
+
+NamedType &NamedType::BinaryLoader() {
+    static NamedType nt("BinaryLoader");
+    return nt;
+}
+
 NamedType &NamedType::JSONGenerator() {
     static NamedType nt("JSONGenerator");
     return nt;
@@ -102,6 +102,8 @@ class NamedType : public Type {
     static NamedType &Ostream();
     static NamedType &Visitor();
     static NamedType &Unordered_Set();
+    static NamedType &BinaryGenerator();
+    static NamedType &BinaryLoader();
     static NamedType &JSONGenerator();
     static NamedType &JSONLoader();
     static NamedType &JSONObject();